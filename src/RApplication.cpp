@@ -3,13 +3,13 @@
 
 namespace rocket
 {
-	API Ref<REngine> RApplication::getEngine() {
+	API const Ref<REngine>& RApplication::getEngine() {
 		return REngine::instance();
 	}
 
 	API RApplication::RApplication()
 	{
-		Ref<REngine> engine = REngine::instance();
+		const Ref<REngine>& engine = REngine::instance();
 		engine->_application = Ref<RApplication>(this);
 	}
 
@@ -17,4 +17,24 @@ namespace rocket
 	{
 		
 	}
+
+	API void RApplication::load()
+	{
+
+	}
+
+	API void RApplication::update()
+	{
+
+	}
+
+	API void RApplication::render()
+	{
+
+	}
+
+	API void RApplication::unload()
+	{
+
+	}
 }
\ No newline at end of file
@@ -16,7 +16,7 @@ namespace rocket
 		virtual void render();
 		virtual void unload();
 
-		Ref<REngine> getEngine();
+		const Ref<REngine>& getEngine();
 		Ref<RInput> getInput();
 
 		Ref<RWindow> createWindow(int width = 1280, int height = 720, int style = 0);
@@ -2,20 +2,53 @@
 
 namespace rocket
 {
-    
+    RFrameState::RFrameState() : frame(0), time(0.0), alpha(0.0) {}
 
-    REngine::REngine():_application(nullptr) {}
+    void RFrameState::clear() {
+        transforms.clear();
+        visible.clear();
+        packets.reset();
+    }
+
+    REngine::REngine():_application(nullptr),
+        _fiberStackSize(DEFAULT_FIBER_STACK_SIZE),
+        _running(false),
+        _headless(false),
+        _fixedTimestep(RClock::toNanoseconds(1.0 / 60.0)),
+        _maxFrameTime(RClock::toNanoseconds(0.25)),
+        _minFrameTime(0),
+        _accumulator(0),
+        _simulationTime(0),
+        _frameTime(0),
+        _frameTimes(),
+        _frameTimeSum(0),
+        _frameCount(0),
+        _stepCount(0),
+        _pipelined(false),
+        _updateState(0) {}
 
     REngine::~REngine() {}
 
-    API Ref<REngine> REngine::instance() {
-        static Ref<REngine> instance;
+    API const Ref<REngine>& REngine::instance() {
+        static Ref<REngine> instance(new REngine(), [](REngine* engine) { delete engine; });
         return instance;
     }
 
     API void REngine::init() {
-        
-
+        if (_jobSystem == nullptr) {
+            _jobSystem = new_ref<RJobSystem>(0, 256, _fiberStackSize);
+        }
+        if (_taskScheduler == nullptr) {
+            _taskScheduler = new_ref<RTaskScheduler>(_jobSystem.get());
+        }
+        if (_renderBackend == nullptr) {
+            if (_headless) {
+                _renderBackend = new_ref<RNullBackend>();
+            } else {
+                _renderBackend = new_ref<RGLBackend>();
+            }
+        }
+        _renderBackend->setMetrics(&_metrics);
     }
 
     API void REngine::setClearColor(const RVector3& color) {
@@ -27,13 +60,220 @@ namespace rocket
     }
 
     API void REngine::present() {
-        
+        ROCKET_PROFILE_ZONE("REngine::present");
+        if (_taskScheduler != nullptr) {
+            _taskScheduler->update();
+        }
+        _frameArena.beginFrame();
+        RMemoryTracker::endFrame();
+        _metrics.set(RMetrics::ALLOCATIONS, (int64_t)RMemoryTracker::getFrameAllocations());
+        if (_jobSystem != nullptr) {
+            _metrics.set(RMetrics::JOB_QUEUE_DEPTH, _jobSystem->getQueuedCount());
+        }
+        _metrics.endFrame();
     }
 
     API void REngine::shutdown() {
         if (this->_application != nullptr) {
+            RMemoryScope scope(RMemoryTracker::TAG_APPLICATION);
             this->_application->unload();
         }
+        _renderBackend = nullptr;
+        _taskScheduler = nullptr;
+        _jobSystem = nullptr;
+    }
+
+    API void REngine::run(uint64_t maxFrames) {
+        init();
+        if (_application != nullptr) {
+            RMemoryScope scope(RMemoryTracker::TAG_APPLICATION);
+            _application->load();
+        }
+
+#ifdef ROCKET_PROFILING
+        RProfiler::setThreadName("Main");
+#endif
+        _running = true;
+        int64_t previous = RClock::now();
+        uint64_t frames = 0;
+        while (_running && (maxFrames == 0 || frames < maxFrames)) {
+            ROCKET_PROFILE_FRAME();
+            int64_t frameStart = RClock::now();
+            measure(frameStart - previous);
+            previous = frameStart;
+
+            if (_pipelined) {
+                // Simulate the next frame while this thread draws the last one.
+                RJobCounter simulation;
+                _jobSystem->run([this]() { simulate(); }, &simulation);
+                render();
+                ROCKET_PROFILE_ZONE("REngine::wait");
+                _jobSystem->wait(simulation);
+                swapFrameStates();
+            } else {
+                simulate();
+                swapFrameStates();
+                render();
+            }
+            present();
+            ++frames;
+
+            if (_minFrameTime > 0) {
+                ROCKET_PROFILE_ZONE("REngine::sleep");
+                RClock::sleepUntil(frameStart + _minFrameTime);
+            }
+        }
+        _running = false;
+
+        shutdown();
+    }
+
+    void REngine::measure(int64_t frameTime) {
+        _frameTime = frameTime;
+        unsigned int slot = (unsigned int)(_frameCount % FRAME_HISTORY);
+        _frameTimeSum += frameTime - _frameTimes[slot];
+        _frameTimes[slot] = frameTime;
+        ++_frameCount;
+        _accumulator += std::min(frameTime, _maxFrameTime);
+    }
+
+    void REngine::simulate() {
+        ROCKET_PROFILE_ZONE("REngine::update");
+        while (_accumulator >= _fixedTimestep) {
+            if (_application != nullptr) {
+                RMemoryScope scope(RMemoryTracker::TAG_APPLICATION);
+                _application->update();
+            }
+            _simulationTime += _fixedTimestep;
+            _accumulator -= _fixedTimestep;
+            ++_stepCount;
+        }
+
+        RFrameState& state = _frameStates[_updateState];
+        state.frame = _frameCount;
+        state.time = RClock::toSeconds(_simulationTime);
+        state.alpha = (double)_accumulator / (double)_fixedTimestep;
+    }
+
+    void REngine::render() {
+        ROCKET_PROFILE_ZONE("REngine::render");
+        if (!_headless) {
+            clear();
+            if (_application != nullptr) {
+                RMemoryScope scope(RMemoryTracker::TAG_APPLICATION);
+                _application->render();
+            }
+        }
+    }
+
+    void REngine::swapFrameStates() {
+        _updateState ^= 1;
+        _frameStates[_updateState].clear();
+    }
+
+    API void REngine::exit() {
+        _running = false;
+    }
+
+    API bool REngine::isRunning() const {
+        return _running;
+    }
+
+    API void REngine::setHeadless(bool headless) {
+        _headless = headless;
+    }
+
+    API bool REngine::isHeadless() const {
+        return _headless;
+    }
+
+    API void REngine::setFixedTimestep(double seconds) {
+        _fixedTimestep = std::max<int64_t>(RClock::toNanoseconds(seconds), 1);
+    }
+
+    API double REngine::getFixedTimestep() const {
+        return RClock::toSeconds(_fixedTimestep);
+    }
+
+    API void REngine::setMaxFrameTime(double seconds) {
+        _maxFrameTime = RClock::toNanoseconds(seconds);
+    }
+
+    API void REngine::setMaxFrameRate(double fps) {
+        _minFrameTime = fps > 0.0 ? RClock::toNanoseconds(1.0 / fps) : 0;
+    }
+
+    API void REngine::setPipelined(bool pipelined) {
+        _pipelined = pipelined;
+    }
+
+    API bool REngine::isPipelined() const {
+        return _pipelined;
+    }
+
+    API void REngine::setFiberStackSize(size_t bytes) {
+        _fiberStackSize = bytes;
+    }
+
+    API size_t REngine::getFiberStackSize() const {
+        return _fiberStackSize;
+    }
+
+    API RFrameState& REngine::getUpdateState() {
+        return _frameStates[_updateState];
+    }
+
+    API const RFrameState& REngine::getRenderState() const {
+        return _frameStates[_updateState ^ 1];
+    }
+
+    API double REngine::getAlpha() const {
+        return getRenderState().alpha;
+    }
+
+    API double REngine::getFrameTime() const {
+        return RClock::toSeconds(_frameTime);
+    }
+
+    API double REngine::getSmoothedFrameTime() const {
+        uint64_t samples = std::min<uint64_t>(_frameCount, FRAME_HISTORY);
+        return samples > 0 ? RClock::toSeconds(_frameTimeSum) / (double)samples : 0.0;
+    }
+
+    API double REngine::getSimulationTime() const {
+        return RClock::toSeconds(_simulationTime);
+    }
+
+    API uint64_t REngine::getFrameCount() const {
+        return _frameCount;
+    }
+
+    API uint64_t REngine::getStepCount() const {
+        return _stepCount;
+    }
+
+    API RMetrics& REngine::getMetrics() {
+        return _metrics;
+    }
+
+    API RFrameArena& REngine::getFrameArena() {
+        return _frameArena;
+    }
+
+    API const Ref<RJobSystem>& REngine::getJobSystem() {
+        return _jobSystem;
+    }
+
+    API const Ref<RTaskScheduler>& REngine::getTaskScheduler() {
+        return _taskScheduler;
+    }
+
+    API void REngine::setRenderBackend(const Ref<RRenderBackend>& backend) {
+        _renderBackend = backend;
+    }
+
+    API const Ref<RRenderBackend>& REngine::getRenderBackend() {
+        return _renderBackend;
     }
 
 }
\ No newline at end of file
@@ -4,6 +4,54 @@
 
 namespace rocket
 {
+    /**
+     * Defines the state one frame hands from simulation to rendering.
+     *
+     * REngine keeps two: RApplication::update() fills the one returned by
+     * REngine::getUpdateState() while RApplication::render() reads the one
+     * returned by REngine::getRenderState(), and the engine swaps them between
+     * frames. The state being filled is cleared first, keeping its capacity.
+     */
+    struct API RFrameState
+    {
+        /**
+         * The frame that produced this state.
+         */
+        uint64_t frame;
+
+        /**
+         * The simulation time at the end of the frame, in seconds.
+         */
+        double time;
+
+        /**
+         * The interpolation factor left over from the frame's last step; see REngine::getAlpha().
+         */
+        double alpha;
+
+        /**
+         * The world transforms of whatever the simulation wants drawn.
+         */
+        std::vector<RMatrix> transforms;
+
+        /**
+         * Indices into transforms of the objects that passed culling.
+         */
+        std::vector<uint32_t> visible;
+
+        /**
+         * Memory for the frame's draw packets; released when the state is cleared.
+         */
+        RLinearArena packets;
+
+        RFrameState();
+
+        /**
+         * Empties the state for reuse.
+         */
+        void clear();
+    };
+
     class API REngine
     {
         friend class RApplication;
@@ -12,14 +60,219 @@ namespace rocket
         ~REngine();
 
         Ref<RApplication> _application;
+        RFrameArena _frameArena;
+        Ref<RJobSystem> _jobSystem;
+        Ref<RTaskScheduler> _taskScheduler;
+        Ref<RRenderBackend> _renderBackend;
+        RMetrics _metrics;
+
+        static const unsigned int FRAME_HISTORY = 16;
+
+        size_t _fiberStackSize;
+
+        bool _running;
+        bool _headless;
+        int64_t _fixedTimestep;
+        int64_t _maxFrameTime;
+        int64_t _minFrameTime;
+        int64_t _accumulator;
+        int64_t _simulationTime;
+        int64_t _frameTime;
+        int64_t _frameTimes[FRAME_HISTORY];
+        int64_t _frameTimeSum;
+        uint64_t _frameCount;
+        uint64_t _stepCount;
+
+        bool _pipelined;
+        RFrameState _frameStates[2];
+        unsigned int _updateState;
+
+        void measure(int64_t frameTime);
+        void simulate();
+        void render();
+        void swapFrameStates();
 
     public:
-        static Ref<REngine> instance();
+        /**
+         * The default stack size of the job system's fibers, in bytes. Much larger
+         * than RFiber::DEFAULT_STACK_SIZE since a pipelined RApplication::update()
+         * runs on one; stacks are reserved up front but only committed as used.
+         */
+        static const size_t DEFAULT_FIBER_STACK_SIZE = 1024 * 1024;
+
+        static const Ref<REngine>& instance();
         
         void clear();
         void present();
         void init();
         void setClearColor(const RVector3& color);
         void shutdown();
+
+        /**
+         * Runs the application until exit() is called, or for a number of frames.
+         *
+         * Calls init() and RApplication::load(), then loops: each frame the time
+         * since the previous one is added to an accumulator, RApplication::update()
+         * runs once per whole fixed timestep in it, and RApplication::render()
+         * runs once with getAlpha() set to the fraction of a step left over, so it
+         * can interpolate between the last two simulation states. Finally calls
+         * shutdown(), which unloads the application.
+         *
+         * @param maxFrames The number of frames to run, or 0 to run until exit().
+         */
+        void run(uint64_t maxFrames = 0);
+
+        /**
+         * Makes run() return after the current frame.
+         */
+        void exit();
+
+        /**
+         * Returns true while run() is looping.
+         */
+        bool isRunning() const;
+
+        /**
+         * Sets whether the engine runs without a window. A headless engine never
+         * calls clear() or RApplication::render(), for servers and tests.
+         */
+        void setHeadless(bool headless);
+
+        /**
+         * Returns true if the engine runs without a window.
+         */
+        bool isHeadless() const;
+
+        /**
+         * Sets the simulation timestep, in seconds. Defaults to 1/60.
+         */
+        void setFixedTimestep(double seconds);
+
+        /**
+         * Returns the simulation timestep, in seconds; the delta time for RApplication::update().
+         */
+        double getFixedTimestep() const;
+
+        /**
+         * Sets the maximum frame time fed to the simulation, in seconds. Longer
+         * frames (a breakpoint, a hitch) are clamped so the simulation slows down
+         * instead of running an ever-growing number of steps to catch up. Defaults to 0.25.
+         */
+        void setMaxFrameTime(double seconds);
+
+        /**
+         * Limits the frame rate, or removes the limit when fps is 0 (the default).
+         */
+        void setMaxFrameRate(double fps);
+
+        /**
+         * Sets whether run() overlaps simulation and rendering.
+         *
+         * Pipelined, each frame runs RApplication::update() for frame N+1 as a job
+         * on the job system while the calling thread runs RApplication::render()
+         * for frame N, then waits for the job. The stages only share the frame
+         * states, which are swapped once both are done, so what is drawn lags the
+         * simulation by one frame. Must not be changed while run() is looping.
+         *
+         * The update job runs on a fiber, so its stack is limited to
+         * getFiberStackSize() bytes; overflowing it hits a guard page and crashes.
+         * Raise the limit with setFiberStackSize() for deeply recursive updates.
+         */
+        void setPipelined(bool pipelined);
+
+        /**
+         * Returns true if run() overlaps simulation and rendering.
+         */
+        bool isPipelined() const;
+
+        /**
+         * Sets the stack size of the job system's fibers, in bytes. Must be called
+         * before init(), which creates the job system. Defaults to DEFAULT_FIBER_STACK_SIZE.
+         */
+        void setFiberStackSize(size_t bytes);
+
+        /**
+         * Returns the stack size of the job system's fibers, in bytes.
+         */
+        size_t getFiberStackSize() const;
+
+        /**
+         * Returns the frame state RApplication::update() writes to.
+         */
+        RFrameState& getUpdateState();
+
+        /**
+         * Returns the frame state RApplication::render() reads from.
+         */
+        const RFrameState& getRenderState() const;
+
+        /**
+         * Returns the interpolation factor in [0, 1) between the previous and the
+         * current simulation state, for RApplication::render(). This is the alpha
+         * of getRenderState().
+         */
+        double getAlpha() const;
+
+        /**
+         * Returns the duration of the last frame, in seconds.
+         */
+        double getFrameTime() const;
+
+        /**
+         * Returns the duration of a frame averaged over the last few frames, in seconds.
+         */
+        double getSmoothedFrameTime() const;
+
+        /**
+         * Returns the simulated time, in seconds: the number of steps times the timestep.
+         * While pipelined, render() should read getRenderState().time instead.
+         */
+        double getSimulationTime() const;
+
+        /**
+         * Returns the number of frames run.
+         */
+        uint64_t getFrameCount() const;
+
+        /**
+         * Returns the number of simulation steps run.
+         */
+        uint64_t getStepCount() const;
+
+        /**
+         * Returns the per-frame scratch allocator. Allocations stay valid until the
+         * same frame slot comes around again, i.e. for two calls to present().
+         */
+        RFrameArena& getFrameArena();
+
+        /**
+         * Returns the engine's metrics. present() closes their frame after recording
+         * the frame's allocations and the job queue depth.
+         */
+        RMetrics& getMetrics();
+
+        /**
+         * Returns the job system, created by init() and destroyed by shutdown().
+         */
+        const Ref<RJobSystem>& getJobSystem();
+
+        /**
+         * Returns the coroutine scheduler, created by init() and destroyed by shutdown().
+         * Coroutines it resumes run on the thread that calls present().
+         */
+        const Ref<RTaskScheduler>& getTaskScheduler();
+
+        /**
+         * Sets the backend that executes command buffers. Must be called before
+         * init(); otherwise init() creates an RGLBackend, or an RNullBackend when
+         * the engine is headless.
+         */
+        void setRenderBackend(const Ref<RRenderBackend>& backend);
+
+        /**
+         * Returns the render backend. Draw calls and triangles it executes are
+         * added to getMetrics().
+         */
+        const Ref<RRenderBackend>& getRenderBackend();
     };
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "common.h"
+#include "math/RTransform.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+struct BoxSet
+{
+    std::vector<RBoundingBox> boxes;
+    std::vector<RMatrix> matrices;
+    std::vector<RBoundingBox> results;
+    std::vector<RVector3> centers;
+    std::vector<RVector3> extents;
+    std::vector<RVector3> resultCenters;
+    std::vector<RVector3> resultExtents;
+
+    explicit BoxSet(unsigned int count)
+        : boxes(count), matrices(count), results(count), centers(count), extents(count),
+          resultCenters(count), resultExtents(count)
+    {
+        srand(1);
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            RVector3 center(MATH_RANDOM_MINUS1_1() * 100.0f, MATH_RANDOM_MINUS1_1() * 100.0f, MATH_RANDOM_MINUS1_1() * 100.0f);
+            RVector3 extent(MATH_RANDOM_0_1() + 0.1f, MATH_RANDOM_0_1() + 0.1f, MATH_RANDOM_0_1() + 0.1f);
+            boxes[i].setCenterExtents(center, extent);
+            centers[i] = center;
+            extents[i] = extent;
+
+            RTransform transform;
+            transform.setTranslation(MATH_RANDOM_MINUS1_1() * 10.0f, MATH_RANDOM_MINUS1_1() * 10.0f, MATH_RANDOM_MINUS1_1() * 10.0f);
+            transform.setRotation(RVector3(MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), 1.0f).normalize(), MATH_RANDOM_0_1() * MATH_PIX2);
+            transform.setScale(MATH_RANDOM_0_1() + 0.5f);
+            matrices[i] = transform.getMatrix();
+        }
+    }
+};
+
+// The previous implementation: transform the eight corners and rebuild min/max.
+void transformCorners(const RBoundingBox& box, const RMatrix& matrix, RBoundingBox* dst)
+{
+    RVector3 corners[8];
+    box.getCorners(corners);
+    RVector3 newMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    RVector3 newMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (int i = 0; i < 8; ++i)
+    {
+        RVector3 p;
+        matrix.transformPoint(corners[i], &p);
+        newMin.set(std::min(newMin.x, p.x), std::min(newMin.y, p.y), std::min(newMin.z, p.z));
+        newMax.set(std::max(newMax.x, p.x), std::max(newMax.y, p.y), std::max(newMax.z, p.z));
+    }
+    dst->set(newMin, newMax);
+}
+
+void BM_BoundingBoxTransformCorners(benchmark::State& state)
+{
+    BoxSet set((unsigned int)state.range(0));
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < set.boxes.size(); ++i)
+        {
+            transformCorners(set.boxes[i], set.matrices[i], &set.results[i]);
+        }
+        benchmark::DoNotOptimize(set.results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoundingBoxTransform(benchmark::State& state)
+{
+    BoxSet set((unsigned int)state.range(0));
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < set.boxes.size(); ++i)
+        {
+            set.results[i] = set.boxes[i];
+            set.results[i].transform(set.matrices[i]);
+        }
+        benchmark::DoNotOptimize(set.results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoundingBoxTransformBatch(benchmark::State& state)
+{
+    BoxSet set((unsigned int)state.range(0));
+    for (auto _ : state)
+    {
+        RBoundingBox::transform(set.boxes.data(), set.matrices.data(), (unsigned int)set.boxes.size(), set.results.data());
+        benchmark::DoNotOptimize(set.results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_BoundingBoxTransformCenterExtents(benchmark::State& state)
+{
+    BoxSet set((unsigned int)state.range(0));
+    for (auto _ : state)
+    {
+        RBoundingBox::transform(set.centers.data(), set.extents.data(), set.matrices.data(), (unsigned int)set.centers.size(),
+                                set.resultCenters.data(), set.resultExtents.data());
+        benchmark::DoNotOptimize(set.resultCenters.data());
+        benchmark::DoNotOptimize(set.resultExtents.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_BoundingBoxTransformCorners)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_BoundingBoxTransform)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_BoundingBoxTransformBatch)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_BoundingBoxTransformCenterExtents)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,122 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+// A typical lit mesh draw: program, textures, buffers and the draw itself.
+void recordDraw(RCommandBuffer& buffer, uint32_t i)
+{
+    buffer.bindProgram(1 + (i & 7));
+    buffer.bindTexture(0, RBindTextureCommand::TEXTURE_2D, 1 + (i & 63));
+    buffer.bindUniformBuffer(0, 1, (i & 255) * 256, 256);
+    buffer.bindVertexArray(1 + (i & 31));
+    buffer.drawIndexed(PRIMITIVE_TRIANGLES, false, 36, 0, 0);
+}
+
+void BM_CommandBufferRecord(benchmark::State& state)
+{
+    const uint32_t draws = (uint32_t)state.range(0);
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        buffer.reset();
+        for (uint32_t i = 0; i < draws; ++i)
+        {
+            recordDraw(buffer, i);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * draws);
+    state.SetBytesProcessed(state.iterations() * buffer.getSize());
+}
+
+// Each thread records its own buffer, as render jobs would.
+void BM_CommandBufferRecordParallel(benchmark::State& state)
+{
+    const uint32_t draws = (uint32_t)state.range(0) / (uint32_t)state.threads();
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        buffer.reset();
+        for (uint32_t i = 0; i < draws; ++i)
+        {
+            recordDraw(buffer, i);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+void BM_CommandBufferSubmitNull(benchmark::State& state)
+{
+    const uint32_t draws = (uint32_t)state.range(0);
+    RCommandBuffer buffer;
+    for (uint32_t i = 0; i < draws; ++i)
+    {
+        recordDraw(buffer, i);
+    }
+    RNullBackend backend;
+    for (auto _ : state)
+    {
+        backend.submit(buffer);
+    }
+    benchmark::DoNotOptimize(backend.getStats().drawCalls);
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+// The baseline: the same draws as an array of structs with a virtual call per command.
+struct VirtualCommand
+{
+    virtual ~VirtualCommand() {}
+    virtual void execute(uint64_t& counter) const = 0;
+};
+
+struct VirtualBind : VirtualCommand
+{
+    uint32_t name;
+    void execute(uint64_t& counter) const override { counter += name; }
+};
+
+struct VirtualDraw : VirtualCommand
+{
+    uint32_t count;
+    void execute(uint64_t& counter) const override { counter += count; }
+};
+
+void BM_VirtualCommandSubmit(benchmark::State& state)
+{
+    const uint32_t draws = (uint32_t)state.range(0);
+    std::vector<std::unique_ptr<VirtualCommand>> commands;
+    for (uint32_t i = 0; i < draws; ++i)
+    {
+        for (uint32_t bind = 0; bind < 4; ++bind)
+        {
+            VirtualBind* command = new VirtualBind();
+            command->name = i & 7;
+            commands.emplace_back(command);
+        }
+        VirtualDraw* command = new VirtualDraw();
+        command->count = 36;
+        commands.emplace_back(command);
+    }
+    for (auto _ : state)
+    {
+        uint64_t counter = 0;
+        for (size_t i = 0; i < commands.size(); ++i)
+        {
+            commands[i]->execute(counter);
+        }
+        benchmark::DoNotOptimize(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * draws);
+}
+
+}
+
+BENCHMARK(BM_CommandBufferRecord)->Arg(1 << 10)->Arg(1 << 17);
+BENCHMARK(BM_CommandBufferRecordParallel)->Arg(1 << 17)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_CommandBufferSubmitNull)->Arg(1 << 10)->Arg(1 << 17);
+BENCHMARK(BM_VirtualCommandSubmit)->Arg(1 << 10)->Arg(1 << 17);
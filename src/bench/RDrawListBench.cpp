@@ -0,0 +1,162 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace rocket;
+
+namespace
+{
+
+const unsigned int DRAWS = 100000;
+
+// A scene-like mix: a few dozen pipelines, a few hundred materials and meshes,
+// a tenth of the draws translucent, submitted in scene order.
+void buildDrawList(RDrawList& list, unsigned int draws)
+{
+    std::mt19937 random(1);
+    list.clear();
+    list.reserve(draws);
+    for (unsigned int i = 0; i < draws; ++i)
+    {
+        uint32_t pipeline = random() % 32;
+        uint32_t material = random() % 512;
+        uint32_t mesh = random() % 256;
+        float depth = (float)(random() % 10000) / 10000.0f;
+        bool translucent = random() % 10 == 0;
+
+        RDrawPacket packet = {};
+        packet.program = 1 + pipeline;
+        packet.blendState = translucent ? RBlendState::alphaBlend()->getId() : RBlendState::opaque()->getId();
+        packet.cullState = pipeline % 8 == 0 ? RCullState::none()->getId() : RCullState::back()->getId();
+        packet.vertexArray = 1 + mesh;
+        packet.texture = 1 + material;
+        packet.uniformBuffer = 1;
+        packet.uniformOffset = material * 256;
+        packet.uniformRange = 256;
+        packet.primitive = PRIMITIVE_TRIANGLES;
+        packet.indexCount = 36;
+        packet.instanceCount = 1;
+        packet.baseInstance = i;
+        uint64_t key = translucent ? RSortKey::translucent(0, depth, pipeline, material)
+                                   : RSortKey::opaque(0, pipeline, material, mesh, depth);
+        list.add(key, packet);
+    }
+}
+
+std::vector<RSortItem> randomItems(unsigned int count)
+{
+    std::vector<RSortItem> items(count);
+    std::mt19937 random(2);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        items[i].key = RSortKey::opaque(0, random() % 32, random() % 512, random() % 256, (float)(random() % 10000) / 10000.0f);
+        items[i].index = i;
+    }
+    return items;
+}
+
+void BM_RadixSort(benchmark::State& state)
+{
+    const std::vector<RSortItem> input = randomItems(DRAWS);
+    std::vector<RSortItem> items(DRAWS), scratch(DRAWS);
+    for (auto _ : state)
+    {
+        items = input;
+        RRadixSort::sort(items.data(), scratch.data(), items.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+}
+
+void BM_RadixSortParallel(benchmark::State& state)
+{
+    RJobSystem jobs;
+    const std::vector<RSortItem> input = randomItems(DRAWS);
+    std::vector<RSortItem> items(DRAWS), scratch(DRAWS);
+    for (auto _ : state)
+    {
+        items = input;
+        RRadixSort::sort(items.data(), scratch.data(), items.size(), &jobs);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+    state.counters["threads"] = jobs.getThreadCount();
+}
+
+// The baseline: a comparison sort over the same key/index pairs.
+void BM_StdSort(benchmark::State& state)
+{
+    const std::vector<RSortItem> input = randomItems(DRAWS);
+    std::vector<RSortItem> items(DRAWS);
+    for (auto _ : state)
+    {
+        items = input;
+        std::sort(items.begin(), items.end(), [](const RSortItem& a, const RSortItem& b) { return a.key < b.key; });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+}
+
+// Recording in submission order: nearly every draw rebinds everything.
+void BM_DrawListRecordUnsorted(benchmark::State& state)
+{
+    RDrawList list;
+    buildDrawList(list, DRAWS);
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        buffer.reset();
+        list.record(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+    state.counters["binds"] = (double)list.getStats().binds;
+    state.counters["commands"] = (double)buffer.getCommandCount();
+}
+
+// Sort, then record in key order, skipping redundant binds: the per-frame cost.
+void BM_DrawListSortAndRecord(benchmark::State& state)
+{
+    RDrawList list;
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        buildDrawList(list, DRAWS);
+        buffer.reset();
+        state.ResumeTiming();
+        list.sort();
+        list.record(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+    state.counters["binds"] = (double)list.getStats().binds;
+    state.counters["commands"] = (double)buffer.getCommandCount();
+}
+
+// What the backend then has to walk: sorted versus unsorted command streams.
+void BM_DrawListSubmitNull(benchmark::State& state)
+{
+    RDrawList list;
+    buildDrawList(list, DRAWS);
+    if (state.range(0))
+    {
+        list.sort();
+    }
+    RCommandBuffer buffer;
+    list.record(buffer);
+    RNullBackend backend;
+    for (auto _ : state)
+    {
+        backend.submit(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * DRAWS);
+    state.counters["commands"] = (double)buffer.getCommandCount();
+}
+
+}
+
+BENCHMARK(BM_RadixSort);
+BENCHMARK(BM_RadixSortParallel)->UseRealTime();
+BENCHMARK(BM_StdSort);
+BENCHMARK(BM_DrawListRecordUnsorted);
+BENCHMARK(BM_DrawListSortAndRecord);
+BENCHMARK(BM_DrawListSubmitNull)->ArgName("sorted")->Arg(0)->Arg(1);
@@ -0,0 +1,145 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace rocket;
+
+namespace
+{
+
+const unsigned int INSTANCES = 1000000;
+const unsigned int MESHES = 64;
+const unsigned int MATERIALS = 16;
+// The eye translucent instances sort from, above the middle of the scene, and the sort range.
+const RVector3 EYE(500.0f, 50.0f, 500.0f);
+const float FAR_DISTANCE = 1000.0f;
+
+// A foliage-and-props scene: a million instances of a few dozen meshes, each
+// with one of a handful of materials, in the order a scene traversal finds them.
+// One instance in a hundred uses the last, translucent material, which is
+// drawn without instancing.
+struct Scene
+{
+    std::vector<std::unique_ptr<RMesh>> meshes;
+    std::vector<std::unique_ptr<RMaterial>> materials;
+    std::vector<RMeshInstance> instances;
+
+    Scene()
+    {
+        for (unsigned int i = 0; i < MESHES; ++i)
+        {
+            meshes.emplace_back(new RMesh(1 + i, PRIMITIVE_TRIANGLES, false, 36 * (1 + i % 4)));
+        }
+        for (unsigned int i = 0; i < MATERIALS; ++i)
+        {
+            materials.emplace_back(new RMaterial(1 + i % 4, 1 + i, i == MATERIALS - 1 ? RBlendState::alphaBlend() : nullptr));
+        }
+
+        std::mt19937 random(1);
+        instances.reserve(INSTANCES);
+        for (unsigned int i = 0; i < INSTANCES; ++i)
+        {
+            const RMesh* mesh = meshes[random() % MESHES].get();
+            const RMaterial* material = materials[random() % 100 == 0 ? MATERIALS - 1 : random() % (MATERIALS - 1)].get();
+            RMeshInstance instance(mesh, material);
+            RMatrix world;
+            world.m[12] = (float)(random() % 1000);
+            world.m[14] = (float)(random() % 1000);
+            instance.setWorld(world);
+            instance.setTint(RVector4(1.0f, 1.0f, 1.0f, 1.0f));
+            instance.setLod(random() % 3);
+            instances.push_back(instance);
+        }
+    }
+};
+
+const Scene& getScene()
+{
+    static Scene scene;
+    return scene;
+}
+
+// The per-frame CPU cost of instancing: batch, pack every instance into
+// instance memory, and record one draw per batch. The destination is plain
+// memory here, so this measures the CPU side without a GL context.
+void runBatching(benchmark::State& state, RJobSystem* jobs)
+{
+    const Scene& scene = getScene();
+    RInstanceBatcher batcher;
+    batcher.reserve(INSTANCES);
+    std::vector<RInstanceData> data(INSTANCES);
+    RDrawList list;
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        batcher.clear();
+        for (const RMeshInstance& instance : scene.instances)
+        {
+            batcher.add(&instance);
+        }
+        batcher.build(jobs);
+        batcher.write(data.data(), jobs);
+        benchmark::ClobberMemory();
+
+        list.clear();
+        buffer.reset();
+        batcher.submit(list, 0, EYE, FAR_DISTANCE);
+        list.sort();
+        list.record(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * INSTANCES);
+    state.SetBytesProcessed(state.iterations() * INSTANCES * sizeof(RInstanceData));
+    state.counters["batches"] = (double)batcher.getBatchCount();
+    state.counters["commands"] = (double)buffer.getCommandCount();
+}
+
+void BM_InstanceBatching(benchmark::State& state)
+{
+    runBatching(state, nullptr);
+}
+
+void BM_InstanceBatchingParallel(benchmark::State& state)
+{
+    RJobSystem jobs;
+    runBatching(state, &jobs);
+    state.counters["threads"] = jobs.getThreadCount();
+}
+
+// The baseline: one draw per instance through the sorted draw list.
+void BM_InstanceUnbatched(benchmark::State& state)
+{
+    const Scene& scene = getScene();
+    RDrawList list;
+    list.reserve(INSTANCES);
+    RCommandBuffer buffer;
+    for (auto _ : state)
+    {
+        list.clear();
+        buffer.reset();
+        for (unsigned int i = 0; i < INSTANCES; ++i)
+        {
+            const RMeshInstance& instance = scene.instances[i];
+            const RMesh* mesh = instance.getMesh();
+            const RMaterial* material = instance.getMaterial();
+            RDrawPacket packet = {};
+            packet.program = material->getProgram();
+            packet.vertexArray = mesh->getVertexArray();
+            packet.texture = material->getTexture();
+            packet.primitive = mesh->getPrimitive();
+            packet.indexCount = mesh->getIndexCount();
+            packet.instanceCount = 1;
+            packet.baseInstance = i;
+            list.add(RSortKey::opaque(0, material->getPipelineId(), material->getId(), mesh->getId(), 0.0f), packet);
+        }
+        list.sort();
+        list.record(buffer);
+    }
+    state.SetItemsProcessed(state.iterations() * INSTANCES);
+    state.counters["commands"] = (double)buffer.getCommandCount();
+}
+
+}
+
+BENCHMARK(BM_InstanceBatching)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InstanceBatchingParallel)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_InstanceUnbatched)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,101 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+// A few hundred nanoseconds of work per job, so the benchmarks measure scheduling
+// rather than an empty call.
+void work(unsigned int seed)
+{
+    float x = (float)seed;
+    for (int i = 0; i < 64; ++i)
+    {
+        x = x * 0.999f + 1.0f;
+    }
+    benchmark::DoNotOptimize(x);
+}
+
+// A layered task graph: every job of a layer depends on the whole previous layer,
+// expressed with dependency counters so no thread ever waits.
+void BM_JobGraphLayers(benchmark::State& state)
+{
+    const unsigned int layers = 16;
+    const unsigned int width = (unsigned int)state.range(0);
+    RJobSystem jobs(0, (unsigned int)state.range(1));
+    for (auto _ : state)
+    {
+        std::vector<RJobCounter> counters(layers);
+        for (unsigned int layer = 0; layer < layers; ++layer)
+        {
+            for (unsigned int i = 0; i < width; ++i)
+            {
+                jobs.run([i]() { work(i); }, &counters[layer], layer > 0 ? &counters[layer - 1] : nullptr);
+            }
+        }
+        jobs.wait(counters[layers - 1]);
+    }
+    state.SetItemsProcessed(state.iterations() * layers * width);
+}
+
+// A tree of jobs where every inner job spawns its children and waits for them, the
+// pattern that blocks threads without fibers (second argument 0) and suspends
+// fibers with them.
+void spawnTree(RJobSystem& jobs, unsigned int depth)
+{
+    if (depth == 0)
+    {
+        work(depth);
+        return;
+    }
+    RJobCounter counter;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        jobs.run([&jobs, depth]() { spawnTree(jobs, depth - 1); }, &counter);
+    }
+    jobs.wait(counter);
+}
+
+void BM_JobTreeWait(benchmark::State& state)
+{
+    const unsigned int depth = (unsigned int)state.range(0);
+    RJobSystem jobs(0, (unsigned int)state.range(1));
+    for (auto _ : state)
+    {
+        RJobCounter counter;
+        jobs.run([&jobs, depth]() { spawnTree(jobs, depth); }, &counter);
+        jobs.wait(counter);
+    }
+    state.SetItemsProcessed(state.iterations() * (1 << (3 * depth)));
+}
+
+RFiber::Context mainContext;
+RFiber* pingFiber;
+
+void pingMain()
+{
+    for (;;)
+    {
+        RFiber::switchTo(pingFiber->getContext(), &mainContext);
+    }
+}
+
+// One round trip: into a fiber and back.
+void BM_FiberSwitch(benchmark::State& state)
+{
+    RFiber fiber(&pingMain);
+    pingFiber = &fiber;
+    for (auto _ : state)
+    {
+        RFiber::switchTo(&mainContext, fiber.getContext());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+}
+
+BENCHMARK(BM_JobGraphLayers)->Args({ 64, 0 })->Args({ 64, 256 });
+BENCHMARK(BM_JobTreeWait)->Args({ 4, 0 })->Args({ 4, 256 });
+BENCHMARK(BM_FiberSwitch);
@@ -0,0 +1,260 @@
+#include "common.h"
+#include "math/RTransform.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+RVector3 randomVector(float range)
+{
+    return RVector3(MATH_RANDOM_MINUS1_1() * range, MATH_RANDOM_MINUS1_1() * range, MATH_RANDOM_MINUS1_1() * range);
+}
+
+RQuaternion randomRotation()
+{
+    RQuaternion rotation(MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1(), MATH_RANDOM_MINUS1_1());
+    rotation.normalize();
+    return rotation;
+}
+
+// A world matrix of the kind the scene graph produces: scale, rotation and translation.
+RMatrix randomWorldMatrix()
+{
+    RTransform transform(RVector3(MATH_RANDOM_0_1() + 0.5f, MATH_RANDOM_0_1() + 0.5f, MATH_RANDOM_0_1() + 0.5f),
+                         randomRotation(), randomVector(100.0f));
+    return transform.getMatrix();
+}
+
+// A camera at the origin looking down -z, as the render loop would cull against.
+RFrustum cameraFrustum()
+{
+    RMatrix projection;
+    RMatrix view;
+    RMatrix viewProjection;
+    RMatrix::createPerspective(60.0f, 16.0f / 9.0f, 0.1f, 500.0f, &projection);
+    RMatrix::createLookAt(RVector3::zero(), RVector3(0.0f, 0.0f, -1.0f), RVector3::unitY(), &view);
+    RMatrix::multiply(projection, view, &viewProjection);
+    return RFrustum(viewProjection);
+}
+
+void BM_MatrixMultiply(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RMatrix> a(count), b(count), results(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        a[i] = randomWorldMatrix();
+        b[i] = randomWorldMatrix();
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            RMatrix::multiply(a[i], b[i], &results[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_MatrixInvert(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RMatrix> matrices(count), results(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        matrices[i] = randomWorldMatrix();
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            matrices[i].invert(&results[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Skinning-style use: many points through one matrix.
+void BM_MatrixTransformPoint(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    RMatrix matrix = randomWorldMatrix();
+    std::vector<RVector3> points(count), results(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        points[i] = randomVector(10.0f);
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            matrix.transformPoint(points[i], &results[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Animation-style use: blend one pair of rotations per bone.
+void BM_QuaternionSlerp(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RQuaternion> from(count), to(count), results(count);
+    std::vector<float> t(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        from[i] = randomRotation();
+        to[i] = randomRotation();
+        t[i] = MATH_RANDOM_0_1();
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            RQuaternion::slerp(from[i], to[i], t[i], &results[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Culling: boxes scattered around the camera, roughly a sixth of them visible.
+void BM_BoundingBoxIntersectsFrustum(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    RFrustum frustum = cameraFrustum();
+    std::vector<RBoundingBox> boxes(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        RVector3 extents(MATH_RANDOM_0_1() + 0.5f, MATH_RANDOM_0_1() + 0.5f, MATH_RANDOM_0_1() + 0.5f);
+        boxes[i].setCenterExtents(randomVector(200.0f), extents);
+    }
+    for (auto _ : state)
+    {
+        unsigned int visible = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible += boxes[i].intersects(frustum) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(visible);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// Picking: rays from the origin against scattered boxes, most of them missing.
+void BM_RayIntersectsBoundingBox(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RRay> rays(count);
+    std::vector<RBoundingBox> boxes(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        rays[i].set(RVector3::zero(), randomVector(1.0f));
+        boxes[i].setCenterExtents(randomVector(50.0f), RVector3(2.0f, 2.0f, 2.0f));
+    }
+    for (auto _ : state)
+    {
+        float distance = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            distance += rays[i].intersects(boxes[i]);
+        }
+        benchmark::DoNotOptimize(distance);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+void BM_RayIntersectsBoundingSphere(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RRay> rays(count);
+    std::vector<RBoundingSphere> spheres(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        rays[i].set(RVector3::zero(), randomVector(1.0f));
+        spheres[i].set(randomVector(50.0f), 2.0f);
+    }
+    for (auto _ : state)
+    {
+        float distance = 0.0f;
+        for (size_t i = 0; i < count; ++i)
+        {
+            distance += rays[i].intersects(spheres[i]);
+        }
+        benchmark::DoNotOptimize(distance);
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// The scene graph case: every transform moved this frame, so every matrix is rebuilt.
+void BM_TransformGetMatrixDirty(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RTransform> transforms(count);
+    std::vector<RVector3> translations(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        transforms[i].set(RVector3(1.0f, 1.0f, 1.0f), randomRotation(), randomVector(100.0f));
+        translations[i] = randomVector(100.0f);
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            transforms[i].setTranslation(translations[i]);
+            benchmark::DoNotOptimize(&transforms[i].getMatrix());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+// The static case: nothing moved, so getMatrix() only checks the dirty bits.
+void BM_TransformGetMatrixClean(benchmark::State& state)
+{
+    const size_t count = (size_t)state.range(0);
+    srand(1);
+    std::vector<RTransform> transforms(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        transforms[i].set(RVector3(1.0f, 1.0f, 1.0f), randomRotation(), randomVector(100.0f));
+        transforms[i].getMatrix();
+    }
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            benchmark::DoNotOptimize(&transforms[i].getMatrix());
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+}
+
+BENCHMARK(BM_MatrixMultiply)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_MatrixInvert)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_MatrixTransformPoint)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_QuaternionSlerp)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_BoundingBoxIntersectsFrustum)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_RayIntersectsBoundingBox)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_RayIntersectsBoundingSphere)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_TransformGetMatrixDirty)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_TransformGetMatrixClean)->Arg(1 << 10)->Arg(1 << 16);
@@ -0,0 +1,170 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+// libstdc++ skips the atomic refcount updates of shared_ptr while the process
+// has never started a thread. The engine always runs worker threads, so start
+// one up front to measure the costs it actually pays.
+const bool threaded = []()
+{
+    std::thread([]() {}).join();
+    return true;
+}();
+
+// A stand-in for a texture or mesh resource: a little payload behind a shared pointer.
+struct Resource
+{
+    unsigned int id;
+    float data[7];
+
+    explicit Resource(unsigned int id) : id(id) {}
+};
+
+struct SharedResource : Resource, RRefCounted
+{
+    explicit SharedResource(unsigned int id) : Resource(id) {}
+};
+
+struct LocalResource : Resource, RLocalRefCounted
+{
+    explicit LocalResource(unsigned int id) : Resource(id) {}
+};
+
+template <typename Ptr>
+Ptr createResource(unsigned int id);
+
+template <>
+Ref<Resource> createResource(unsigned int id) { return new_ref<Resource>(id); }
+
+template <>
+IntrusiveRef<SharedResource> createResource(unsigned int id) { return new_intrusive_ref<SharedResource>(id); }
+
+template <>
+IntrusiveRef<LocalResource> createResource(unsigned int id) { return new_intrusive_ref<LocalResource>(id); }
+
+// Taking the reference by value like a setter storing a resource would.
+template <typename Ptr>
+#ifdef _MSC_VER
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+unsigned int useResource(Ptr resource)
+{
+    return resource->id;
+}
+
+// Copy a list of references (as when building a draw list), then pass every
+// copy by value, then drop them all.
+template <typename Ptr>
+void BM_RefCopy(benchmark::State& state)
+{
+    std::vector<Ptr> resources;
+    for (unsigned int i = 0; i < (unsigned int)state.range(0); ++i)
+    {
+        resources.push_back(createResource<Ptr>(i));
+    }
+
+    for (auto _ : state)
+    {
+        std::vector<Ptr> copies(resources);
+        unsigned int sum = 0;
+        for (const Ptr& resource : copies)
+        {
+            sum += useResource(resource);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes/ref"] = sizeof(Ptr);
+}
+
+template <typename Ptr>
+void BM_RefCreate(benchmark::State& state)
+{
+    std::vector<Ptr> resources((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        for (unsigned int i = 0; i < (unsigned int)resources.size(); ++i)
+        {
+            resources[i] = createResource<Ptr>(i);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Create a batch of short-lived objects, as a frame's particles or events would,
+// then destroy them all. The baseline goes through the global heap.
+void BM_ObjectNewDelete(benchmark::State& state)
+{
+    std::vector<Resource*> objects((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        for (unsigned int i = 0; i < (unsigned int)objects.size(); ++i)
+        {
+            objects[i] = new Resource(i);
+        }
+        benchmark::ClobberMemory();
+        for (Resource* object : objects)
+        {
+            delete object;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_ObjectPool(benchmark::State& state)
+{
+    RObjectPool<Resource> pool(256, state.range(1) != 0);
+    std::vector<Resource*> objects((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        for (unsigned int i = 0; i < (unsigned int)objects.size(); ++i)
+        {
+            objects[i] = pool.create(i);
+        }
+        benchmark::ClobberMemory();
+        for (Resource* object : objects)
+        {
+            pool.destroy(object);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The raw blocks underneath the pool, without constructing anything in them.
+void BM_SlabAllocator(benchmark::State& state)
+{
+    RSlabAllocator allocator(sizeof(Resource), alignof(Resource), 256, state.range(1) != 0);
+    std::vector<void*> blocks((size_t)state.range(0));
+    for (auto _ : state)
+    {
+        for (void*& block : blocks)
+        {
+            block = allocator.allocate();
+        }
+        benchmark::ClobberMemory();
+        for (void* block : blocks)
+        {
+            allocator.deallocate(block);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+BENCHMARK(BM_ObjectNewDelete)->Arg(10000);
+BENCHMARK(BM_ObjectPool)->ArgNames({ "objects", "threadCache" })->Args({ 10000, 0 })->Args({ 10000, 1 });
+BENCHMARK(BM_SlabAllocator)->ArgNames({ "blocks", "threadCache" })->Args({ 10000, 0 })->Args({ 10000, 1 });
+BENCHMARK_TEMPLATE(BM_RefCopy, Ref<Resource>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_RefCopy, IntrusiveRef<SharedResource>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_RefCopy, IntrusiveRef<LocalResource>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_RefCreate, Ref<Resource>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_RefCreate, IntrusiveRef<SharedResource>)->Arg(1 << 12);
+BENCHMARK_TEMPLATE(BM_RefCreate, IntrusiveRef<LocalResource>)->Arg(1 << 12);
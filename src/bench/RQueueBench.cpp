@@ -0,0 +1,158 @@
+#include "common.h"
+#include <benchmark/benchmark.h>
+
+using namespace rocket;
+
+namespace
+{
+
+const size_t CAPACITY = 1024;
+const size_t BATCH = 16;
+
+// The baseline every cross-thread handoff would otherwise use.
+class MutexQueue
+{
+public:
+    explicit MutexQueue(size_t capacity) : _capacity(capacity) {}
+
+    bool tryPush(uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.size() >= _capacity)
+        {
+            return false;
+        }
+        _queue.push(value);
+        return true;
+    }
+
+    bool tryPop(uint64_t& value)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queue.empty())
+        {
+            return false;
+        }
+        value = _queue.front();
+        _queue.pop();
+        return true;
+    }
+
+private:
+    std::mutex _mutex;
+    std::queue<uint64_t> _queue;
+    size_t _capacity;
+};
+
+template <typename Queue>
+void push(Queue& queue, uint64_t value)
+{
+    while (!queue.tryPush(value))
+    {
+        std::this_thread::yield();
+    }
+}
+
+template <typename Queue>
+uint64_t pop(Queue& queue)
+{
+    uint64_t value;
+    while (!queue.tryPop(value))
+    {
+        std::this_thread::yield();
+    }
+    return value;
+}
+
+// Even threads produce and odd threads consume, one element per iteration, so
+// every element pushed is popped by the time all threads finish. A single
+// thread pushes and pops, which measures the uncontended cost.
+template <typename Queue>
+void BM_Queue(benchmark::State& state)
+{
+    static Queue* queue;
+    if (state.thread_index() == 0)
+    {
+        queue = new Queue(CAPACITY);
+    }
+    bool single = state.threads() == 1;
+    bool producer = state.thread_index() % 2 == 0;
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+        if (single || producer)
+        {
+            push(*queue, value++);
+        }
+        if (single || !producer)
+        {
+            benchmark::DoNotOptimize(pop(*queue));
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0)
+    {
+        delete queue;
+    }
+}
+
+// As BM_Queue, moving BATCH elements per iteration with the batch operations.
+template <typename Queue>
+void BM_QueueBatch(benchmark::State& state)
+{
+    static Queue* queue;
+    if (state.thread_index() == 0)
+    {
+        queue = new Queue(CAPACITY);
+    }
+    bool single = state.threads() == 1;
+    bool producer = state.thread_index() % 2 == 0;
+    uint64_t values[BATCH] = {};
+    for (auto _ : state)
+    {
+        if (single || producer)
+        {
+            for (size_t done = 0; done < BATCH;)
+            {
+                size_t pushed = queue->tryPushBatch(values + done, BATCH - done);
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+                done += pushed;
+            }
+        }
+        if (single || !producer)
+        {
+            for (size_t done = 0; done < BATCH;)
+            {
+                size_t popped = queue->tryPopBatch(values + done, BATCH - done);
+                if (popped == 0)
+                {
+                    std::this_thread::yield();
+                }
+                done += popped;
+            }
+            benchmark::DoNotOptimize(values);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+    if (state.thread_index() == 0)
+    {
+        delete queue;
+    }
+}
+
+void BM_SpscQueue(benchmark::State& state) { BM_Queue<RSpscQueue<uint64_t>>(state); }
+void BM_SpscQueueBatch(benchmark::State& state) { BM_QueueBatch<RSpscQueue<uint64_t>>(state); }
+void BM_MpmcQueue(benchmark::State& state) { BM_Queue<RMpmcQueue<uint64_t>>(state); }
+void BM_MpmcQueueBatch(benchmark::State& state) { BM_QueueBatch<RMpmcQueue<uint64_t>>(state); }
+void BM_MutexQueue(benchmark::State& state) { BM_Queue<MutexQueue>(state); }
+
+}
+
+BENCHMARK(BM_SpscQueue)->Threads(1)->Threads(2)->UseRealTime();
+BENCHMARK(BM_SpscQueueBatch)->Threads(1)->Threads(2)->UseRealTime();
+BENCHMARK(BM_MpmcQueue)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+BENCHMARK(BM_MpmcQueueBatch)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+BENCHMARK(BM_MutexQueue)->Threads(1)->Threads(2)->Threads(4)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
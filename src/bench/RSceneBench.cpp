@@ -0,0 +1,485 @@
+// rocket_scenebench: runs a headless frame pipeline over a synthetic world and
+// reports the time, throughput and memory of every stage as JSON.
+//
+//   rocket_scenebench [--objects N[,N...]] [--frames F] [--seed S] [--parallel] [--output FILE]
+//
+// The same seed always generates the same world and camera path, so results
+// from different builds are directly comparable.
+#include "common.h"
+#include "math/RTransform.h"
+#include <random>
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace rocket;
+
+namespace
+{
+
+// Objects come in groups of this size: one root and a few levels of children,
+// like props attached to a moving entity.
+const unsigned int GROUP_SIZE = 16;
+const unsigned int CHILDREN_PER_NODE = 3;
+const unsigned int MESH_COUNT = 256;
+const unsigned int MATERIAL_COUNT = 64;
+const float WORLD_SIZE = 1000.0f;
+const float FAR_DISTANCE = 600.0f;
+const float TIMESTEP = 1.0f / 60.0f;
+
+// std::uniform_real_distribution differs between standard libraries; this does not.
+class Random
+{
+public:
+    explicit Random(uint32_t seed) : _engine(seed) {}
+
+    float next() { return (float)(_engine() >> 8) * (1.0f / 16777216.0f); }
+    float range(float min, float max) { return min + (max - min) * next(); }
+    uint32_t below(uint32_t count) { return _engine() % count; }
+
+private:
+    std::mt19937 _engine;
+};
+
+struct Scene
+{
+    std::vector<int32_t> parents;
+    std::vector<RTransform> locals;
+    std::vector<float> spins;
+    std::vector<RBoundingBox> localBounds;
+    std::vector<RMatrix> worlds;
+    std::vector<RBoundingBox> worldBounds;
+    std::vector<uint16_t> meshes;
+    std::vector<uint16_t> materials;
+    std::vector<uint8_t> visibleFlags;
+
+    size_t getBytes() const
+    {
+        return parents.capacity() * sizeof(int32_t) + locals.capacity() * sizeof(RTransform) +
+               spins.capacity() * sizeof(float) + localBounds.capacity() * sizeof(RBoundingBox) +
+               worlds.capacity() * sizeof(RMatrix) + worldBounds.capacity() * sizeof(RBoundingBox) +
+               meshes.capacity() * sizeof(uint16_t) + materials.capacity() * sizeof(uint16_t) +
+               visibleFlags.capacity() * sizeof(uint8_t);
+    }
+};
+
+struct DrawItem
+{
+    uint16_t mesh;
+    uint16_t material;
+    uint32_t instanceCount;
+    // The world matrices of the instances, in FrameLists::instanceWorlds.
+    const RMatrix* const* instances;
+};
+
+struct FrameLists
+{
+    std::vector<uint32_t> visible;
+    std::vector<RSortItem> sorted;
+    std::vector<RSortItem> scratch;
+    std::vector<const RMatrix*> instanceWorlds;
+    std::vector<DrawItem> draws;
+
+    size_t getBytes() const
+    {
+        return visible.capacity() * sizeof(uint32_t) + (sorted.capacity() + scratch.capacity()) * sizeof(RSortItem) +
+               instanceWorlds.capacity() * sizeof(const RMatrix*) + draws.capacity() * sizeof(DrawItem);
+    }
+};
+
+void generate(Scene& scene, unsigned int count, uint32_t seed)
+{
+    Random random(seed);
+    scene.parents.resize(count);
+    scene.locals.resize(count);
+    scene.spins.resize(count);
+    scene.localBounds.resize(count);
+    scene.worlds.resize(count);
+    scene.worldBounds.resize(count);
+    scene.meshes.resize(count);
+    scene.materials.resize(count);
+    scene.visibleFlags.resize(count);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int group = i - i % GROUP_SIZE;
+        unsigned int local = i - group;
+        RQuaternion rotation(RVector3(random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f)).normalize(),
+                             random.range(0.0f, MATH_PIX2));
+        if (local == 0)
+        {
+            // Roots are spread over the world; children sit close to their parent,
+            // which always precedes them so one forward pass resolves the hierarchy.
+            scene.parents[i] = -1;
+            RVector3 position(random.range(-WORLD_SIZE, WORLD_SIZE), random.range(-10.0f, 10.0f), random.range(-WORLD_SIZE, WORLD_SIZE));
+            scene.locals[i].set(RVector3::one(), rotation, position);
+        }
+        else
+        {
+            scene.parents[i] = (int32_t)(group + (local - 1) / CHILDREN_PER_NODE);
+            RVector3 offset(random.range(-2.0f, 2.0f), random.range(-2.0f, 2.0f), random.range(-2.0f, 2.0f));
+            scene.locals[i].set(RVector3::one(), rotation, offset);
+        }
+        // A quarter of the objects animate every frame.
+        scene.spins[i] = random.below(4) == 0 ? random.range(-2.0f, 2.0f) : 0.0f;
+
+        RVector3 extents(random.range(0.2f, 1.0f), random.range(0.2f, 1.0f), random.range(0.2f, 1.0f));
+        scene.localBounds[i].setCenterExtents(RVector3::zero(), extents);
+        scene.meshes[i] = (uint16_t)random.below(MESH_COUNT);
+        scene.materials[i] = (uint16_t)random.below(MATERIAL_COUNT);
+    }
+}
+
+// The camera circles the middle of the world, looking outwards.
+RFrustum cameraFrustum(unsigned int frame, RVector3* position)
+{
+    float angle = (float)frame * 0.01f;
+    *position = RVector3(cosf(angle) * 100.0f, 20.0f, sinf(angle) * 100.0f);
+    RVector3 target(cosf(angle) * 400.0f, 0.0f, sinf(angle) * 400.0f);
+
+    RMatrix projection;
+    RMatrix view;
+    RMatrix viewProjection;
+    RMatrix::createPerspective(60.0f, 16.0f / 9.0f, 0.1f, FAR_DISTANCE, &projection);
+    RMatrix::createLookAt(*position, target, RVector3::unitY(), &view);
+    RMatrix::multiply(projection, view, &viewProjection);
+    return RFrustum(viewProjection);
+}
+
+// Runs function(begin, end) over [0, count), split across the job system when there is one.
+template <typename Function>
+void forRange(RJobSystem* jobs, unsigned int count, Function function)
+{
+    if (jobs)
+    {
+        jobs->parallelFor(count, function);
+    }
+    else
+    {
+        function(0u, count);
+    }
+}
+
+void animate(Scene& scene, RJobSystem* jobs)
+{
+    ROCKET_PROFILE_ZONE("animate");
+    forRange(jobs, (unsigned int)scene.locals.size(), [&scene](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            if (scene.spins[i] != 0.0f)
+            {
+                scene.locals[i].rotateY(scene.spins[i] * TIMESTEP);
+            }
+        }
+    });
+}
+
+void updateWorld(Scene& scene, RJobSystem* jobs)
+{
+    ROCKET_PROFILE_ZONE("world");
+    // Groups are independent, so split on group boundaries.
+    unsigned int count = (unsigned int)scene.locals.size();
+    unsigned int groups = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+    forRange(jobs, groups, [&scene, count](unsigned int beginGroup, unsigned int endGroup)
+    {
+        unsigned int begin = beginGroup * GROUP_SIZE;
+        unsigned int end = std::min(endGroup * GROUP_SIZE, count);
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            int32_t parent = scene.parents[i];
+            if (parent < 0)
+            {
+                scene.worlds[i] = scene.locals[i].getMatrix();
+            }
+            else
+            {
+                RMatrix::multiply(scene.worlds[parent], scene.locals[i].getMatrix(), &scene.worlds[i]);
+            }
+        }
+        RBoundingBox::transform(&scene.localBounds[begin], &scene.worlds[begin], end - begin, &scene.worldBounds[begin]);
+    });
+}
+
+void cull(Scene& scene, FrameLists& lists, const RFrustum& frustum, RJobSystem* jobs)
+{
+    ROCKET_PROFILE_ZONE("cull");
+    forRange(jobs, (unsigned int)scene.worldBounds.size(), [&scene, &frustum](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            scene.visibleFlags[i] = frustum.intersects(scene.worldBounds[i]) ? 1 : 0;
+        }
+    });
+
+    lists.visible.clear();
+    for (uint32_t i = 0; i < (uint32_t)scene.visibleFlags.size(); ++i)
+    {
+        if (scene.visibleFlags[i])
+        {
+            lists.visible.push_back(i);
+        }
+    }
+}
+
+void sort(const Scene& scene, FrameLists& lists, const RVector3& camera, RJobSystem* jobs)
+{
+    ROCKET_PROFILE_ZONE("sort");
+    // The engine's opaque draw keys: material first to minimise state changes,
+    // then mesh so instances end up adjacent, then front to back. The scene has
+    // a single pipeline.
+    const unsigned int count = (unsigned int)lists.visible.size();
+    lists.sorted.resize(count);
+    lists.scratch.resize(count);
+    forRange(jobs, count, [&scene, &lists, &camera](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            uint32_t object = lists.visible[i];
+            const float* m = scene.worlds[object].m;
+            RVector3 position(m[12], m[13], m[14]);
+            float depth = position.distance(camera) / FAR_DISTANCE;
+            lists.sorted[i].key = RSortKey::opaque(0, 0, scene.materials[object], scene.meshes[object], depth);
+            lists.sorted[i].index = object;
+        }
+    });
+    RRadixSort::sort(lists.sorted.data(), lists.scratch.data(), count, jobs);
+}
+
+void buildDrawList(const Scene& scene, FrameLists& lists)
+{
+    ROCKET_PROFILE_ZONE("draw list");
+    lists.draws.clear();
+    lists.instanceWorlds.resize(lists.sorted.size());
+    for (size_t i = 0; i < lists.sorted.size(); ++i)
+    {
+        uint32_t object = lists.sorted[i].index;
+        lists.instanceWorlds[i] = &scene.worlds[object];
+        uint16_t mesh = scene.meshes[object];
+        uint16_t material = scene.materials[object];
+        if (!lists.draws.empty() && lists.draws.back().mesh == mesh && lists.draws.back().material == material)
+        {
+            ++lists.draws.back().instanceCount;
+        }
+        else
+        {
+            DrawItem draw = { mesh, material, 1, lists.instanceWorlds.data() + i };
+            lists.draws.push_back(draw);
+        }
+    }
+}
+
+enum Stage
+{
+    STAGE_ANIMATE,
+    STAGE_WORLD,
+    STAGE_CULL,
+    STAGE_SORT,
+    STAGE_DRAW_LIST,
+    STAGE_FRAME,
+    STAGE_COUNT
+};
+
+const char* const STAGE_NAMES[STAGE_COUNT] = { "animate", "world", "cull", "sort", "drawList", "frame" };
+
+struct Result
+{
+    unsigned int objects;
+    double generateMs;
+    std::vector<double> stageMs[STAGE_COUNT];
+    // The number of items each stage processes per frame, for throughput.
+    double stageItems[STAGE_COUNT];
+    double visible;
+    double draws;
+    size_t sceneBytes;
+    size_t listBytes;
+};
+
+double percentile(std::vector<double> values, double fraction)
+{
+    std::sort(values.begin(), values.end());
+    return values[(size_t)(fraction * (double)(values.size() - 1) + 0.5)];
+}
+
+Result run(unsigned int objects, unsigned int frames, uint32_t seed, RJobSystem* jobs)
+{
+    Result result = {};
+    result.objects = objects;
+
+    Scene scene;
+    int64_t start = RClock::now();
+    generate(scene, objects, seed);
+    result.generateMs = RClock::toSeconds(RClock::now() - start) * 1000.0;
+
+    FrameLists lists;
+    for (unsigned int frame = 0; frame < frames; ++frame)
+    {
+        RVector3 camera;
+        RFrustum frustum = cameraFrustum(frame, &camera);
+        int64_t times[STAGE_COUNT];
+
+        times[0] = RClock::now();
+        animate(scene, jobs);
+        times[1] = RClock::now();
+        updateWorld(scene, jobs);
+        times[2] = RClock::now();
+        cull(scene, lists, frustum, jobs);
+        times[3] = RClock::now();
+        sort(scene, lists, camera, jobs);
+        times[4] = RClock::now();
+        buildDrawList(scene, lists);
+        times[5] = RClock::now();
+
+        for (unsigned int stage = 0; stage < STAGE_FRAME; ++stage)
+        {
+            result.stageMs[stage].push_back(RClock::toSeconds(times[stage + 1] - times[stage]) * 1000.0);
+        }
+        result.stageMs[STAGE_FRAME].push_back(RClock::toSeconds(times[5] - times[0]) * 1000.0);
+        result.visible += (double)lists.visible.size() / frames;
+        result.draws += (double)lists.draws.size() / frames;
+    }
+
+    result.stageItems[STAGE_ANIMATE] = objects;
+    result.stageItems[STAGE_WORLD] = objects;
+    result.stageItems[STAGE_CULL] = objects;
+    result.stageItems[STAGE_SORT] = result.visible;
+    result.stageItems[STAGE_DRAW_LIST] = result.visible;
+    result.stageItems[STAGE_FRAME] = objects;
+    result.sceneBytes = scene.getBytes();
+    result.listBytes = lists.getBytes();
+    return result;
+}
+
+size_t getPeakResidentBytes()
+{
+#ifndef WIN32
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return (size_t)usage.ru_maxrss * 1024;
+    }
+#endif
+    return 0;
+}
+
+void writeJson(std::ostream& out, const std::vector<Result>& results, unsigned int frames, uint32_t seed, RJobSystem* jobs)
+{
+    out << "{\n  \"benchmark\": \"rocket_scenebench\",\n  \"seed\": " << seed << ",\n  \"frames\": " << frames
+        << ",\n  \"threads\": " << (jobs ? jobs->getThreadCount() : 1) << ",\n  \"peakResidentBytes\": " << getPeakResidentBytes()
+        << ",\n  \"runs\": [";
+    for (size_t r = 0; r < results.size(); ++r)
+    {
+        const Result& result = results[r];
+        out << (r > 0 ? "," : "") << "\n    {\n      \"objects\": " << result.objects
+            << ",\n      \"generateMs\": " << result.generateMs
+            << ",\n      \"visible\": " << result.visible
+            << ",\n      \"draws\": " << result.draws
+            << ",\n      \"sceneBytes\": " << result.sceneBytes
+            << ",\n      \"listBytes\": " << result.listBytes
+            << ",\n      \"stages\": {";
+        for (unsigned int stage = 0; stage < STAGE_COUNT; ++stage)
+        {
+            const std::vector<double>& times = result.stageMs[stage];
+            double sum = 0.0;
+            for (size_t i = 0; i < times.size(); ++i)
+            {
+                sum += times[i];
+            }
+            double mean = sum / (double)times.size();
+            out << (stage > 0 ? "," : "") << "\n        \"" << STAGE_NAMES[stage] << "\": { \"meanMs\": " << mean
+                << ", \"minMs\": " << percentile(times, 0.0)
+                << ", \"p50Ms\": " << percentile(times, 0.5)
+                << ", \"p95Ms\": " << percentile(times, 0.95)
+                << ", \"maxMs\": " << percentile(times, 1.0)
+                << ", \"itemsPerSecond\": " << (mean > 0.0 ? result.stageItems[stage] / (mean / 1000.0) : 0.0) << " }";
+        }
+        out << "\n      }\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<unsigned int> counts;
+    unsigned int frames = 120;
+    uint32_t seed = 1;
+    bool parallel = false;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--objects" && i + 1 < argc)
+        {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ','))
+            {
+                counts.push_back((unsigned int)std::stoul(item));
+            }
+        }
+        else if (arg == "--frames" && i + 1 < argc)
+        {
+            frames = (unsigned int)std::stoul(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = (uint32_t)std::stoul(argv[++i]);
+        }
+        else if (arg == "--parallel")
+        {
+            parallel = true;
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--objects N[,N...]] [--frames F] [--seed S] [--parallel] [--output FILE]" << std::endl;
+            return 1;
+        }
+    }
+    if (counts.empty())
+    {
+        counts.push_back(100000);
+        counts.push_back(1000000);
+    }
+    if (frames == 0)
+    {
+        frames = 1;
+    }
+
+    std::unique_ptr<RJobSystem> jobs;
+    if (parallel)
+    {
+        jobs.reset(new RJobSystem());
+    }
+
+    std::vector<Result> results;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        results.push_back(run(counts[i], frames, seed, jobs.get()));
+        const Result& result = results.back();
+        std::cerr << result.objects << " objects: frame " << percentile(result.stageMs[STAGE_FRAME], 0.5) << " ms p50, "
+                  << result.visible << " visible, " << result.draws << " draws" << std::endl;
+    }
+
+    if (output.empty())
+    {
+        writeJson(std::cout, results, frames, seed, jobs.get());
+    }
+    else
+    {
+        std::ofstream file(output);
+        writeJson(file, results, frames, seed, jobs.get());
+        if (!file)
+        {
+            std::cerr << "could not write " << output << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -18,6 +18,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <math.h>
+#include <cfloat>
 #include <regex>
 #include <thread>
 #include <functional>
@@ -65,6 +66,7 @@ namespace rocket
     class RVector3;
     class RVector4;
     class RBoundingBox;
+    class RBoundingOrientedBox;
     class RBoundingSphere;
     class RFrustum;
     class RPlane;
@@ -74,11 +76,40 @@ namespace rocket
     class RWindow;
     class RApplication;
     class RInput;
+    class RClock;
+    class RProfiler;
+    class RMetrics;
+
+    class RJobCounter;
+    class RJobSystem;
+    class RTaskScheduler;
+
+    class RBlendState;
+    class RCullState;
+    class RCommandBuffer;
+    class RRenderBackend;
+    class RMaterial;
+    class RMesh;
+    class RMeshInstance;
 }
 // -- MEMORY/TYPES -- //
 #include "types/RConstants.h"
 #include "types/REnums.h"
 #include "types/RMemory.h"
+#include "types/RHandle.h"
+#include "types/RIdAllocator.h"
+#include "types/RMemoryTracker.h"
+#include "types/RQueue.h"
+
+// -- THREADING -- //
+#include "threading/RJobSystem.h"
+#include "threading/RTask.h"
+
+// -- UTILITIES -- //
+#include "utilities/RClock.h"
+#include "utilities/RProfiler.h"
+#include "utilities/RMetrics.h"
+#include "utilities/RRadixSort.h"
 
 // -- MATH -- //
 #include "math/RMatrix.h"
@@ -87,6 +118,7 @@ namespace rocket
 #include "math/RVector3.h"
 #include "math/RVector4.h"
 #include "math/RBoundingBox.h"
+#include "math/RBoundingOrientedBox.h"
 #include "math/RBoundingSphere.h"
 #include "math/RFrustum.h"
 #include "math/RPlane.h"
@@ -103,6 +135,23 @@ namespace rocket
 #include "input/RMouse.h"
 #include "input/RGameController.h"
 // -- GFX -- //
+#include "graphics/RStreamBuffer.h"
+#include "graphics/RVertexBuffer.h"
+#include "graphics/RIndexBuffer.h"
+#include "graphics/RHeadlessContext.h"
+#include "graphics/RBlendState.h"
+#include "graphics/RCullState.h"
+#include "graphics/RCommandBuffer.h"
+#include "graphics/RRenderBackend.h"
+#include "graphics/RGLStateCache.h"
+#include "graphics/RGLBackend.h"
+#include "graphics/RNullBackend.h"
+#include "graphics/RDrawList.h"
+#include "materials/RMaterial.h"
+#include "graphics/RMesh.h"
+#include "graphics/RMeshInstance.h"
+#include "graphics/RInstanceBuffer.h"
+#include "graphics/RInstanceBatcher.h"
 
 // -- AUDIO -- //
 
@@ -0,0 +1,112 @@
+#include "common.h"
+#include "RBlendState.h"
+#include "RStateRegistry.h"
+
+namespace rocket
+{
+    namespace
+    {
+        RStateRegistry<RBlendState>& getRegistry()
+        {
+            static RStateRegistry<RBlendState> registry;
+            // Interned first, so the default state is id 0.
+            static const RBlendState* defaultState = registry.intern(RBlendState::Desc());
+            (void)defaultState;
+            return registry;
+        }
+
+        const RBlendState* createBlend(RBlendState::Factor src, RBlendState::Factor dst)
+        {
+            RBlendState::Desc desc;
+            desc.enabled = true;
+            desc.srcColor = src;
+            desc.dstColor = dst;
+            desc.srcAlpha = src;
+            desc.dstAlpha = dst;
+            return RBlendState::create(desc);
+        }
+    }
+
+    RBlendState::Desc::Desc() :
+        enabled(false),
+        srcColor(ONE),
+        dstColor(ZERO),
+        srcAlpha(ONE),
+        dstAlpha(ZERO),
+        colorOperation(ADD),
+        alphaOperation(ADD),
+        writeMask(ALL)
+    {
+    }
+
+    uint64_t RBlendState::Desc::pack() const
+    {
+        // Disabled blending ignores the factors and operations, so they do not make a different state.
+        if (!enabled)
+        {
+            return (uint64_t)writeMask;
+        }
+        return (uint64_t)writeMask |
+               (uint64_t)1 << 8 |
+               (uint64_t)srcColor << 16 |
+               (uint64_t)dstColor << 24 |
+               (uint64_t)srcAlpha << 32 |
+               (uint64_t)dstAlpha << 40 |
+               (uint64_t)colorOperation << 48 |
+               (uint64_t)alphaOperation << 56;
+    }
+
+    RBlendState::RBlendState(Id id, const Desc& desc) :
+        _id(id),
+        _desc(desc)
+    {
+    }
+
+    const RBlendState* RBlendState::create(const Desc& desc)
+    {
+        return getRegistry().intern(desc);
+    }
+
+    const RBlendState* RBlendState::get(Id id)
+    {
+        return getRegistry().get(id);
+    }
+
+    unsigned int RBlendState::getCount()
+    {
+        return getRegistry().getCount();
+    }
+
+    const RBlendState* RBlendState::opaque()
+    {
+        return get(0);
+    }
+
+    const RBlendState* RBlendState::alphaBlend()
+    {
+        static const RBlendState* state = createBlend(SRC_ALPHA, ONE_MINUS_SRC_ALPHA);
+        return state;
+    }
+
+    const RBlendState* RBlendState::premultiplied()
+    {
+        static const RBlendState* state = createBlend(ONE, ONE_MINUS_SRC_ALPHA);
+        return state;
+    }
+
+    const RBlendState* RBlendState::additive()
+    {
+        static const RBlendState* state = createBlend(ONE, ONE);
+        return state;
+    }
+
+    RBlendState::Id RBlendState::getId() const
+    {
+        return _id;
+    }
+
+    const RBlendState::Desc& RBlendState::getDesc() const
+    {
+        return _desc;
+    }
+}
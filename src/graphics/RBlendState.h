@@ -0,0 +1,122 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines an immutable blend state.
+     *
+     * States are interned: create() returns the one object for each distinct
+     * description, so two draws use the same blend exactly when they use the same
+     * object, and the object's id can be stored in sort keys and commands. The
+     * default description, with blending off, always has id 0.
+     */
+    class API RBlendState
+    {
+    public:
+        typedef uint16_t Id;
+
+        enum Factor : uint8_t
+        {
+            ZERO,
+            ONE,
+            SRC_COLOR,
+            ONE_MINUS_SRC_COLOR,
+            DST_COLOR,
+            ONE_MINUS_DST_COLOR,
+            SRC_ALPHA,
+            ONE_MINUS_SRC_ALPHA,
+            DST_ALPHA,
+            ONE_MINUS_DST_ALPHA
+        };
+
+        enum Operation : uint8_t
+        {
+            ADD,
+            SUBTRACT,
+            REVERSE_SUBTRACT,
+            MIN,
+            MAX
+        };
+
+        enum ColorMask : uint8_t
+        {
+            RED = 1,
+            GREEN = 2,
+            BLUE = 4,
+            ALPHA = 8,
+            ALL = RED | GREEN | BLUE | ALPHA
+        };
+
+        /**
+         * Describes a blend state. Defaults to blending off and writing every channel.
+         */
+        struct Desc
+        {
+            bool enabled;
+            Factor srcColor;
+            Factor dstColor;
+            Factor srcAlpha;
+            Factor dstAlpha;
+            Operation colorOperation;
+            Operation alphaOperation;
+            uint8_t writeMask;
+
+            Desc();
+
+            /**
+             * Returns the description as one integer; equal descriptions pack equally.
+             */
+            uint64_t pack() const;
+        };
+
+        /**
+         * Returns the state with a description, creating it on first use.
+         *
+         * @return The state, or null if RStateRegistry::MAX_STATES states already exist.
+         */
+        static const RBlendState* create(const Desc& desc);
+
+        /**
+         * Returns the state with an id, or null.
+         */
+        static const RBlendState* get(Id id);
+
+        /**
+         * Returns the number of distinct blend states created.
+         */
+        static unsigned int getCount();
+
+        /**
+         * Blending off.
+         */
+        static const RBlendState* opaque();
+
+        /**
+         * Source over destination by source alpha.
+         */
+        static const RBlendState* alphaBlend();
+
+        /**
+         * Source over destination for colors already multiplied by their alpha.
+         */
+        static const RBlendState* premultiplied();
+
+        /**
+         * Source added to destination, for particles and lights.
+         */
+        static const RBlendState* additive();
+
+        Id getId() const;
+        const Desc& getDesc() const;
+
+    private:
+        template <typename T>
+        friend class RStateRegistry;
+
+        RBlendState(Id id, const Desc& desc);
+
+        Id _id;
+        Desc _desc;
+    };
+}
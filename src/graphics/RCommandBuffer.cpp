@@ -0,0 +1,180 @@
+#include "common.h"
+#include "RCommandBuffer.h"
+
+namespace rocket
+{
+    static RLinearArena* newOwnedArena(size_t capacity)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        return new RLinearArena(capacity);
+    }
+
+    RCommandBuffer::RCommandBuffer(RLinearArena* arena, uint32_t chunkSize) :
+        _ownedArena(arena ? nullptr : newOwnedArena(chunkSize * 4)),
+        _arena(arena ? arena : _ownedArena.get()),
+        _chunkSize(std::max<uint32_t>(chunkSize, 256)),
+        _first(nullptr),
+        _last(nullptr),
+        _count(0),
+        _size(0)
+    {
+        static_assert(sizeof(Chunk) <= detail::CHUNK_HEADER_SIZE, "The chunk header must fit before the first command");
+    }
+
+    RCommandBuffer::~RCommandBuffer()
+    {
+    }
+
+    void* RCommandBuffer::allocateSlow(uint32_t size)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        uint32_t capacity = std::max(_chunkSize, detail::CHUNK_HEADER_SIZE + size);
+        Chunk* chunk = (Chunk*)_arena->allocate(capacity, 16);
+        chunk->next = nullptr;
+        chunk->used = detail::CHUNK_HEADER_SIZE + size;
+        chunk->capacity = capacity;
+        if (_last)
+        {
+            _last->next = chunk;
+        }
+        else
+        {
+            _first = chunk;
+        }
+        _last = chunk;
+        return (char*)chunk + detail::CHUNK_HEADER_SIZE;
+    }
+
+    void RCommandBuffer::setViewport(int32_t x, int32_t y, int32_t width, int32_t height)
+    {
+        RSetViewportCommand* command = push<RSetViewportCommand>();
+        command->x = x;
+        command->y = y;
+        command->width = width;
+        command->height = height;
+    }
+
+    void RCommandBuffer::clear(uint32_t flags, const RVector4& color, float depth, int32_t stencil)
+    {
+        RClearCommand* command = push<RClearCommand>();
+        command->flags = flags;
+        command->color[0] = color.x;
+        command->color[1] = color.y;
+        command->color[2] = color.z;
+        command->color[3] = color.w;
+        command->depth = depth;
+        command->stencil = stencil;
+    }
+
+    void RCommandBuffer::bindFramebuffer(uint32_t framebuffer)
+    {
+        push<RBindFramebufferCommand>()->framebuffer = framebuffer;
+    }
+
+    void RCommandBuffer::bindProgram(uint32_t program)
+    {
+        push<RBindProgramCommand>()->program = program;
+    }
+
+    void RCommandBuffer::bindVertexArray(uint32_t vertexArray)
+    {
+        push<RBindVertexArrayCommand>()->vertexArray = vertexArray;
+    }
+
+    void RCommandBuffer::bindVertexBuffer(uint32_t binding, uint32_t buffer, uint32_t offset, uint32_t stride)
+    {
+        RBindVertexBufferCommand* command = push<RBindVertexBufferCommand>();
+        command->binding = binding;
+        command->buffer = buffer;
+        command->offset = offset;
+        command->stride = stride;
+    }
+
+    void RCommandBuffer::bindIndexBuffer(uint32_t buffer)
+    {
+        push<RBindIndexBufferCommand>()->buffer = buffer;
+    }
+
+    void RCommandBuffer::bindTexture(uint32_t unit, RBindTextureCommand::Dimension dimension, uint32_t texture)
+    {
+        RBindTextureCommand* command = push<RBindTextureCommand>();
+        command->unit = unit;
+        command->dimension = dimension;
+        command->texture = texture;
+    }
+
+    void RCommandBuffer::bindUniformBuffer(uint32_t index, uint32_t buffer, uint32_t offset, uint32_t range)
+    {
+        RBindUniformBufferCommand* command = push<RBindUniformBufferCommand>();
+        command->index = index;
+        command->buffer = buffer;
+        command->offset = offset;
+        command->range = range;
+    }
+
+    void RCommandBuffer::bindBlendState(const RBlendState* state)
+    {
+        push<RBindBlendStateCommand>()->state = state->getId();
+    }
+
+    void RCommandBuffer::bindCullState(const RCullState* state)
+    {
+        push<RBindCullStateCommand>()->state = state->getId();
+    }
+
+    void RCommandBuffer::draw(RPrimitive primitive, uint32_t vertexCount, uint32_t firstVertex,
+                              uint32_t instanceCount, uint32_t baseInstance)
+    {
+        RDrawCommand* command = push<RDrawCommand>();
+        command->primitive = primitive;
+        command->vertexCount = vertexCount;
+        command->instanceCount = instanceCount;
+        command->firstVertex = firstVertex;
+        command->baseInstance = baseInstance;
+    }
+
+    void RCommandBuffer::drawIndexed(RPrimitive primitive, bool index32, uint32_t indexCount, uint32_t firstIndex,
+                                     int32_t baseVertex, uint32_t instanceCount, uint32_t baseInstance)
+    {
+        RDrawIndexedCommand* command = push<RDrawIndexedCommand>();
+        command->primitive = primitive;
+        command->index32 = index32;
+        command->indexCount = indexCount;
+        command->instanceCount = instanceCount;
+        command->firstIndex = firstIndex;
+        command->baseVertex = baseVertex;
+        command->baseInstance = baseInstance;
+    }
+
+    void RCommandBuffer::reset()
+    {
+        _first = nullptr;
+        _last = nullptr;
+        _count = 0;
+        _size = 0;
+        if (_ownedArena)
+        {
+            _ownedArena->reset();
+        }
+    }
+
+    size_t RCommandBuffer::getCommandCount() const
+    {
+        return _count;
+    }
+
+    size_t RCommandBuffer::getSize() const
+    {
+        return _size;
+    }
+
+    RCommandBuffer::Iterator RCommandBuffer::begin() const
+    {
+        return Iterator(_first);
+    }
+
+    RCommandBuffer::Iterator RCommandBuffer::end() const
+    {
+        return Iterator(nullptr);
+    }
+}
@@ -0,0 +1,292 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * The primitive a draw command assembles.
+     */
+    enum RPrimitive : uint8_t
+    {
+        PRIMITIVE_POINTS,
+        PRIMITIVE_LINES,
+        PRIMITIVE_LINE_STRIP,
+        PRIMITIVE_TRIANGLES,
+        PRIMITIVE_TRIANGLE_STRIP
+    };
+
+    /**
+     * Defines the header every recorded command starts with.
+     *
+     * Commands are plain structs deriving from RCommand with a static TYPE.
+     * They hold no pointers to owned memory and no destructors, so a command
+     * buffer is just bytes that can be copied, replayed or thrown away. Resources
+     * are referred to by the backend's names (for OpenGL, the GL object names).
+     */
+    struct RCommand
+    {
+        enum Type : uint16_t
+        {
+            SET_VIEWPORT,
+            CLEAR,
+            BIND_FRAMEBUFFER,
+            BIND_PROGRAM,
+            BIND_VERTEX_ARRAY,
+            BIND_VERTEX_BUFFER,
+            BIND_INDEX_BUFFER,
+            BIND_TEXTURE,
+            BIND_UNIFORM_BUFFER,
+            BIND_BLEND_STATE,
+            BIND_CULL_STATE,
+            DRAW,
+            DRAW_INDEXED,
+            TYPE_COUNT
+        };
+
+        Type type;
+        // The size of the whole command in bytes, header included.
+        uint16_t size;
+
+        /**
+         * Returns the command as the struct of its type.
+         */
+        template <typename T>
+        const T& as() const;
+    };
+
+    struct RSetViewportCommand : RCommand
+    {
+        static const Type TYPE = SET_VIEWPORT;
+        int32_t x;
+        int32_t y;
+        int32_t width;
+        int32_t height;
+    };
+
+    struct RClearCommand : RCommand
+    {
+        static const Type TYPE = CLEAR;
+
+        enum Flags : uint32_t
+        {
+            COLOR = 1,
+            DEPTH = 2,
+            STENCIL = 4
+        };
+
+        uint32_t flags;
+        float color[4];
+        float depth;
+        int32_t stencil;
+    };
+
+    struct RBindFramebufferCommand : RCommand
+    {
+        static const Type TYPE = BIND_FRAMEBUFFER;
+        uint32_t framebuffer;
+    };
+
+    struct RBindProgramCommand : RCommand
+    {
+        static const Type TYPE = BIND_PROGRAM;
+        uint32_t program;
+    };
+
+    struct RBindVertexArrayCommand : RCommand
+    {
+        static const Type TYPE = BIND_VERTEX_ARRAY;
+        uint32_t vertexArray;
+    };
+
+    struct RBindVertexBufferCommand : RCommand
+    {
+        static const Type TYPE = BIND_VERTEX_BUFFER;
+        uint32_t binding;
+        uint32_t buffer;
+        uint32_t offset;
+        uint32_t stride;
+    };
+
+    struct RBindIndexBufferCommand : RCommand
+    {
+        static const Type TYPE = BIND_INDEX_BUFFER;
+        uint32_t buffer;
+    };
+
+    struct RBindTextureCommand : RCommand
+    {
+        static const Type TYPE = BIND_TEXTURE;
+
+        enum Dimension : uint32_t
+        {
+            TEXTURE_2D,
+            TEXTURE_3D,
+            TEXTURE_CUBE
+        };
+
+        uint32_t unit;
+        Dimension dimension;
+        uint32_t texture;
+    };
+
+    struct RBindUniformBufferCommand : RCommand
+    {
+        static const Type TYPE = BIND_UNIFORM_BUFFER;
+        uint32_t index;
+        uint32_t buffer;
+        uint32_t offset;
+        uint32_t range;
+    };
+
+    struct RBindBlendStateCommand : RCommand
+    {
+        static const Type TYPE = BIND_BLEND_STATE;
+        // The id of an RBlendState.
+        uint32_t state;
+    };
+
+    struct RBindCullStateCommand : RCommand
+    {
+        static const Type TYPE = BIND_CULL_STATE;
+        // The id of an RCullState.
+        uint32_t state;
+    };
+
+    struct RDrawCommand : RCommand
+    {
+        static const Type TYPE = DRAW;
+        RPrimitive primitive;
+        uint32_t vertexCount;
+        uint32_t instanceCount;
+        uint32_t firstVertex;
+        uint32_t baseInstance;
+    };
+
+    struct RDrawIndexedCommand : RCommand
+    {
+        static const Type TYPE = DRAW_INDEXED;
+        RPrimitive primitive;
+        // true for 32-bit indices, false for 16-bit.
+        bool index32;
+        uint32_t indexCount;
+        uint32_t instanceCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t baseInstance;
+    };
+
+    /**
+     * Defines a list of rendering commands recorded for later submission.
+     *
+     * Recording only appends small structs to chunks of arena memory, so it
+     * never calls into the graphics API and can happen on any thread. A buffer
+     * is not thread-safe: each thread records its own, and one thread submits
+     * them to an RRenderBackend in the order they should execute.
+     *
+     * The chunks come from the arena passed to the constructor, for example the
+     * calling thread's arena in REngine::getFrameArena(), or from an arena the
+     * buffer owns. Resetting an external arena invalidates the commands, so
+     * reset() the buffer along with it.
+     */
+    class API RCommandBuffer
+    {
+    public:
+        /**
+         * The default size of the chunks commands are written to, in bytes.
+         */
+        static const uint32_t DEFAULT_CHUNK_SIZE = 16 * 1024;
+
+        /**
+         * Walks the commands in the order they were recorded.
+         */
+        class Iterator
+        {
+        public:
+            inline const RCommand& operator*() const;
+            inline const RCommand* operator->() const;
+            inline Iterator& operator++();
+            inline bool operator==(const Iterator& other) const;
+            inline bool operator!=(const Iterator& other) const;
+
+        private:
+            friend class RCommandBuffer;
+            inline Iterator(const void* chunk);
+
+            const void* _chunk;
+            uint32_t _offset;
+        };
+
+        /**
+         * Constructs an empty command buffer.
+         *
+         * @param arena The arena to record into, or null for the buffer to own one.
+         * @param chunkSize The size of each chunk of commands, in bytes.
+         */
+        explicit RCommandBuffer(RLinearArena* arena = nullptr, uint32_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+        ~RCommandBuffer();
+
+        RCommandBuffer(const RCommandBuffer&) = delete;
+        RCommandBuffer& operator=(const RCommandBuffer&) = delete;
+
+        /**
+         * Appends an uninitialized command of type T with its header filled in.
+         */
+        template <typename T>
+        inline T* push();
+
+        void setViewport(int32_t x, int32_t y, int32_t width, int32_t height);
+        void clear(uint32_t flags, const RVector4& color, float depth = 1.0f, int32_t stencil = 0);
+        void bindFramebuffer(uint32_t framebuffer);
+        void bindProgram(uint32_t program);
+        void bindVertexArray(uint32_t vertexArray);
+        void bindVertexBuffer(uint32_t binding, uint32_t buffer, uint32_t offset, uint32_t stride);
+        void bindIndexBuffer(uint32_t buffer);
+        void bindTexture(uint32_t unit, RBindTextureCommand::Dimension dimension, uint32_t texture);
+        void bindUniformBuffer(uint32_t index, uint32_t buffer, uint32_t offset, uint32_t range);
+        void bindBlendState(const RBlendState* state);
+        void bindCullState(const RCullState* state);
+        void draw(RPrimitive primitive, uint32_t vertexCount, uint32_t firstVertex = 0,
+                  uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+        void drawIndexed(RPrimitive primitive, bool index32, uint32_t indexCount, uint32_t firstIndex = 0,
+                         int32_t baseVertex = 0, uint32_t instanceCount = 1, uint32_t baseInstance = 0);
+
+        /**
+         * Removes every command, and resets the arena if the buffer owns it.
+         */
+        void reset();
+
+        /**
+         * Returns the number of commands recorded.
+         */
+        size_t getCommandCount() const;
+
+        /**
+         * Returns the number of bytes the commands take up.
+         */
+        size_t getSize() const;
+
+        Iterator begin() const;
+        Iterator end() const;
+
+    private:
+        struct Chunk
+        {
+            Chunk* next;
+            uint32_t used;
+            uint32_t capacity;
+        };
+
+        void* allocateSlow(uint32_t size);
+
+        std::unique_ptr<RLinearArena> _ownedArena;
+        RLinearArena* _arena;
+        uint32_t _chunkSize;
+        Chunk* _first;
+        Chunk* _last;
+        size_t _count;
+        size_t _size;
+    };
+}
+
+#include "RCommandBuffer.inl"
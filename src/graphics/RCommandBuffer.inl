@@ -0,0 +1,85 @@
+#include "RCommandBuffer.h"
+
+namespace rocket
+{
+    namespace detail
+    {
+        // Every command starts on this boundary within its chunk.
+        const uint32_t COMMAND_ALIGNMENT = 8;
+
+        // The chunk header, rounded so the first command is aligned.
+        const uint32_t CHUNK_HEADER_SIZE = 16;
+    }
+
+    template <typename T>
+    const T& RCommand::as() const
+    {
+        return static_cast<const T&>(*this);
+    }
+
+    inline RCommandBuffer::Iterator::Iterator(const void* chunk) :
+        _chunk(chunk),
+        _offset(detail::CHUNK_HEADER_SIZE)
+    {
+    }
+
+    inline const RCommand& RCommandBuffer::Iterator::operator*() const
+    {
+        return *reinterpret_cast<const RCommand*>((const char*)_chunk + _offset);
+    }
+
+    inline const RCommand* RCommandBuffer::Iterator::operator->() const
+    {
+        return reinterpret_cast<const RCommand*>((const char*)_chunk + _offset);
+    }
+
+    inline RCommandBuffer::Iterator& RCommandBuffer::Iterator::operator++()
+    {
+        const Chunk* chunk = (const Chunk*)_chunk;
+        _offset += (**this).size;
+        if (_offset >= chunk->used)
+        {
+            _chunk = chunk->next;
+            _offset = detail::CHUNK_HEADER_SIZE;
+        }
+        return *this;
+    }
+
+    inline bool RCommandBuffer::Iterator::operator==(const Iterator& other) const
+    {
+        return _chunk == other._chunk && (_chunk == nullptr || _offset == other._offset);
+    }
+
+    inline bool RCommandBuffer::Iterator::operator!=(const Iterator& other) const
+    {
+        return !(*this == other);
+    }
+
+    template <typename T>
+    inline T* RCommandBuffer::push()
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Commands must be plain data");
+        static_assert(alignof(T) <= detail::COMMAND_ALIGNMENT, "Commands must not need more than 8-byte alignment");
+        const uint32_t size = (sizeof(T) + detail::COMMAND_ALIGNMENT - 1) & ~(detail::COMMAND_ALIGNMENT - 1);
+
+        void* memory;
+        if (_last && _last->used + size <= _last->capacity)
+        {
+            memory = (char*)_last + _last->used;
+            _last->used += size;
+        }
+        else
+        {
+            memory = allocateSlow(size);
+        }
+        ++_count;
+        _size += size;
+
+        // Filled in through the base so a command's own fields cannot shadow the header.
+        T* command = reinterpret_cast<T*>(memory);
+        RCommand* header = command;
+        header->type = T::TYPE;
+        header->size = (uint16_t)size;
+        return command;
+    }
+}
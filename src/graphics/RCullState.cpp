@@ -0,0 +1,85 @@
+#include "common.h"
+#include "RCullState.h"
+#include "RStateRegistry.h"
+
+namespace rocket
+{
+    namespace
+    {
+        RStateRegistry<RCullState>& getRegistry()
+        {
+            static RStateRegistry<RCullState> registry;
+            // Interned first, so the default state is id 0.
+            static const RCullState* defaultState = registry.intern(RCullState::Desc());
+            (void)defaultState;
+            return registry;
+        }
+
+        const RCullState* createCull(RCullState::Mode mode)
+        {
+            RCullState::Desc desc;
+            desc.mode = mode;
+            return RCullState::create(desc);
+        }
+    }
+
+    RCullState::Desc::Desc() :
+        mode(BACK),
+        frontFace(COUNTER_CLOCKWISE)
+    {
+    }
+
+    uint64_t RCullState::Desc::pack() const
+    {
+        // With culling off the winding does not matter.
+        return mode == NONE ? 0 : (uint64_t)mode | (uint64_t)frontFace << 8;
+    }
+
+    RCullState::RCullState(Id id, const Desc& desc) :
+        _id(id),
+        _desc(desc)
+    {
+    }
+
+    const RCullState* RCullState::create(const Desc& desc)
+    {
+        return getRegistry().intern(desc);
+    }
+
+    const RCullState* RCullState::get(Id id)
+    {
+        return getRegistry().get(id);
+    }
+
+    unsigned int RCullState::getCount()
+    {
+        return getRegistry().getCount();
+    }
+
+    const RCullState* RCullState::back()
+    {
+        return get(0);
+    }
+
+    const RCullState* RCullState::front()
+    {
+        static const RCullState* state = createCull(FRONT);
+        return state;
+    }
+
+    const RCullState* RCullState::none()
+    {
+        static const RCullState* state = createCull(NONE);
+        return state;
+    }
+
+    RCullState::Id RCullState::getId() const
+    {
+        return _id;
+    }
+
+    const RCullState::Desc& RCullState::getDesc() const
+    {
+        return _desc;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines an immutable face culling state.
+     *
+     * Interned like RBlendState: one object per distinct description, identified
+     * by a small id. The default description, culling back faces with
+     * counter-clockwise front faces, always has id 0.
+     */
+    class API RCullState
+    {
+    public:
+        typedef uint16_t Id;
+
+        enum Mode : uint8_t
+        {
+            NONE,
+            FRONT,
+            BACK,
+            FRONT_AND_BACK
+        };
+
+        enum Winding : uint8_t
+        {
+            COUNTER_CLOCKWISE,
+            CLOCKWISE
+        };
+
+        /**
+         * Describes a cull state. Defaults to culling back faces, with counter-clockwise front faces.
+         */
+        struct Desc
+        {
+            Mode mode;
+            Winding frontFace;
+
+            Desc();
+
+            /**
+             * Returns the description as one integer; equal descriptions pack equally.
+             */
+            uint64_t pack() const;
+        };
+
+        /**
+         * Returns the state with a description, creating it on first use.
+         *
+         * @return The state, or null if RStateRegistry::MAX_STATES states already exist.
+         */
+        static const RCullState* create(const Desc& desc);
+
+        /**
+         * Returns the state with an id, or null.
+         */
+        static const RCullState* get(Id id);
+
+        /**
+         * Returns the number of distinct cull states created.
+         */
+        static unsigned int getCount();
+
+        /**
+         * Culls back faces.
+         */
+        static const RCullState* back();
+
+        /**
+         * Culls front faces, for the inside of skyboxes and light volumes.
+         */
+        static const RCullState* front();
+
+        /**
+         * Culls nothing, for double-sided geometry.
+         */
+        static const RCullState* none();
+
+        Id getId() const;
+        const Desc& getDesc() const;
+
+    private:
+        template <typename T>
+        friend class RStateRegistry;
+
+        RCullState(Id id, const Desc& desc);
+
+        Id _id;
+        Desc _desc;
+    };
+}
@@ -0,0 +1,228 @@
+#include "common.h"
+#include "RDrawList.h"
+
+namespace rocket
+{
+    namespace
+    {
+        const unsigned int TRANSLUCENT_SHIFT = 64 - RSortKey::LAYER_BITS - 1;
+        const unsigned int LAYER_SHIFT = TRANSLUCENT_SHIFT + 1;
+
+        // Opaque: pipeline, material, mesh, depth.
+        const unsigned int OPAQUE_PIPELINE_SHIFT = TRANSLUCENT_SHIFT - RSortKey::PIPELINE_BITS;
+        const unsigned int OPAQUE_MATERIAL_SHIFT = OPAQUE_PIPELINE_SHIFT - RSortKey::MATERIAL_BITS;
+        const unsigned int OPAQUE_MESH_SHIFT = OPAQUE_MATERIAL_SHIFT - RSortKey::MESH_BITS;
+        const unsigned int OPAQUE_DEPTH_SHIFT = OPAQUE_MESH_SHIFT - RSortKey::OPAQUE_DEPTH_BITS;
+
+        // Translucent: inverted depth, pipeline, material.
+        const unsigned int TRANSLUCENT_DEPTH_SHIFT = TRANSLUCENT_SHIFT - RSortKey::TRANSLUCENT_DEPTH_BITS;
+        const unsigned int TRANSLUCENT_PIPELINE_SHIFT = TRANSLUCENT_DEPTH_SHIFT - RSortKey::PIPELINE_BITS;
+        const unsigned int TRANSLUCENT_MATERIAL_SHIFT = TRANSLUCENT_PIPELINE_SHIFT - RSortKey::MATERIAL_BITS;
+
+        static_assert(OPAQUE_DEPTH_SHIFT < 64 && TRANSLUCENT_MATERIAL_SHIFT < 64, "Sort key fields must fit in 64 bits");
+
+        inline uint64_t field(uint64_t value, unsigned int bits, unsigned int shift)
+        {
+            return (value & ((1ull << bits) - 1)) << shift;
+        }
+
+        inline uint32_t extract(uint64_t key, unsigned int bits, unsigned int shift)
+        {
+            return (uint32_t)((key >> shift) & ((1ull << bits) - 1));
+        }
+
+        inline uint64_t quantize(float depth, unsigned int bits)
+        {
+            float max = (float)((1u << bits) - 1);
+            return (uint64_t)(MATH_CLAMP(depth, 0.0f, 1.0f) * max);
+        }
+
+        const uint32_t UNBOUND = 0xFFFFFFFFu;
+    }
+
+    uint64_t RSortKey::opaque(unsigned int layer, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth)
+    {
+        return field(layer, LAYER_BITS, LAYER_SHIFT) |
+               field(pipeline, PIPELINE_BITS, OPAQUE_PIPELINE_SHIFT) |
+               field(material, MATERIAL_BITS, OPAQUE_MATERIAL_SHIFT) |
+               field(mesh, MESH_BITS, OPAQUE_MESH_SHIFT) |
+               field(quantize(depth, OPAQUE_DEPTH_BITS), OPAQUE_DEPTH_BITS, OPAQUE_DEPTH_SHIFT);
+    }
+
+    uint64_t RSortKey::translucent(unsigned int layer, float depth, uint32_t pipeline, uint32_t material)
+    {
+        uint64_t far = (1ull << TRANSLUCENT_DEPTH_BITS) - 1;
+        return field(layer, LAYER_BITS, LAYER_SHIFT) |
+               (1ull << TRANSLUCENT_SHIFT) |
+               field(far - quantize(depth, TRANSLUCENT_DEPTH_BITS), TRANSLUCENT_DEPTH_BITS, TRANSLUCENT_DEPTH_SHIFT) |
+               field(pipeline, PIPELINE_BITS, TRANSLUCENT_PIPELINE_SHIFT) |
+               field(material, MATERIAL_BITS, TRANSLUCENT_MATERIAL_SHIFT);
+    }
+
+    unsigned int RSortKey::getLayer(uint64_t key)
+    {
+        return extract(key, LAYER_BITS, LAYER_SHIFT);
+    }
+
+    bool RSortKey::isTranslucent(uint64_t key)
+    {
+        return ((key >> TRANSLUCENT_SHIFT) & 1) != 0;
+    }
+
+    uint32_t RSortKey::getPipeline(uint64_t key)
+    {
+        return isTranslucent(key) ? extract(key, PIPELINE_BITS, TRANSLUCENT_PIPELINE_SHIFT)
+                                  : extract(key, PIPELINE_BITS, OPAQUE_PIPELINE_SHIFT);
+    }
+
+    uint32_t RSortKey::getMaterial(uint64_t key)
+    {
+        return isTranslucent(key) ? extract(key, MATERIAL_BITS, TRANSLUCENT_MATERIAL_SHIFT)
+                                  : extract(key, MATERIAL_BITS, OPAQUE_MATERIAL_SHIFT);
+    }
+
+    RDrawList::RDrawList() :
+        _stats()
+    {
+    }
+
+    void RDrawList::add(uint64_t key, const RDrawPacket& packet)
+    {
+        RSortItem item;
+        item.key = key;
+        item.index = (uint32_t)_packets.size();
+        if (_packets.size() == _packets.capacity())
+        {
+            // Grown by reserve(), under the graphics tag, rather than by push_back.
+            reserve(std::max<size_t>(64, _packets.capacity() * 2));
+        }
+        _items.push_back(item);
+        _packets.push_back(packet);
+    }
+
+    void RDrawList::reserve(size_t count)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        _packets.reserve(count);
+        _items.reserve(count);
+        _scratch.reserve(count);
+    }
+
+    void RDrawList::sort(RJobSystem* jobs)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        _scratch.resize(_items.size());
+        RRadixSort::sort(_items.data(), _scratch.data(), _items.size(), jobs);
+    }
+
+    void RDrawList::record(RCommandBuffer& buffer)
+    {
+        RDrawListStats stats = {};
+        uint32_t program = UNBOUND;
+        uint32_t blendState = UNBOUND;
+        uint32_t cullState = UNBOUND;
+        uint32_t vertexArray = UNBOUND;
+        uint32_t texture = UNBOUND;
+        uint32_t uniformBuffer = UNBOUND;
+        uint32_t uniformOffset = UNBOUND;
+        uint32_t uniformRange = UNBOUND;
+
+        for (size_t i = 0; i < _items.size(); ++i)
+        {
+            const RDrawPacket& packet = _packets[_items[i].index];
+            if (packet.program != program)
+            {
+                buffer.bindProgram(packet.program);
+                program = packet.program;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+            if (packet.blendState != blendState)
+            {
+                buffer.bindBlendState(RBlendState::get(packet.blendState));
+                blendState = packet.blendState;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+            if (packet.cullState != cullState)
+            {
+                buffer.bindCullState(RCullState::get(packet.cullState));
+                cullState = packet.cullState;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+            if (packet.vertexArray != vertexArray)
+            {
+                buffer.bindVertexArray(packet.vertexArray);
+                vertexArray = packet.vertexArray;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+            if (packet.texture != texture)
+            {
+                buffer.bindTexture(0, RBindTextureCommand::TEXTURE_2D, packet.texture);
+                texture = packet.texture;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+            if (packet.uniformBuffer != uniformBuffer || packet.uniformOffset != uniformOffset || packet.uniformRange != uniformRange)
+            {
+                buffer.bindUniformBuffer(0, packet.uniformBuffer, packet.uniformOffset, packet.uniformRange);
+                uniformBuffer = packet.uniformBuffer;
+                uniformOffset = packet.uniformOffset;
+                uniformRange = packet.uniformRange;
+                ++stats.binds;
+            }
+            else
+            {
+                ++stats.skippedBinds;
+            }
+
+            buffer.drawIndexed(packet.primitive, packet.index32, packet.indexCount, packet.firstIndex,
+                               packet.baseVertex, packet.instanceCount, packet.baseInstance);
+            ++stats.draws;
+        }
+        _stats = stats;
+    }
+
+    void RDrawList::clear()
+    {
+        _packets.clear();
+        _items.clear();
+    }
+
+    size_t RDrawList::getCount() const
+    {
+        return _items.size();
+    }
+
+    const RDrawPacket& RDrawList::getSorted(size_t index) const
+    {
+        return _packets[_items[index].index];
+    }
+
+    uint64_t RDrawList::getSortedKey(size_t index) const
+    {
+        return _items[index].key;
+    }
+
+    const RDrawListStats& RDrawList::getStats() const
+    {
+        return _stats;
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "../common.h"
+#include "RBlendState.h"
+#include "RCullState.h"
+#include "RCommandBuffer.h"
+#include "../utilities/RRadixSort.h"
+
+namespace rocket
+{
+    /**
+     * Defines the 64-bit keys draws are sorted by.
+     *
+     * From the most significant bit down, a key holds the layer and a
+     * translucency bit, so layers draw in order and translucent draws come after
+     * opaque ones within a layer. Opaque draws then sort by pipeline (the shader
+     * with its blend and cull state), material and mesh, so that consecutive
+     * draws share as much state as possible, with a coarse front-to-back depth
+     * last to break ties. Translucent draws must blend back to front, so their
+     * depth comes first, inverted, followed by pipeline and material.
+     *
+     * Ids wider than their field are truncated; callers assign small dense ids.
+     */
+    class API RSortKey
+    {
+    public:
+        static const unsigned int LAYER_BITS = 4;
+        static const unsigned int PIPELINE_BITS = 14;
+        static const unsigned int MATERIAL_BITS = 16;
+        static const unsigned int MESH_BITS = 12;
+        static const unsigned int OPAQUE_DEPTH_BITS = 17;
+        static const unsigned int TRANSLUCENT_DEPTH_BITS = 24;
+
+        /**
+         * Returns the key of an opaque draw.
+         *
+         * @param layer The layer, drawn in increasing order.
+         * @param pipeline The pipeline id.
+         * @param material The material id.
+         * @param mesh The mesh id.
+         * @param depth The view depth normalized to [0, 1].
+         */
+        static uint64_t opaque(unsigned int layer, uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+
+        /**
+         * Returns the key of a translucent draw.
+         *
+         * @param layer The layer, drawn in increasing order.
+         * @param depth The view depth normalized to [0, 1].
+         * @param pipeline The pipeline id.
+         * @param material The material id.
+         */
+        static uint64_t translucent(unsigned int layer, float depth, uint32_t pipeline, uint32_t material);
+
+        static unsigned int getLayer(uint64_t key);
+        static bool isTranslucent(uint64_t key);
+        static uint32_t getPipeline(uint64_t key);
+        static uint32_t getMaterial(uint64_t key);
+    };
+
+    /**
+     * Defines everything needed to record one draw.
+     */
+    struct RDrawPacket
+    {
+        uint32_t program;
+        // Ids of the RBlendState and RCullState; 0 is the default of each.
+        RBlendState::Id blendState;
+        RCullState::Id cullState;
+        uint32_t vertexArray;
+        // The material's texture (unit 0) and constants (uniform block 0).
+        uint32_t texture;
+        uint32_t uniformBuffer;
+        uint32_t uniformOffset;
+        uint32_t uniformRange;
+        RPrimitive primitive;
+        bool index32;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t baseVertex;
+        uint32_t instanceCount;
+        uint32_t baseInstance;
+    };
+
+    /**
+     * Defines what recording a draw list emitted.
+     */
+    struct RDrawListStats
+    {
+        uint64_t draws;
+        uint64_t binds;
+        uint64_t skippedBinds;
+    };
+
+    /**
+     * Defines a list of draws that is sorted by key before it is recorded.
+     *
+     * Draws are added in any order with their sort key. sort() orders
+     * key/index pairs with RRadixSort, leaving the packets where they are, and
+     * record() walks the packets in key order into a command buffer, emitting a
+     * bind only when the state differs from the previous draw's. Clearing the
+     * list keeps its memory, so a list reused every frame stops allocating.
+     */
+    class API RDrawList
+    {
+    public:
+        RDrawList();
+
+        /**
+         * Adds a draw.
+         */
+        void add(uint64_t key, const RDrawPacket& packet);
+
+        /**
+         * Reserves memory for a number of draws.
+         */
+        void reserve(size_t count);
+
+        /**
+         * Sorts the draws by key; draws with equal keys keep the order they were added in.
+         *
+         * @param jobs The job system to sort large lists on, or null to sort on the calling thread.
+         */
+        void sort(RJobSystem* jobs = nullptr);
+
+        /**
+         * Records the draws in sorted order, skipping redundant binds.
+         *
+         * Binds are tracked from the start of each call, so the first draw binds all its state.
+         */
+        void record(RCommandBuffer& buffer);
+
+        /**
+         * Removes every draw.
+         */
+        void clear();
+
+        /**
+         * Returns the number of draws.
+         */
+        size_t getCount() const;
+
+        /**
+         * Returns the draw at a position in the sorted order.
+         */
+        const RDrawPacket& getSorted(size_t index) const;
+
+        /**
+         * Returns the key of the draw at a position in the sorted order.
+         */
+        uint64_t getSortedKey(size_t index) const;
+
+        /**
+         * Returns what the last call to record() emitted.
+         */
+        const RDrawListStats& getStats() const;
+
+    private:
+        std::vector<RDrawPacket> _packets;
+        std::vector<RSortItem> _items;
+        std::vector<RSortItem> _scratch;
+        RDrawListStats _stats;
+    };
+}
@@ -0,0 +1,168 @@
+#include "common.h"
+#include "RGLBackend.h"
+
+namespace rocket
+{
+    namespace
+    {
+        const GLenum PRIMITIVES[] =
+        {
+            GL_POINTS,
+            GL_LINES,
+            GL_LINE_STRIP,
+            GL_TRIANGLES,
+            GL_TRIANGLE_STRIP
+        };
+
+        const GLenum TEXTURE_TARGETS[] =
+        {
+            GL_TEXTURE_2D,
+            GL_TEXTURE_3D,
+            GL_TEXTURE_CUBE_MAP
+        };
+    }
+
+    RGLBackend::RGLBackend() :
+        _metrics(nullptr),
+        _issuedMetric(RMetrics::INVALID),
+        _elidedMetric(RMetrics::INVALID)
+    {
+    }
+
+    void RGLBackend::submit(const RCommandBuffer& buffer)
+    {
+        RRenderStats stats = {};
+        uint64_t issued = _cache.getIssuedCount();
+        uint64_t elided = _cache.getElidedCount();
+        for (const RCommand& command : buffer)
+        {
+            switch (command.type)
+            {
+            case RCommand::SET_VIEWPORT:
+            {
+                const RSetViewportCommand& viewport = command.as<RSetViewportCommand>();
+                _cache.setViewport(viewport.x, viewport.y, viewport.width, viewport.height);
+                break;
+            }
+            case RCommand::CLEAR:
+            {
+                const RClearCommand& clear = command.as<RClearCommand>();
+                GLbitfield mask = 0;
+                // glClear obeys the write masks, so a clear must not inherit a draw's partial mask.
+                // Depth and stencil masks need the same treatment once states can set them.
+                if (clear.flags & RClearCommand::COLOR)
+                {
+                    _cache.setColorMask(RBlendState::ALL);
+                    glClearColor(clear.color[0], clear.color[1], clear.color[2], clear.color[3]);
+                    mask |= GL_COLOR_BUFFER_BIT;
+                }
+                if (clear.flags & RClearCommand::DEPTH)
+                {
+                    glClearDepth(clear.depth);
+                    mask |= GL_DEPTH_BUFFER_BIT;
+                }
+                if (clear.flags & RClearCommand::STENCIL)
+                {
+                    glClearStencil(clear.stencil);
+                    mask |= GL_STENCIL_BUFFER_BIT;
+                }
+                glClear(mask);
+                break;
+            }
+            case RCommand::BIND_FRAMEBUFFER:
+                _cache.bindFramebuffer(command.as<RBindFramebufferCommand>().framebuffer);
+                break;
+            case RCommand::BIND_PROGRAM:
+                _cache.useProgram(command.as<RBindProgramCommand>().program);
+                break;
+            case RCommand::BIND_VERTEX_ARRAY:
+                _cache.bindVertexArray(command.as<RBindVertexArrayCommand>().vertexArray);
+                break;
+            case RCommand::BIND_VERTEX_BUFFER:
+            {
+                const RBindVertexBufferCommand& bind = command.as<RBindVertexBufferCommand>();
+                glBindVertexBuffer(bind.binding, bind.buffer, (GLintptr)bind.offset, (GLsizei)bind.stride);
+                break;
+            }
+            case RCommand::BIND_INDEX_BUFFER:
+                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, command.as<RBindIndexBufferCommand>().buffer);
+                break;
+            case RCommand::BIND_TEXTURE:
+            {
+                const RBindTextureCommand& bind = command.as<RBindTextureCommand>();
+                _cache.bindTexture(bind.unit, TEXTURE_TARGETS[bind.dimension], bind.texture);
+                break;
+            }
+            case RCommand::BIND_UNIFORM_BUFFER:
+            {
+                const RBindUniformBufferCommand& bind = command.as<RBindUniformBufferCommand>();
+                _cache.bindUniformBuffer(bind.index, bind.buffer, (GLintptr)bind.offset, (GLsizeiptr)bind.range);
+                break;
+            }
+            case RCommand::BIND_BLEND_STATE:
+                _cache.setBlendState(RBlendState::get((RBlendState::Id)command.as<RBindBlendStateCommand>().state));
+                break;
+            case RCommand::BIND_CULL_STATE:
+                _cache.setCullState(RCullState::get((RCullState::Id)command.as<RBindCullStateCommand>().state));
+                break;
+            case RCommand::DRAW:
+            {
+                const RDrawCommand& draw = command.as<RDrawCommand>();
+                glDrawArraysInstancedBaseInstance(PRIMITIVES[draw.primitive], (GLint)draw.firstVertex,
+                                                  (GLsizei)draw.vertexCount, (GLsizei)draw.instanceCount, draw.baseInstance);
+                ++stats.drawCalls;
+                stats.instances += draw.instanceCount;
+                stats.triangles += getTriangleCount(draw.primitive, draw.vertexCount) * draw.instanceCount;
+                break;
+            }
+            case RCommand::DRAW_INDEXED:
+            {
+                const RDrawIndexedCommand& draw = command.as<RDrawIndexedCommand>();
+                size_t indexSize = draw.index32 ? 4 : 2;
+                glDrawElementsInstancedBaseVertexBaseInstance(PRIMITIVES[draw.primitive], (GLsizei)draw.indexCount,
+                                                              draw.index32 ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+                                                              (const void*)(draw.firstIndex * indexSize),
+                                                              (GLsizei)draw.instanceCount, draw.baseVertex, draw.baseInstance);
+                ++stats.drawCalls;
+                stats.instances += draw.instanceCount;
+                stats.triangles += getTriangleCount(draw.primitive, draw.indexCount) * draw.instanceCount;
+                break;
+            }
+            default:
+                break;
+            }
+        }
+        stats.commands = buffer.getCommandCount();
+        addStats(stats);
+        if (_metrics)
+        {
+            _metrics->add(_issuedMetric, (int64_t)(_cache.getIssuedCount() - issued));
+            _metrics->add(_elidedMetric, (int64_t)(_cache.getElidedCount() - elided));
+        }
+    }
+
+    const char* RGLBackend::getName() const
+    {
+        return "opengl";
+    }
+
+    void RGLBackend::setMetrics(RMetrics* metrics)
+    {
+        RRenderBackend::setMetrics(metrics);
+        _metrics = metrics;
+        if (_metrics)
+        {
+            _issuedMetric = _metrics->registerMetric("gl_calls_issued");
+            _elidedMetric = _metrics->registerMetric("gl_calls_elided");
+            if (_issuedMetric == RMetrics::INVALID || _elidedMetric == RMetrics::INVALID)
+            {
+                _metrics = nullptr;
+            }
+        }
+    }
+
+    RGLStateCache& RGLBackend::getStateCache()
+    {
+        return _cache;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "../common.h"
+#include "RRenderBackend.h"
+#include "ROpenGL.h"
+
+namespace rocket
+{
+    /**
+     * Defines a backend that executes command buffers with OpenGL 4.3 or later.
+     *
+     * Buffers must be submitted on the thread whose GL context is current.
+     * Vertex buffers are bound to the attribute format of the bound vertex
+     * array with glBindVertexBuffer.
+     *
+     * State changes go through an RGLStateCache, so binds that repeat the
+     * current state, within a buffer or across buffers and frames, never reach
+     * the driver. With metrics set, the calls made and filtered out are added
+     * to the gl_calls_issued and gl_calls_elided counters every submission.
+     */
+    class API RGLBackend : public RRenderBackend
+    {
+    public:
+        RGLBackend();
+
+        void submit(const RCommandBuffer& buffer) override;
+        const char* getName() const override;
+        void setMetrics(RMetrics* metrics) override;
+
+        /**
+         * Returns the state cache. Invalidate it after changing GL state outside the backend.
+         */
+        RGLStateCache& getStateCache();
+
+    private:
+        RGLStateCache _cache;
+        RMetrics* _metrics;
+        RMetrics::Id _issuedMetric;
+        RMetrics::Id _elidedMetric;
+    };
+}
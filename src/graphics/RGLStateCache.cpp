@@ -0,0 +1,283 @@
+#include "common.h"
+#include "RGLStateCache.h"
+
+namespace rocket
+{
+    namespace
+    {
+        // Shadow values no real call can set, so the next call always goes through.
+        const GLuint UNKNOWN = 0xFFFFFFFFu;
+        const uint8_t UNKNOWN_MASK = 0xFF;
+
+        const GLenum FACTORS[] =
+        {
+            GL_ZERO,
+            GL_ONE,
+            GL_SRC_COLOR,
+            GL_ONE_MINUS_SRC_COLOR,
+            GL_DST_COLOR,
+            GL_ONE_MINUS_DST_COLOR,
+            GL_SRC_ALPHA,
+            GL_ONE_MINUS_SRC_ALPHA,
+            GL_DST_ALPHA,
+            GL_ONE_MINUS_DST_ALPHA
+        };
+
+        const GLenum OPERATIONS[] =
+        {
+            GL_FUNC_ADD,
+            GL_FUNC_SUBTRACT,
+            GL_FUNC_REVERSE_SUBTRACT,
+            GL_MIN,
+            GL_MAX
+        };
+
+        const GLenum CULL_FACES[] =
+        {
+            GL_BACK,
+            GL_FRONT,
+            GL_BACK,
+            GL_FRONT_AND_BACK
+        };
+    }
+
+    RGLStateCache::RGLStateCache() :
+        _issued(0),
+        _elided(0)
+    {
+        invalidate();
+    }
+
+    void RGLStateCache::invalidate()
+    {
+        _program = UNKNOWN;
+        _vertexArray = UNKNOWN;
+        _framebuffer = UNKNOWN;
+        _activeTexture = UNKNOWN;
+        std::fill(_textures, _textures + MAX_TEXTURE_UNITS, UNKNOWN);
+        std::fill(_textureTargets, _textureTargets + MAX_TEXTURE_UNITS, UNKNOWN);
+        std::fill(_uniformBuffers, _uniformBuffers + MAX_UNIFORM_BUFFERS, UNKNOWN);
+        std::fill(_uniformOffsets, _uniformOffsets + MAX_UNIFORM_BUFFERS, -1);
+        std::fill(_uniformSizes, _uniformSizes + MAX_UNIFORM_BUFFERS, -1);
+        std::fill(_viewport, _viewport + 4, -1);
+
+        _blendState = nullptr;
+        _blendEnabled = -1;
+        std::fill(_blendFactors, _blendFactors + 4, UNKNOWN);
+        std::fill(_blendEquations, _blendEquations + 2, UNKNOWN);
+        _colorMask = UNKNOWN_MASK;
+
+        _cullState = nullptr;
+        _cullEnabled = -1;
+        _cullFace = UNKNOWN;
+        _frontFace = UNKNOWN;
+    }
+
+    template <typename T>
+    inline bool RGLStateCache::change(T& shadow, T value)
+    {
+        if (shadow == value)
+        {
+            ++_elided;
+            return false;
+        }
+        shadow = value;
+        ++_issued;
+        return true;
+    }
+
+    void RGLStateCache::setEnabled(GLenum capability, int& shadow, bool enabled)
+    {
+        if (change(shadow, enabled ? 1 : 0))
+        {
+            if (enabled)
+            {
+                glEnable(capability);
+            }
+            else
+            {
+                glDisable(capability);
+            }
+        }
+    }
+
+    void RGLStateCache::useProgram(GLuint program)
+    {
+        if (change(_program, program))
+        {
+            glUseProgram(program);
+        }
+    }
+
+    void RGLStateCache::bindVertexArray(GLuint vertexArray)
+    {
+        if (change(_vertexArray, vertexArray))
+        {
+            glBindVertexArray(vertexArray);
+        }
+    }
+
+    void RGLStateCache::bindFramebuffer(GLuint framebuffer)
+    {
+        if (change(_framebuffer, framebuffer))
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+    }
+
+    void RGLStateCache::bindTexture(unsigned int unit, GLenum target, GLuint texture)
+    {
+        if (unit >= MAX_TEXTURE_UNITS)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            glBindTexture(target, texture);
+            _activeTexture = unit;
+            _issued += 2;
+            return;
+        }
+
+        // A bind that changes nothing needs neither the unit selected nor the bind.
+        if (_textures[unit] == texture && _textureTargets[unit] == target)
+        {
+            _elided += 2;
+            return;
+        }
+        if (change(_activeTexture, (GLuint)unit))
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+        }
+        glBindTexture(target, texture);
+        _textures[unit] = texture;
+        _textureTargets[unit] = target;
+        ++_issued;
+    }
+
+    void RGLStateCache::bindUniformBuffer(unsigned int index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+    {
+        if (index < MAX_UNIFORM_BUFFERS)
+        {
+            if (_uniformBuffers[index] == buffer && _uniformOffsets[index] == offset && _uniformSizes[index] == size)
+            {
+                ++_elided;
+                return;
+            }
+            _uniformBuffers[index] = buffer;
+            _uniformOffsets[index] = offset;
+            _uniformSizes[index] = size;
+        }
+        glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+        ++_issued;
+    }
+
+    void RGLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (_viewport[0] == x && _viewport[1] == y && _viewport[2] == width && _viewport[3] == height)
+        {
+            ++_elided;
+            return;
+        }
+        _viewport[0] = x;
+        _viewport[1] = y;
+        _viewport[2] = width;
+        _viewport[3] = height;
+        glViewport(x, y, width, height);
+        ++_issued;
+    }
+
+    void RGLStateCache::setBlendState(const RBlendState* state)
+    {
+        const RBlendState::Desc& desc = state->getDesc();
+        if (state == _blendState)
+        {
+            // The enable, the mask and, when blending, the factors and equations.
+            _elided += desc.enabled ? 4 : 2;
+            return;
+        }
+        _blendState = state;
+
+        setEnabled(GL_BLEND, _blendEnabled, desc.enabled);
+        if (desc.enabled)
+        {
+            GLenum factors[4] = { FACTORS[desc.srcColor], FACTORS[desc.dstColor], FACTORS[desc.srcAlpha], FACTORS[desc.dstAlpha] };
+            if (std::equal(factors, factors + 4, _blendFactors))
+            {
+                ++_elided;
+            }
+            else
+            {
+                glBlendFuncSeparate(factors[0], factors[1], factors[2], factors[3]);
+                std::copy(factors, factors + 4, _blendFactors);
+                ++_issued;
+            }
+
+            GLenum equations[2] = { OPERATIONS[desc.colorOperation], OPERATIONS[desc.alphaOperation] };
+            if (std::equal(equations, equations + 2, _blendEquations))
+            {
+                ++_elided;
+            }
+            else
+            {
+                glBlendEquationSeparate(equations[0], equations[1]);
+                std::copy(equations, equations + 2, _blendEquations);
+                ++_issued;
+            }
+        }
+
+        if (change(_colorMask, desc.writeMask))
+        {
+            applyColorMask(desc.writeMask);
+        }
+    }
+
+    void RGLStateCache::setColorMask(uint8_t mask)
+    {
+        if (change(_colorMask, mask))
+        {
+            applyColorMask(mask);
+            // GL no longer has the bound blend state's mask, so binding it again must not be elided.
+            _blendState = nullptr;
+        }
+    }
+
+    void RGLStateCache::applyColorMask(uint8_t mask)
+    {
+        glColorMask((mask & RBlendState::RED) != 0, (mask & RBlendState::GREEN) != 0,
+                    (mask & RBlendState::BLUE) != 0, (mask & RBlendState::ALPHA) != 0);
+    }
+
+    void RGLStateCache::setCullState(const RCullState* state)
+    {
+        const RCullState::Desc& desc = state->getDesc();
+        bool enabled = desc.mode != RCullState::NONE;
+        if (state == _cullState)
+        {
+            // The enable and, when culling, the face and the winding.
+            _elided += enabled ? 3 : 1;
+            return;
+        }
+        _cullState = state;
+
+        setEnabled(GL_CULL_FACE, _cullEnabled, enabled);
+        if (enabled)
+        {
+            if (change(_cullFace, CULL_FACES[desc.mode]))
+            {
+                glCullFace(_cullFace);
+            }
+            if (change(_frontFace, desc.frontFace == RCullState::CLOCKWISE ? (GLenum)GL_CW : (GLenum)GL_CCW))
+            {
+                glFrontFace(_frontFace);
+            }
+        }
+    }
+
+    uint64_t RGLStateCache::getIssuedCount() const
+    {
+        return _issued;
+    }
+
+    uint64_t RGLStateCache::getElidedCount() const
+    {
+        return _elided;
+    }
+}
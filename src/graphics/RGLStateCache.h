@@ -0,0 +1,93 @@
+#pragma once
+#include "../common.h"
+#include "ROpenGL.h"
+#include "RBlendState.h"
+#include "RCullState.h"
+
+namespace rocket
+{
+    /**
+     * Defines a shadow copy of the OpenGL state that filters redundant calls.
+     *
+     * Every setter compares against the value it last sent and only calls GL
+     * when the value changes. Blend and cull states are compared by object
+     * first, then field by field, so switching between two blend states that
+     * share factors only issues the calls that differ. Redundant calls cost
+     * driver validation on the CPU even when the GPU state does not change.
+     *
+     * The cache starts out knowing nothing, so the first call of each kind
+     * always goes through. Call invalidate() after any code changes GL state
+     * behind the cache's back.
+     */
+    class API RGLStateCache
+    {
+    public:
+        static const unsigned int MAX_TEXTURE_UNITS = 32;
+        static const unsigned int MAX_UNIFORM_BUFFERS = 16;
+
+        RGLStateCache();
+
+        /**
+         * Forgets the shadowed state, so that the next call of each kind is issued.
+         */
+        void invalidate();
+
+        void useProgram(GLuint program);
+        void bindVertexArray(GLuint vertexArray);
+        void bindFramebuffer(GLuint framebuffer);
+        void bindTexture(unsigned int unit, GLenum target, GLuint texture);
+        void bindUniformBuffer(unsigned int index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+        void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        void setBlendState(const RBlendState* state);
+        void setCullState(const RCullState* state);
+
+        /**
+         * Sets the color write mask directly, for clears, which obey it like draws do.
+         *
+         * @param mask A combination of RBlendState::ColorMask bits.
+         */
+        void setColorMask(uint8_t mask);
+
+        /**
+         * Returns the number of GL calls made through the cache.
+         */
+        uint64_t getIssuedCount() const;
+
+        /**
+         * Returns the number of GL calls the cache filtered out.
+         */
+        uint64_t getElidedCount() const;
+
+    private:
+        template <typename T>
+        inline bool change(T& shadow, T value);
+
+        void setEnabled(GLenum capability, int& shadow, bool enabled);
+        void applyColorMask(uint8_t mask);
+
+        GLuint _program;
+        GLuint _vertexArray;
+        GLuint _framebuffer;
+        GLuint _activeTexture;
+        GLuint _textures[MAX_TEXTURE_UNITS];
+        GLenum _textureTargets[MAX_TEXTURE_UNITS];
+        GLuint _uniformBuffers[MAX_UNIFORM_BUFFERS];
+        GLintptr _uniformOffsets[MAX_UNIFORM_BUFFERS];
+        GLsizeiptr _uniformSizes[MAX_UNIFORM_BUFFERS];
+        GLint _viewport[4];
+
+        const RBlendState* _blendState;
+        int _blendEnabled;
+        GLenum _blendFactors[4];
+        GLenum _blendEquations[2];
+        uint8_t _colorMask;
+
+        const RCullState* _cullState;
+        int _cullEnabled;
+        GLenum _cullFace;
+        GLenum _frontFace;
+
+        uint64_t _issued;
+        uint64_t _elided;
+    };
+}
@@ -0,0 +1,108 @@
+#include "common.h"
+#include "RHeadlessContext.h"
+#ifdef ROCKET_HAS_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+namespace rocket
+{
+    RHeadlessContext::RHeadlessContext() :
+        _display(nullptr),
+        _context(nullptr)
+    {
+    }
+
+    RHeadlessContext::~RHeadlessContext()
+    {
+        destroy();
+    }
+
+#ifdef ROCKET_HAS_EGL
+    bool RHeadlessContext::create(int major, int minor)
+    {
+        destroy();
+
+        // Prefer the surfaceless platform, which needs neither X11 nor a DRM device.
+        EGLDisplay display = EGL_NO_DISPLAY;
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay)
+        {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (display == EGL_NO_DISPLAY)
+        {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+        {
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API))
+        {
+            eglTerminate(display);
+            return false;
+        }
+
+        const EGLint contextAttributes[] =
+        {
+            EGL_CONTEXT_MAJOR_VERSION, major,
+            EGL_CONTEXT_MINOR_VERSION, minor,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, contextAttributes);
+        if (context == EGL_NO_CONTEXT)
+        {
+            eglTerminate(display);
+            return false;
+        }
+
+        _display = display;
+        _context = context;
+        if (!makeCurrent())
+        {
+            destroy();
+            return false;
+        }
+        return true;
+    }
+
+    bool RHeadlessContext::makeCurrent()
+    {
+        return _context && eglMakeCurrent((EGLDisplay)_display, EGL_NO_SURFACE, EGL_NO_SURFACE, (EGLContext)_context);
+    }
+
+    void RHeadlessContext::destroy()
+    {
+        if (_context)
+        {
+            eglMakeCurrent((EGLDisplay)_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext((EGLDisplay)_display, (EGLContext)_context);
+            eglTerminate((EGLDisplay)_display);
+        }
+        _display = nullptr;
+        _context = nullptr;
+    }
+#else
+    bool RHeadlessContext::create(int, int)
+    {
+        return false;
+    }
+
+    bool RHeadlessContext::makeCurrent()
+    {
+        return false;
+    }
+
+    void RHeadlessContext::destroy()
+    {
+    }
+#endif
+
+    bool RHeadlessContext::isValid() const
+    {
+        return _context != nullptr;
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines an OpenGL context with no window or surface, for tests, benchmarks
+     * and tools that render on machines without a display.
+     *
+     * Created through EGL's surfaceless platform, which Mesa provides for its
+     * llvmpipe software rasterizer as well as for hardware drivers, so rendering
+     * code can run in CI with LIBGL_ALWAYS_SOFTWARE=1. Drawing goes to framebuffer
+     * objects the caller creates. Without EGL at build time create() always fails.
+     */
+    class API RHeadlessContext
+    {
+    public:
+        RHeadlessContext();
+        ~RHeadlessContext();
+
+        RHeadlessContext(const RHeadlessContext&) = delete;
+        RHeadlessContext& operator=(const RHeadlessContext&) = delete;
+
+        /**
+         * Creates a core profile context and makes it current on the calling thread.
+         *
+         * @return true if the context was created.
+         */
+        bool create(int major = 4, int minor = 5);
+
+        /**
+         * Makes the context current on the calling thread.
+         */
+        bool makeCurrent();
+
+        /**
+         * Releases and destroys the context.
+         */
+        void destroy();
+
+        /**
+         * Returns whether the context has been created.
+         */
+        bool isValid() const;
+
+    private:
+        void* _display;
+        void* _context;
+    };
+}
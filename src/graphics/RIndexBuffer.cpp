@@ -0,0 +1,48 @@
+#include "common.h"
+#include "RIndexBuffer.h"
+
+namespace rocket
+{
+    namespace
+    {
+        unsigned int getFormatSize(RIndexBuffer::IndexFormat format)
+        {
+            return format == RIndexBuffer::INDEX16 ? 2 : 4;
+        }
+    }
+
+    RIndexBuffer::RIndexBuffer(IndexFormat format, unsigned int indicesPerFrame, unsigned int frames) :
+        RStreamBuffer(GL_ELEMENT_ARRAY_BUFFER, (size_t)getFormatSize(format) * indicesPerFrame, frames),
+        _format(format),
+        _indexSize(getFormatSize(format))
+    {
+    }
+
+    void* RIndexBuffer::allocate(unsigned int count, unsigned int* firstIndex)
+    {
+        size_t offset = 0;
+        void* data = reserve((size_t)_indexSize * count, _indexSize, &offset);
+        *firstIndex = (unsigned int)(offset / _indexSize);
+        return data;
+    }
+
+    RIndexBuffer::IndexFormat RIndexBuffer::getFormat() const
+    {
+        return _format;
+    }
+
+    GLenum RIndexBuffer::getType() const
+    {
+        return (GLenum)_format;
+    }
+
+    unsigned int RIndexBuffer::getIndexSize() const
+    {
+        return _indexSize;
+    }
+
+    const void* RIndexBuffer::getOffset(unsigned int firstIndex) const
+    {
+        return (const void*)((size_t)firstIndex * _indexSize);
+    }
+}
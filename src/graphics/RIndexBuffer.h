@@ -0,0 +1,64 @@
+#pragma once
+#include "../common.h"
+#include "RStreamBuffer.h"
+
+namespace rocket
+{
+    /**
+     * Defines a streaming index buffer, the counterpart of RVertexBuffer.
+     *
+     * Indices are written straight into a persistently mapped ring (see RStreamBuffer)
+     * and drawn from getOffset(firstIndex) with getType().
+     */
+    class API RIndexBuffer : public RStreamBuffer
+    {
+    public:
+        enum IndexFormat
+        {
+            INDEX16 = GL_UNSIGNED_SHORT,
+            INDEX32 = GL_UNSIGNED_INT
+        };
+
+        /**
+         * Creates an index buffer.
+         *
+         * @param format The index format.
+         * @param indicesPerFrame The number of indices one frame is expected to write.
+         * @param frames The number of frames the ring holds.
+         */
+        RIndexBuffer(IndexFormat format, unsigned int indicesPerFrame, unsigned int frames = DEFAULT_FRAMES);
+
+        /**
+         * Reserves space for indices.
+         *
+         * @param count The number of indices.
+         * @param firstIndex Receives the position of the first index in the buffer.
+         * @return The memory to write the indices to, or nullptr if they do not fit.
+         */
+        void* allocate(unsigned int count, unsigned int* firstIndex);
+
+        /**
+         * Returns the index format.
+         */
+        IndexFormat getFormat() const;
+
+        /**
+         * Returns the GL type of one index, for glDrawElements.
+         */
+        GLenum getType() const;
+
+        /**
+         * Returns the size of one index in bytes.
+         */
+        unsigned int getIndexSize() const;
+
+        /**
+         * Returns the byte offset of an index, as the indices argument of glDrawElements expects it.
+         */
+        const void* getOffset(unsigned int firstIndex) const;
+
+    private:
+        IndexFormat _format;
+        unsigned int _indexSize;
+    };
+}
@@ -0,0 +1,193 @@
+#include "common.h"
+#include "RInstanceBatcher.h"
+
+namespace rocket
+{
+    namespace
+    {
+        // Keys and packing are memory bound, so only large lists are worth splitting.
+        const size_t PARALLEL_THRESHOLD = 32 * 1024;
+
+        inline bool useJobs(RJobSystem* jobs, size_t count)
+        {
+            return jobs && count >= PARALLEL_THRESHOLD && jobs->getThreadCount() > 1;
+        }
+
+        template <typename Function>
+        void forEach(RJobSystem* jobs, size_t count, Function&& function)
+        {
+            if (useJobs(jobs, count))
+            {
+                jobs->parallelFor((unsigned int)count, function);
+            }
+            else
+            {
+                function(0u, (unsigned int)count);
+            }
+        }
+
+        inline uint64_t batchKey(const RMeshInstance* instance)
+        {
+            return (uint64_t)instance->getMaterial()->getId() << 32 | instance->getMesh()->getId();
+        }
+    }
+
+    RInstanceBatcher::RInstanceBatcher()
+    {
+    }
+
+    void RInstanceBatcher::add(const RMeshInstance* instance)
+    {
+        if (instance->getMesh() && instance->getMaterial())
+        {
+            if (_instances.size() == _instances.capacity())
+            {
+                // Grown here, under the graphics tag, rather than by push_back on every add.
+                RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+                _instances.reserve(std::max<size_t>(64, _instances.capacity() * 2));
+            }
+            _instances.push_back(instance);
+        }
+    }
+
+    void RInstanceBatcher::reserve(size_t count)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        _instances.reserve(count);
+        _items.reserve(count);
+        _scratch.reserve(count);
+    }
+
+    void RInstanceBatcher::build(RJobSystem* jobs)
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+        const size_t count = _instances.size();
+        _items.resize(count);
+        _scratch.resize(count);
+        _batches.clear();
+
+        forEach(jobs, count, [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                _items[i].key = batchKey(_instances[i]);
+                _items[i].index = i;
+            }
+        });
+        RRadixSort::sort(_items.data(), _scratch.data(), count, jobs);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const RMeshInstance* instance = _instances[_items[i].index];
+            // Translucent instances are not instanced: each is drawn on its own so it
+            // can be sorted back to front against every other translucent draw.
+            if (i == 0 || _items[i].key != _items[i - 1].key || instance->getMaterial()->isTranslucent())
+            {
+                RInstanceBatch batch;
+                batch.mesh = instance->getMesh();
+                batch.material = instance->getMaterial();
+                batch.firstInstance = (uint32_t)i;
+                batch.instanceCount = 0;
+                _batches.push_back(batch);
+            }
+            ++_batches.back().instanceCount;
+        }
+    }
+
+    void RInstanceBatcher::write(RInstanceData* destination, RJobSystem* jobs) const
+    {
+        // Written in order, so each thread streams through its own range of the
+        // (possibly write-combined) destination.
+        forEach(jobs, _items.size(), [&](unsigned int begin, unsigned int end)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                _instances[_items[i].index]->pack(&destination[i]);
+            }
+        });
+    }
+
+    bool RInstanceBatcher::upload(RInstanceBuffer& buffer, uint32_t* baseInstance, RJobSystem* jobs)
+    {
+        *baseInstance = 0;
+        if (_items.empty())
+        {
+            return true;
+        }
+
+        unsigned int first = 0;
+        RInstanceData* destination = buffer.allocate((unsigned int)_items.size(), &first);
+        if (!destination)
+        {
+            return false;
+        }
+        write(destination, jobs);
+        *baseInstance = first;
+        return true;
+    }
+
+    void RInstanceBatcher::submit(RDrawList& list, uint32_t baseInstance, const RVector3& eye, float farDistance,
+                                  unsigned int layer) const
+    {
+        for (size_t i = 0; i < _batches.size(); ++i)
+        {
+            const RInstanceBatch& batch = _batches[i];
+            const RMaterial* material = batch.material;
+            const RMesh* mesh = batch.mesh;
+
+            RDrawPacket packet;
+            packet.program = material->getProgram();
+            packet.blendState = material->getBlendState()->getId();
+            packet.cullState = material->getCullState()->getId();
+            packet.vertexArray = mesh->getVertexArray();
+            packet.texture = material->getTexture();
+            packet.uniformBuffer = material->getUniformBuffer();
+            packet.uniformOffset = material->getUniformOffset();
+            packet.uniformRange = material->getUniformRange();
+            packet.primitive = mesh->getPrimitive();
+            packet.index32 = mesh->isIndex32();
+            packet.indexCount = mesh->getIndexCount();
+            packet.firstIndex = mesh->getFirstIndex();
+            packet.baseVertex = mesh->getBaseVertex();
+            packet.instanceCount = batch.instanceCount;
+            packet.baseInstance = baseInstance + batch.firstInstance;
+
+            uint64_t key;
+            if (material->isTranslucent())
+            {
+                // A translucent batch holds a single instance; see build().
+                RVector3 position;
+                _instances[_items[batch.firstInstance].index]->getWorld().getTranslation(&position);
+                float depth = farDistance > 0.0f ? eye.distance(position) / farDistance : 0.0f;
+                key = RSortKey::translucent(layer, depth, material->getPipelineId(), material->getId());
+            }
+            else
+            {
+                key = RSortKey::opaque(layer, material->getPipelineId(), material->getId(), mesh->getId(), 0.0f);
+            }
+            list.add(key, packet);
+        }
+    }
+
+    void RInstanceBatcher::clear()
+    {
+        _instances.clear();
+        _items.clear();
+        _batches.clear();
+    }
+
+    size_t RInstanceBatcher::getInstanceCount() const
+    {
+        return _instances.size();
+    }
+
+    size_t RInstanceBatcher::getBatchCount() const
+    {
+        return _batches.size();
+    }
+
+    const RInstanceBatch& RInstanceBatcher::getBatch(size_t index) const
+    {
+        return _batches[index];
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "../common.h"
+#include "RMeshInstance.h"
+#include "RInstanceBuffer.h"
+#include "RDrawList.h"
+#include "../utilities/RRadixSort.h"
+
+namespace rocket
+{
+    /**
+     * Defines a run of instances that share a mesh and a material, drawn with one instanced draw.
+     * Translucent instances each get a batch of their own.
+     */
+    struct RInstanceBatch
+    {
+        const RMesh* mesh;
+        const RMaterial* material;
+        // The batch's range in the order write() packs instances in.
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+    };
+
+    /**
+     * Defines the builder that turns mesh instances into instanced draws.
+     *
+     * Each frame the visible instances are added, build() sorts them by
+     * material and mesh with RRadixSort and cuts the sorted order into batches,
+     * upload() packs every instance's RInstanceData into an RInstanceBuffer
+     * batch after batch, and submit() adds one RDrawPacket per batch to a draw
+     * list, drawing instanceCount instances from the batch's base instance.
+     * A million instances of a few dozen kinds of object become a few dozen draws.
+     *
+     * Instances within a batch are drawn in one call and cannot be ordered among
+     * themselves, so instances of translucent materials are not instanced: each
+     * is drawn on its own with its distance from the eye as its depth, and blends
+     * back to front against every other translucent draw.
+     */
+    class API RInstanceBatcher
+    {
+    public:
+        RInstanceBatcher();
+
+        /**
+         * Adds an instance to draw this frame. Instances without a mesh or a material are ignored.
+         *
+         * The instance is read again by build() and write(), so it must live until then.
+         */
+        void add(const RMeshInstance* instance);
+
+        /**
+         * Reserves memory for a number of instances.
+         */
+        void reserve(size_t count);
+
+        /**
+         * Sorts the instances by material and mesh and forms the batches, one per
+         * translucent instance.
+         *
+         * @param jobs The job system to build large lists on, or null to build on the calling thread.
+         */
+        void build(RJobSystem* jobs = nullptr);
+
+        /**
+         * Packs the data of every instance in batch order.
+         *
+         * @param destination Memory for getInstanceCount() instances.
+         * @param jobs The job system to pack large lists on, or null to pack on the calling thread.
+         */
+        void write(RInstanceData* destination, RJobSystem* jobs = nullptr) const;
+
+        /**
+         * Allocates the instances from an instance buffer and packs them into it.
+         *
+         * @param buffer The buffer to allocate from.
+         * @param baseInstance Receives the base instance to pass to submit().
+         * @param jobs The job system to pack large lists on, or null to pack on the calling thread.
+         * @return false if the instances do not fit, in which case nothing should be submitted.
+         */
+        bool upload(RInstanceBuffer& buffer, uint32_t* baseInstance, RJobSystem* jobs = nullptr);
+
+        /**
+         * Adds one draw per batch to a draw list.
+         *
+         * @param list The list to add to.
+         * @param baseInstance The position of the first packed instance in the instance buffer.
+         * @param eye The position translucent instances are sorted back to front from.
+         * @param farDistance The distance from the eye that maps to the farthest depth.
+         * @param layer The layer of the draws' sort keys.
+         */
+        void submit(RDrawList& list, uint32_t baseInstance, const RVector3& eye, float farDistance,
+                    unsigned int layer = 0) const;
+
+        /**
+         * Removes every instance and batch.
+         */
+        void clear();
+
+        /**
+         * Returns the number of instances added.
+         */
+        size_t getInstanceCount() const;
+
+        /**
+         * Returns the number of batches the last build() formed.
+         */
+        size_t getBatchCount() const;
+
+        /**
+         * Returns a batch.
+         */
+        const RInstanceBatch& getBatch(size_t index) const;
+
+    private:
+        std::vector<const RMeshInstance*> _instances;
+        std::vector<RSortItem> _items;
+        std::vector<RSortItem> _scratch;
+        std::vector<RInstanceBatch> _batches;
+    };
+}
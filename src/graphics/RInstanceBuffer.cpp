@@ -0,0 +1,40 @@
+#include "common.h"
+#include "RInstanceBuffer.h"
+
+namespace rocket
+{
+    RInstanceBuffer::RInstanceBuffer(unsigned int instancesPerFrame, unsigned int frames) :
+        RVertexBuffer(sizeof(RInstanceData), instancesPerFrame, frames)
+    {
+    }
+
+    RInstanceData* RInstanceBuffer::allocate(unsigned int count, unsigned int* baseInstance)
+    {
+        return RVertexBuffer::allocate<RInstanceData>(count, baseInstance);
+    }
+
+    void RInstanceBuffer::attach(GLuint vertexArray) const
+    {
+        GLint previous = 0;
+        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previous);
+        glBindVertexArray(vertexArray);
+
+        glBindVertexBuffer(BINDING, getHandle(), 0, sizeof(RInstanceData));
+        glVertexBindingDivisor(BINDING, 1);
+        for (unsigned int column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(WORLD_ATTRIBUTE + column);
+            glVertexAttribFormat(WORLD_ATTRIBUTE + column, 4, GL_FLOAT, GL_FALSE,
+                                 offsetof(RInstanceData, world) + column * 4 * sizeof(float));
+            glVertexAttribBinding(WORLD_ATTRIBUTE + column, BINDING);
+        }
+        glEnableVertexAttribArray(TINT_ATTRIBUTE);
+        glVertexAttribFormat(TINT_ATTRIBUTE, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(RInstanceData, tint));
+        glVertexAttribBinding(TINT_ATTRIBUTE, BINDING);
+        glEnableVertexAttribArray(LOD_ATTRIBUTE);
+        glVertexAttribIFormat(LOD_ATTRIBUTE, 1, GL_UNSIGNED_INT, offsetof(RInstanceData, lod));
+        glVertexAttribBinding(LOD_ATTRIBUTE, BINDING);
+
+        glBindVertexArray((GLuint)previous);
+    }
+}
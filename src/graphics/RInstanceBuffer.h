@@ -0,0 +1,60 @@
+#pragma once
+#include "../common.h"
+#include "RVertexBuffer.h"
+#include "RMeshInstance.h"
+
+namespace rocket
+{
+    /**
+     * Defines the streaming buffer per-instance data is drawn from.
+     *
+     * Each instance is one RInstanceData in a persistently mapped ring (see
+     * RStreamBuffer). attach() points a vertex array's instanced attributes at
+     * the whole ring once; since the buffer never moves, a draw then selects its
+     * instances with the base instance alone and needs no per-draw bind.
+     *
+     * The attributes start at FIRST_ATTRIBUTE: the world matrix columns as four
+     * vec4s, the tint as a normalized vec4 and the LOD as a uint.
+     */
+    class API RInstanceBuffer : public RVertexBuffer
+    {
+    public:
+        /**
+         * The vertex buffer binding the ring is attached to.
+         */
+        static const unsigned int BINDING = 1;
+
+        /**
+         * The location of the first instance attribute.
+         */
+        static const unsigned int FIRST_ATTRIBUTE = 8;
+        static const unsigned int WORLD_ATTRIBUTE = FIRST_ATTRIBUTE;
+        static const unsigned int TINT_ATTRIBUTE = FIRST_ATTRIBUTE + 4;
+        static const unsigned int LOD_ATTRIBUTE = FIRST_ATTRIBUTE + 5;
+
+        /**
+         * Creates an instance buffer.
+         *
+         * @param instancesPerFrame The number of instances one frame is expected to write.
+         * @param frames The number of frames the ring holds.
+         */
+        RInstanceBuffer(unsigned int instancesPerFrame, unsigned int frames = DEFAULT_FRAMES);
+
+        /**
+         * Reserves space for instances.
+         *
+         * @param count The number of instances.
+         * @param baseInstance Receives the base instance to draw them with.
+         * @return The memory to write the instances to, or nullptr if they do not fit.
+         */
+        RInstanceData* allocate(unsigned int count, unsigned int* baseInstance);
+
+        /**
+         * Declares the instance attributes in a vertex array and attaches the ring to it.
+         *
+         * Called once per vertex array, at load time. The vertex array bound
+         * before the call is bound again after it, so an RGLStateCache stays valid.
+         */
+        void attach(GLuint vertexArray) const;
+    };
+}
@@ -0,0 +1,66 @@
+#include "common.h"
+#include "RMesh.h"
+
+namespace rocket
+{
+    namespace
+    {
+        RIdAllocator& getIds()
+        {
+            static RIdAllocator ids;
+            return ids;
+        }
+    }
+
+    RMesh::RMesh(uint32_t vertexArray, RPrimitive primitive, bool index32, uint32_t indexCount,
+                 uint32_t firstIndex, int32_t baseVertex) :
+        _id(getIds().allocate()),
+        _vertexArray(vertexArray),
+        _primitive(primitive),
+        _index32(index32),
+        _indexCount(indexCount),
+        _firstIndex(firstIndex),
+        _baseVertex(baseVertex)
+    {
+    }
+
+    RMesh::~RMesh()
+    {
+        getIds().release(_id);
+    }
+
+    uint32_t RMesh::getId() const
+    {
+        return _id;
+    }
+
+    uint32_t RMesh::getVertexArray() const
+    {
+        return _vertexArray;
+    }
+
+    RPrimitive RMesh::getPrimitive() const
+    {
+        return _primitive;
+    }
+
+    bool RMesh::isIndex32() const
+    {
+        return _index32;
+    }
+
+    uint32_t RMesh::getIndexCount() const
+    {
+        return _indexCount;
+    }
+
+    uint32_t RMesh::getFirstIndex() const
+    {
+        return _firstIndex;
+    }
+
+    int32_t RMesh::getBaseVertex() const
+    {
+        return _baseVertex;
+    }
+}
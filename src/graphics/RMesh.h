@@ -0,0 +1,56 @@
+#pragma once
+#include "../common.h"
+#include "RCommandBuffer.h"
+
+namespace rocket
+{
+    /**
+     * Defines indexed geometry ready to draw: a vertex array with its index
+     * buffer and the range of indices to draw from it.
+     *
+     * A mesh refers to a vertex array it does not own, so several meshes can
+     * share one vertex array at different index ranges. Each mesh gets a small
+     * dense id when it is constructed, which batching and sort keys use in place
+     * of the pointer. Ids of destroyed meshes are reused, so they stay below the
+     * number of live meshes; past 2^RSortKey::MESH_BITS live meshes, sort keys
+     * truncate the id and such meshes group less tightly, but still draw correctly.
+     */
+    class API RMesh
+    {
+    public:
+        /**
+         * Creates a mesh.
+         *
+         * @param vertexArray The vertex array, with its element array buffer attached.
+         * @param primitive The primitive the indices assemble.
+         * @param index32 true for 32-bit indices, false for 16-bit.
+         * @param indexCount The number of indices to draw.
+         * @param firstIndex The position of the first index in the index buffer.
+         * @param baseVertex The value added to every index.
+         */
+        RMesh(uint32_t vertexArray, RPrimitive primitive, bool index32, uint32_t indexCount,
+              uint32_t firstIndex = 0, int32_t baseVertex = 0);
+
+        ~RMesh();
+
+        RMesh(const RMesh&) = delete;
+        RMesh& operator=(const RMesh&) = delete;
+
+        uint32_t getId() const;
+        uint32_t getVertexArray() const;
+        RPrimitive getPrimitive() const;
+        bool isIndex32() const;
+        uint32_t getIndexCount() const;
+        uint32_t getFirstIndex() const;
+        int32_t getBaseVertex() const;
+
+    private:
+        uint32_t _id;
+        uint32_t _vertexArray;
+        RPrimitive _primitive;
+        bool _index32;
+        uint32_t _indexCount;
+        uint32_t _firstIndex;
+        int32_t _baseVertex;
+    };
+}
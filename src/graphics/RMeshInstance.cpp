@@ -0,0 +1,77 @@
+#include "common.h"
+#include "RMeshInstance.h"
+
+namespace rocket
+{
+    namespace
+    {
+        inline uint32_t toByte(float value)
+        {
+            return (uint32_t)(MATH_CLAMP(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+
+        inline float toFloat(uint32_t value)
+        {
+            return (float)(value & 0xFF) / 255.0f;
+        }
+    }
+
+    RMeshInstance::RMeshInstance(const RMesh* mesh, const RMaterial* material) :
+        _mesh(mesh),
+        _material(material),
+        _tint(0xFFFFFFFFu),
+        _lod(0)
+    {
+    }
+
+    void RMeshInstance::setMesh(const RMesh* mesh)
+    {
+        _mesh = mesh;
+    }
+
+    void RMeshInstance::setMaterial(const RMaterial* material)
+    {
+        _material = material;
+    }
+
+    void RMeshInstance::setWorld(const RMatrix& world)
+    {
+        _world = world;
+    }
+
+    void RMeshInstance::setTint(const RVector4& tint)
+    {
+        // Packed once here rather than every frame; red is the lowest byte, as GL reads RGBA8.
+        _tint = toByte(tint.x) | toByte(tint.y) << 8 | toByte(tint.z) << 16 | toByte(tint.w) << 24;
+    }
+
+    void RMeshInstance::setLod(uint32_t lod)
+    {
+        _lod = lod;
+    }
+
+    const RMesh* RMeshInstance::getMesh() const
+    {
+        return _mesh;
+    }
+
+    const RMaterial* RMeshInstance::getMaterial() const
+    {
+        return _material;
+    }
+
+    const RMatrix& RMeshInstance::getWorld() const
+    {
+        return _world;
+    }
+
+    RVector4 RMeshInstance::getTint() const
+    {
+        return RVector4(toFloat(_tint), toFloat(_tint >> 8), toFloat(_tint >> 16), toFloat(_tint >> 24));
+    }
+
+    uint32_t RMeshInstance::getLod() const
+    {
+        return _lod;
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "../common.h"
+#include "../math/RMatrix.h"
+#include "../math/RVector4.h"
+#include "RMesh.h"
+#include "../materials/RMaterial.h"
+
+namespace rocket
+{
+    /**
+     * Defines the per-instance data of one mesh instance as the GPU reads it
+     * from the instance buffer.
+     *
+     * The tint is stored as normalized RGBA8 to keep the buffer small; at a
+     * million instances a frame every byte here is a megabyte of upload.
+     */
+    struct RInstanceData
+    {
+        float world[16];
+        uint32_t tint;
+        uint32_t lod;
+    };
+
+    static_assert(sizeof(RInstanceData) == 72, "RInstanceData must match the instance vertex layout");
+
+    /**
+     * Defines one placement of a mesh with a material in the world.
+     *
+     * Instances carry no GL state of their own. RInstanceBatcher groups the
+     * instances that share a mesh and a material and draws each group with one
+     * instanced draw, so scenes with many copies of the same object (foliage,
+     * props, crowds) cost a draw per kind of object rather than per object.
+     */
+    class API RMeshInstance
+    {
+    public:
+        /**
+         * Creates an instance at the origin with a white tint and LOD 0.
+         */
+        RMeshInstance(const RMesh* mesh, const RMaterial* material);
+
+        void setMesh(const RMesh* mesh);
+        void setMaterial(const RMaterial* material);
+        void setWorld(const RMatrix& world);
+
+        /**
+         * Sets the color the material multiplies the surface by, with components in [0, 1].
+         */
+        void setTint(const RVector4& tint);
+
+        /**
+         * Sets the level of detail the shader selects.
+         */
+        void setLod(uint32_t lod);
+
+        const RMesh* getMesh() const;
+        const RMaterial* getMaterial() const;
+        const RMatrix& getWorld() const;
+        RVector4 getTint() const;
+        uint32_t getLod() const;
+
+        /**
+         * Writes the instance's data for the instance buffer.
+         */
+        inline void pack(RInstanceData* data) const;
+
+    private:
+        const RMesh* _mesh;
+        const RMaterial* _material;
+        RMatrix _world;
+        uint32_t _tint;
+        uint32_t _lod;
+    };
+
+    inline void RMeshInstance::pack(RInstanceData* data) const
+    {
+        memcpy(data->world, _world.m, sizeof(data->world));
+        data->tint = _tint;
+        data->lod = _lod;
+    }
+}
@@ -0,0 +1,77 @@
+#include "common.h"
+#include "RNullBackend.h"
+
+namespace rocket
+{
+    RNullBackend::RNullBackend() :
+        _recording(false),
+        _counts()
+    {
+    }
+
+    void RNullBackend::submit(const RCommandBuffer& buffer)
+    {
+        RRenderStats stats = {};
+        for (const RCommand& command : buffer)
+        {
+            ++_counts[command.type];
+            if (command.type == RCommand::DRAW)
+            {
+                const RDrawCommand& draw = command.as<RDrawCommand>();
+                ++stats.drawCalls;
+                stats.instances += draw.instanceCount;
+                stats.triangles += getTriangleCount(draw.primitive, draw.vertexCount) * draw.instanceCount;
+            }
+            else if (command.type == RCommand::DRAW_INDEXED)
+            {
+                const RDrawIndexedCommand& draw = command.as<RDrawIndexedCommand>();
+                ++stats.drawCalls;
+                stats.instances += draw.instanceCount;
+                stats.triangles += getTriangleCount(draw.primitive, draw.indexCount) * draw.instanceCount;
+            }
+
+            if (_recording)
+            {
+                // Commands are sized in multiples of 8 bytes, so whole words keep them aligned.
+                _offsets.push_back(_recorded.size());
+                const uint64_t* words = reinterpret_cast<const uint64_t*>(&command);
+                _recorded.insert(_recorded.end(), words, words + command.size / sizeof(uint64_t));
+            }
+        }
+        stats.commands = buffer.getCommandCount();
+        addStats(stats);
+    }
+
+    const char* RNullBackend::getName() const
+    {
+        return "null";
+    }
+
+    void RNullBackend::setRecording(bool recording)
+    {
+        _recording = recording;
+    }
+
+    uint64_t RNullBackend::getCount(RCommand::Type type) const
+    {
+        return _counts[type];
+    }
+
+    size_t RNullBackend::getRecordedCount() const
+    {
+        return _offsets.size();
+    }
+
+    const RCommand& RNullBackend::getRecorded(size_t index) const
+    {
+        return *reinterpret_cast<const RCommand*>(&_recorded[_offsets[index]]);
+    }
+
+    void RNullBackend::clear()
+    {
+        _recorded.clear();
+        _offsets.clear();
+        std::fill(_counts, _counts + RCommand::TYPE_COUNT, 0);
+        resetStats();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "../common.h"
+#include "RRenderBackend.h"
+
+namespace rocket
+{
+    /**
+     * Defines a backend that executes nothing.
+     *
+     * It walks every submitted command, counts them by type and keeps the same
+     * statistics as a real backend, so submission can be benchmarked and engine
+     * code tested without a GPU. With recording on it also keeps a copy of every
+     * command, which tests can inspect after the buffers themselves are gone.
+     */
+    class API RNullBackend : public RRenderBackend
+    {
+    public:
+        RNullBackend();
+
+        void submit(const RCommandBuffer& buffer) override;
+        const char* getName() const override;
+
+        /**
+         * Sets whether submitted commands are copied for inspection. Off by default.
+         */
+        void setRecording(bool recording);
+
+        /**
+         * Returns the number of commands of a type submitted since the last clear().
+         */
+        uint64_t getCount(RCommand::Type type) const;
+
+        /**
+         * Returns the number of commands recorded.
+         */
+        size_t getRecordedCount() const;
+
+        /**
+         * Returns a recorded command, in submission order.
+         */
+        const RCommand& getRecorded(size_t index) const;
+
+        /**
+         * Discards the recorded commands and zeroes the statistics.
+         */
+        void clear();
+
+    private:
+        bool _recording;
+        uint64_t _counts[RCommand::TYPE_COUNT];
+        std::vector<uint64_t> _recorded;
+        std::vector<size_t> _offsets;
+    };
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// OpenGL 4.x core entry points.
+//
+// On Linux libGL and libOpenGL export every core and ARB entry point, so the
+// prototypes are linked directly. Windows only exports OpenGL 1.1 from
+// opengl32.dll and needs a loader that defines the same names before this
+// header is included.
+#ifndef GL_GLEXT_PROTOTYPES
+#define GL_GLEXT_PROTOTYPES
+#endif
+#include <GL/gl.h>
+#include <GL/glext.h>
@@ -0,0 +1,56 @@
+#include "common.h"
+#include "RRenderBackend.h"
+
+namespace rocket
+{
+    RRenderBackend::RRenderBackend() :
+        _stats(),
+        _metrics(nullptr)
+    {
+    }
+
+    RRenderBackend::~RRenderBackend()
+    {
+    }
+
+    void RRenderBackend::setMetrics(RMetrics* metrics)
+    {
+        _metrics = metrics;
+    }
+
+    const RRenderStats& RRenderBackend::getStats() const
+    {
+        return _stats;
+    }
+
+    void RRenderBackend::resetStats()
+    {
+        _stats = RRenderStats();
+    }
+
+    uint64_t RRenderBackend::getTriangleCount(RPrimitive primitive, uint32_t count)
+    {
+        switch (primitive)
+        {
+        case PRIMITIVE_TRIANGLES:
+            return count / 3;
+        case PRIMITIVE_TRIANGLE_STRIP:
+            return count > 2 ? count - 2 : 0;
+        default:
+            return 0;
+        }
+    }
+
+    void RRenderBackend::addStats(const RRenderStats& stats)
+    {
+        _stats.commands += stats.commands;
+        _stats.drawCalls += stats.drawCalls;
+        _stats.instances += stats.instances;
+        _stats.triangles += stats.triangles;
+        if (_metrics)
+        {
+            _metrics->add(RMetrics::DRAW_CALLS, (int64_t)stats.drawCalls);
+            _metrics->add(RMetrics::TRIANGLES, (int64_t)stats.triangles);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include "../common.h"
+#include "RCommandBuffer.h"
+
+namespace rocket
+{
+    /**
+     * Defines the work a backend has executed since its statistics were last reset.
+     */
+    struct RRenderStats
+    {
+        uint64_t commands;
+        uint64_t drawCalls;
+        uint64_t instances;
+        uint64_t triangles;
+    };
+
+    /**
+     * Defines the interface that executes recorded command buffers.
+     *
+     * A backend is driven by one thread, the one that owns the graphics context,
+     * and executes buffers in the order they are submitted. RGLBackend executes
+     * them with OpenGL; RNullBackend only counts and optionally records them,
+     * for tests and benchmarks on machines with no GPU.
+     */
+    class API RRenderBackend
+    {
+    public:
+        virtual ~RRenderBackend();
+
+        /**
+         * Executes every command in a buffer.
+         */
+        virtual void submit(const RCommandBuffer& buffer) = 0;
+
+        /**
+         * Returns a short name for the backend, for logs and benchmark output.
+         */
+        virtual const char* getName() const = 0;
+
+        /**
+         * Sets the metrics that draw calls and triangles are added to, or null for none.
+         */
+        virtual void setMetrics(RMetrics* metrics);
+
+        /**
+         * Returns the work executed since the last resetStats().
+         */
+        const RRenderStats& getStats() const;
+
+        /**
+         * Zeroes the statistics.
+         */
+        void resetStats();
+
+        /**
+         * Returns the number of triangles a draw of count vertices or indices assembles.
+         */
+        static uint64_t getTriangleCount(RPrimitive primitive, uint32_t count);
+
+    protected:
+        RRenderBackend();
+
+        /**
+         * Adds one submission's work to the statistics and the metrics.
+         */
+        void addStats(const RRenderStats& stats);
+
+    private:
+        RRenderStats _stats;
+        RMetrics* _metrics;
+    };
+}
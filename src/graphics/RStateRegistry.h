@@ -0,0 +1,93 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines the table that interns immutable render state objects.
+     *
+     * Each distinct description is created once and gets a small dense id, so
+     * equal states are the same object: comparing two states is a pointer or
+     * id comparison, and commands can refer to a state by id alone. Lookups by
+     * id are lock-free; interning a description takes a lock, so states should
+     * be created at load time rather than per draw. States live until exit.
+     *
+     * T must have a nested Desc with a pack() method returning a uint64_t that is
+     * equal for equal descriptions, and a constructor taking its id and Desc.
+     */
+    template <typename T>
+    class RStateRegistry
+    {
+    public:
+        /**
+         * The maximum number of distinct states of one kind.
+         */
+        static const unsigned int MAX_STATES = 1024;
+
+        RStateRegistry() : _count(0)
+        {
+            for (unsigned int i = 0; i < MAX_STATES; ++i)
+            {
+                _states[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~RStateRegistry()
+        {
+            for (unsigned int i = 0; i < MAX_STATES; ++i)
+            {
+                delete _states[i].load(std::memory_order_relaxed);
+            }
+        }
+
+        RStateRegistry(const RStateRegistry&) = delete;
+        RStateRegistry& operator=(const RStateRegistry&) = delete;
+
+        /**
+         * Returns the state with a description, creating it if needed, or null if the table is full.
+         */
+        const T* intern(const typename T::Desc& desc)
+        {
+            uint64_t key = desc.pack();
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto found = _ids.find(key);
+            if (found != _ids.end())
+            {
+                return _states[found->second].load(std::memory_order_relaxed);
+            }
+            if (_count == MAX_STATES)
+            {
+                return nullptr;
+            }
+
+            uint16_t id = (uint16_t)_count++;
+            T* state = new T(id, desc);
+            _ids.emplace(key, id);
+            _states[id].store(state, std::memory_order_release);
+            return state;
+        }
+
+        /**
+         * Returns the state with an id, or null.
+         */
+        const T* get(uint16_t id) const
+        {
+            return id < MAX_STATES ? _states[id].load(std::memory_order_acquire) : nullptr;
+        }
+
+        /**
+         * Returns the number of states created.
+         */
+        unsigned int getCount() const
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _count;
+        }
+
+    private:
+        std::atomic<T*> _states[MAX_STATES];
+        std::unordered_map<uint64_t, uint16_t> _ids;
+        unsigned int _count;
+        mutable std::mutex _mutex;
+    };
+}
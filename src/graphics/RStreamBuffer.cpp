@@ -0,0 +1,181 @@
+#include "common.h"
+#include "RStreamBuffer.h"
+
+namespace rocket
+{
+    namespace
+    {
+        const GLbitfield MAP_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        // How long one blocking wait on a fence lasts before it is retried.
+        const GLuint64 FENCE_TIMEOUT = 1000000000;
+    }
+
+    RStreamBuffer::RStreamBuffer(GLenum target, size_t frameSize, unsigned int frames) :
+        _target(target),
+        _handle(0),
+        _data(nullptr),
+        _capacity(frameSize * std::max(frames, 1u)),
+        _head(0),
+        _tail(0),
+        _fenced(0),
+        _waitCount(0)
+    {
+        // Created through the copy target so that creating an index buffer does
+        // not change the element array binding of whichever vertex array is bound.
+        glGenBuffers(1, &_handle);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, (GLsizeiptr)_capacity, nullptr, MAP_FLAGS);
+        _data = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)_capacity, MAP_FLAGS);
+    }
+
+    RStreamBuffer::~RStreamBuffer()
+    {
+        for (size_t i = 0; i < _fences.size(); ++i)
+        {
+            glDeleteSync(_fences[i].sync);
+        }
+        if (_handle)
+        {
+            if (_data)
+            {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, _handle);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            }
+            glDeleteBuffers(1, &_handle);
+        }
+    }
+
+    bool RStreamBuffer::isSupported()
+    {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (major > 4 || (major == 4 && minor >= 4))
+        {
+            return true;
+        }
+
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i)
+        {
+            const char* name = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+            if (name && strcmp(name, "GL_ARB_buffer_storage") == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void* RStreamBuffer::reserve(size_t size, size_t alignment, size_t* offset)
+    {
+        if (!_data || size == 0 || size > _capacity)
+        {
+            return nullptr;
+        }
+
+        // Align within the buffer, and start again at the beginning rather than
+        // split a range across the end.
+        size_t position = (size_t)(_head % _capacity);
+        size_t padding = alignment > 1 ? (alignment - position % alignment) % alignment : 0;
+        if (position + padding + size > _capacity)
+        {
+            padding = _capacity - position;
+        }
+        uint64_t start = _head + padding;
+
+        while (start + size - _tail > _capacity)
+        {
+            if (_tail == _head)
+            {
+                // Nothing is in use, so the padding skipped to wrap holds nothing either.
+                _tail = start;
+                break;
+            }
+            if (!retire(true))
+            {
+                // Nothing is fenced: the current frame alone has filled the ring.
+                return nullptr;
+            }
+        }
+
+        _head = start + size;
+        *offset = (size_t)(start % _capacity);
+        return _data + *offset;
+    }
+
+    void RStreamBuffer::endFrame()
+    {
+        if (_head != _fenced)
+        {
+            RMemoryScope scope(RMemoryTracker::TAG_GRAPHICS);
+            Fence fence;
+            fence.sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            fence.end = _head;
+            _fences.push_back(fence);
+            _fenced = _head;
+        }
+
+        // Drop the fences the GPU has already passed so the queue stays short.
+        while (retire(false))
+        {
+        }
+    }
+
+    bool RStreamBuffer::retire(bool wait)
+    {
+        if (_fences.empty())
+        {
+            return false;
+        }
+
+        Fence& fence = _fences.front();
+        GLenum result = glClientWaitSync(fence.sync, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED)
+        {
+            if (!wait)
+            {
+                return false;
+            }
+            ++_waitCount;
+            do
+            {
+                result = glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+            } while (result == GL_TIMEOUT_EXPIRED);
+        }
+
+        // GL_WAIT_FAILED means the context is gone, and with it the GPU's claim on the range.
+        glDeleteSync(fence.sync);
+        _tail = fence.end;
+        _fences.pop_front();
+        return true;
+    }
+
+    void RStreamBuffer::bind() const
+    {
+        glBindBuffer(_target, _handle);
+    }
+
+    GLuint RStreamBuffer::getHandle() const
+    {
+        return _handle;
+    }
+
+    size_t RStreamBuffer::getCapacity() const
+    {
+        return _capacity;
+    }
+
+    size_t RStreamBuffer::getUsed() const
+    {
+        return (size_t)(_head - _tail);
+    }
+
+    uint64_t RStreamBuffer::getWaitCount() const
+    {
+        return _waitCount;
+    }
+}
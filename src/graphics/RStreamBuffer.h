@@ -0,0 +1,120 @@
+#pragma once
+#include "../common.h"
+#include "ROpenGL.h"
+#include <deque>
+
+namespace rocket
+{
+    /**
+     * Defines a GPU buffer for geometry that is rewritten every frame.
+     *
+     * The buffer is created once with glBufferStorage and mapped once with a
+     * persistent, coherent write mapping, so the CPU writes straight into memory
+     * the GPU reads from, with no glBufferSubData copy and no per-frame map/unmap.
+     * The storage is used as a ring: reserve() hands out the next free range and
+     * endFrame() puts a fence behind everything reserved so far. A range is only
+     * handed out again once the fence of the frame that last used it has signalled,
+     * so the CPU can run up to the configured number of frames ahead of the GPU
+     * before reserve() blocks.
+     *
+     * Requires OpenGL 4.4 or ARB_buffer_storage. Every call must be made on the
+     * thread that owns the current GL context.
+     */
+    class API RStreamBuffer
+    {
+    public:
+        /**
+         * The default number of frames the ring holds.
+         */
+        static const unsigned int DEFAULT_FRAMES = 3;
+
+        /**
+         * Creates and maps the buffer.
+         *
+         * @param target The binding target, such as GL_ARRAY_BUFFER.
+         * @param frameSize The number of bytes one frame is expected to write.
+         * @param frames The number of frames the ring holds.
+         */
+        RStreamBuffer(GLenum target, size_t frameSize, unsigned int frames = DEFAULT_FRAMES);
+
+        /**
+         * Unmaps and deletes the buffer, along with any pending fences.
+         */
+        virtual ~RStreamBuffer();
+
+        RStreamBuffer(const RStreamBuffer&) = delete;
+        RStreamBuffer& operator=(const RStreamBuffer&) = delete;
+
+        /**
+         * Returns whether the current context supports persistent buffer mappings.
+         */
+        static bool isSupported();
+
+        /**
+         * Reserves a range of the buffer for writing.
+         *
+         * Blocks on the oldest fences until the range is no longer in use by the GPU.
+         * The returned memory is write-only and must be filled before the draw that
+         * reads it is issued.
+         *
+         * @param size The number of bytes to reserve.
+         * @param alignment The alignment of the range's offset, which need not be a power of two.
+         * @param offset Receives the offset of the range in the buffer.
+         * @return The mapped memory, or nullptr if the range is larger than the buffer
+         *         or than what is left unfenced in the current frame.
+         */
+        void* reserve(size_t size, size_t alignment, size_t* offset);
+
+        /**
+         * Fences everything reserved since the previous call. Called once per frame
+         * after the draws that read the frame's ranges have been issued.
+         */
+        void endFrame();
+
+        /**
+         * Binds the buffer to its target.
+         */
+        void bind() const;
+
+        /**
+         * Returns the GL buffer name.
+         */
+        GLuint getHandle() const;
+
+        /**
+         * Returns the size of the buffer in bytes.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * Returns the number of bytes the GPU may still be reading or the CPU is writing.
+         */
+        size_t getUsed() const;
+
+        /**
+         * Returns the number of times reserve() had to wait for the GPU.
+         * A steadily growing count means the ring holds too few frames.
+         */
+        uint64_t getWaitCount() const;
+
+    private:
+        struct Fence
+        {
+            GLsync sync;
+            uint64_t end;
+        };
+
+        bool retire(bool wait);
+
+        GLenum _target;
+        GLuint _handle;
+        unsigned char* _data;
+        size_t _capacity;
+        // Positions are counted in bytes ever reserved, so they never wrap.
+        uint64_t _head;
+        uint64_t _tail;
+        uint64_t _fenced;
+        std::deque<Fence> _fences;
+        uint64_t _waitCount;
+    };
+}
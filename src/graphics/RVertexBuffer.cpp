@@ -0,0 +1,25 @@
+#include "common.h"
+#include "RVertexBuffer.h"
+
+namespace rocket
+{
+    RVertexBuffer::RVertexBuffer(unsigned int vertexSize, unsigned int verticesPerFrame, unsigned int frames) :
+        RStreamBuffer(GL_ARRAY_BUFFER, (size_t)vertexSize * verticesPerFrame, frames),
+        _vertexSize(vertexSize)
+    {
+    }
+
+    void* RVertexBuffer::allocate(unsigned int count, unsigned int* firstVertex)
+    {
+        // Aligning to the vertex size lets the offset be expressed as a base vertex.
+        size_t offset = 0;
+        void* data = reserve((size_t)_vertexSize * count, _vertexSize, &offset);
+        *firstVertex = (unsigned int)(offset / _vertexSize);
+        return data;
+    }
+
+    unsigned int RVertexBuffer::getVertexSize() const
+    {
+        return _vertexSize;
+    }
+}
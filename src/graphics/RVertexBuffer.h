@@ -0,0 +1,55 @@
+#pragma once
+#include "../common.h"
+#include "RStreamBuffer.h"
+
+namespace rocket
+{
+    /**
+     * Defines a streaming vertex buffer for geometry rebuilt every frame, such as
+     * UI, particles and debug lines.
+     *
+     * Vertices are written straight into a persistently mapped ring (see RStreamBuffer)
+     * and drawn with the returned first vertex as the base vertex.
+     */
+    class API RVertexBuffer : public RStreamBuffer
+    {
+    public:
+        /**
+         * Creates a vertex buffer.
+         *
+         * @param vertexSize The size of one vertex in bytes.
+         * @param verticesPerFrame The number of vertices one frame is expected to write.
+         * @param frames The number of frames the ring holds.
+         */
+        RVertexBuffer(unsigned int vertexSize, unsigned int verticesPerFrame, unsigned int frames = DEFAULT_FRAMES);
+
+        /**
+         * Reserves space for vertices.
+         *
+         * @param count The number of vertices.
+         * @param firstVertex Receives the index of the first vertex in the buffer.
+         * @return The memory to write the vertices to, or nullptr if they do not fit.
+         */
+        void* allocate(unsigned int count, unsigned int* firstVertex);
+
+        /**
+         * Reserves space for vertices of type T.
+         */
+        template<class T>
+        T* allocate(unsigned int count, unsigned int* firstVertex);
+
+        /**
+         * Returns the size of one vertex in bytes.
+         */
+        unsigned int getVertexSize() const;
+
+    private:
+        unsigned int _vertexSize;
+    };
+
+    template<class T>
+    T* RVertexBuffer::allocate(unsigned int count, unsigned int* firstVertex)
+    {
+        return static_cast<T*>(allocate(count, firstVertex));
+    }
+}
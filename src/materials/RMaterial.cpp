@@ -0,0 +1,120 @@
+#include "common.h"
+#include "RMaterial.h"
+#include "../graphics/RStateRegistry.h"
+
+namespace rocket
+{
+    namespace
+    {
+        RIdAllocator& getIds()
+        {
+            static RIdAllocator ids;
+            return ids;
+        }
+
+        // A program with the blend and cull state it draws with, interned so that
+        // materials sharing all three share a pipeline id.
+        struct Pipeline
+        {
+            struct Desc
+            {
+                uint32_t program;
+                RBlendState::Id blendState;
+                RCullState::Id cullState;
+
+                uint64_t pack() const { return (uint64_t)program << 32 | (uint64_t)blendState << 16 | cullState; }
+            };
+
+            Pipeline(uint16_t id, const Desc&) : id(id) {}
+
+            uint16_t id;
+        };
+
+        uint32_t internPipeline(uint32_t program, const RBlendState* blendState, const RCullState* cullState)
+        {
+            static RStateRegistry<Pipeline> registry;
+            Pipeline::Desc desc;
+            desc.program = program;
+            desc.blendState = blendState->getId();
+            desc.cullState = cullState->getId();
+            // Past the limit, materials share one id: still drawn correctly, just not grouped.
+            const Pipeline* pipeline = registry.intern(desc);
+            return pipeline ? pipeline->id : RStateRegistry<Pipeline>::MAX_STATES;
+        }
+    }
+
+    RMaterial::RMaterial(uint32_t program, uint32_t texture, const RBlendState* blendState, const RCullState* cullState) :
+        _id(getIds().allocate()),
+        _program(program),
+        _texture(texture),
+        _uniformBuffer(0),
+        _uniformOffset(0),
+        _uniformRange(0),
+        _blendState(blendState ? blendState : RBlendState::opaque()),
+        _cullState(cullState ? cullState : RCullState::back()),
+        _pipelineId(internPipeline(_program, _blendState, _cullState))
+    {
+    }
+
+    void RMaterial::setUniformBuffer(uint32_t buffer, uint32_t offset, uint32_t range)
+    {
+        _uniformBuffer = buffer;
+        _uniformOffset = offset;
+        _uniformRange = range;
+    }
+
+    RMaterial::~RMaterial()
+    {
+        getIds().release(_id);
+    }
+
+    uint32_t RMaterial::getId() const
+    {
+        return _id;
+    }
+
+    uint32_t RMaterial::getPipelineId() const
+    {
+        return _pipelineId;
+    }
+
+    uint32_t RMaterial::getProgram() const
+    {
+        return _program;
+    }
+
+    uint32_t RMaterial::getTexture() const
+    {
+        return _texture;
+    }
+
+    uint32_t RMaterial::getUniformBuffer() const
+    {
+        return _uniformBuffer;
+    }
+
+    uint32_t RMaterial::getUniformOffset() const
+    {
+        return _uniformOffset;
+    }
+
+    uint32_t RMaterial::getUniformRange() const
+    {
+        return _uniformRange;
+    }
+
+    const RBlendState* RMaterial::getBlendState() const
+    {
+        return _blendState;
+    }
+
+    const RCullState* RMaterial::getCullState() const
+    {
+        return _cullState;
+    }
+
+    bool RMaterial::isTranslucent() const
+    {
+        return _blendState->getDesc().enabled;
+    }
+}
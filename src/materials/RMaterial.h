@@ -0,0 +1,76 @@
+#pragma once
+#include "../common.h"
+#include "../graphics/RBlendState.h"
+#include "../graphics/RCullState.h"
+
+namespace rocket
+{
+    /**
+     * Defines how a surface is shaded: the program, its texture and constants,
+     * and the blend and cull states it draws with.
+     *
+     * A material refers to GL objects it does not own. Each material gets a
+     * small dense id when it is constructed, which batching and sort keys use
+     * in place of the pointer. Ids of destroyed materials are reused, so they
+     * stay below the number of live materials; past 2^RSortKey::MATERIAL_BITS
+     * live materials, sort keys truncate the id and such materials group less
+     * tightly, but still draw correctly.
+     */
+    class API RMaterial
+    {
+    public:
+        /**
+         * Creates a material.
+         *
+         * @param program The shader program.
+         * @param texture The texture bound to unit 0, or 0 for none.
+         * @param blendState The blend state, or null for RBlendState::opaque().
+         * @param cullState The cull state, or null for RCullState::back().
+         */
+        RMaterial(uint32_t program, uint32_t texture = 0,
+                  const RBlendState* blendState = nullptr, const RCullState* cullState = nullptr);
+
+        ~RMaterial();
+
+        RMaterial(const RMaterial&) = delete;
+        RMaterial& operator=(const RMaterial&) = delete;
+
+        /**
+         * Sets the range of a uniform buffer bound to block 0 with the material's constants.
+         */
+        void setUniformBuffer(uint32_t buffer, uint32_t offset, uint32_t range);
+
+        uint32_t getId() const;
+
+        /**
+         * Returns the small dense id of the material's program together with its
+         * blend and cull states, shared by every material with the same three.
+         * Sort keys use it as the pipeline so that draws group by all of that state.
+         */
+        uint32_t getPipelineId() const;
+
+        uint32_t getProgram() const;
+        uint32_t getTexture() const;
+        uint32_t getUniformBuffer() const;
+        uint32_t getUniformOffset() const;
+        uint32_t getUniformRange() const;
+        const RBlendState* getBlendState() const;
+        const RCullState* getCullState() const;
+
+        /**
+         * Returns true if the material blends, so its draws must be ordered back to front.
+         */
+        bool isTranslucent() const;
+
+    private:
+        uint32_t _id;
+        uint32_t _program;
+        uint32_t _texture;
+        uint32_t _uniformBuffer;
+        uint32_t _uniformOffset;
+        uint32_t _uniformRange;
+        const RBlendState* _blendState;
+        const RCullState* _cullState;
+        uint32_t _pipelineId;
+    };
+}
@@ -2,6 +2,7 @@
 #include "RBoundingBox.h"
 #include "RBoundingSphere.h"
 #include "RPlane.h"
+#include "RMath.h"
 
 namespace rocket
 {
@@ -74,6 +75,18 @@ API void RBoundingBox::getCenter(RVector3* dst) const
     dst->z = center.z;
 }
 
+API RVector3 RBoundingBox::getExtents() const
+{
+    RVector3 extents;
+    getExtents(&extents);
+    return extents;
+}
+
+API void RBoundingBox::getExtents(RVector3* dst) const
+{
+    dst->set((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+}
+
 API bool RBoundingBox::intersects(const RBoundingSphere& sphere) const
 {
     return sphere.intersects(*this);
@@ -256,91 +269,202 @@ API void RBoundingBox::set(float minX, float minY, float minZ, float maxX, float
     max = RVector3(maxX, maxY, maxZ);
 }
 
-static void updateMinMax(RVector3* point, RVector3* min, RVector3* max)
+API void RBoundingBox::set(const RBoundingBox& box)
+{
+    min = box.min;
+    max = box.max;
+}
+
+API void RBoundingBox::set(const RBoundingSphere& sphere)
 {
+    const RVector3& center = sphere.center;
+    float radius = sphere.radius;
+
+    // Calculate the minimum point for the box.
+    min.x = center.x - radius;
+    min.y = center.y - radius;
+    min.z = center.z - radius;
+
+    // Calculate the maximum point for the box.
+    max.x = center.x + radius;
+    max.y = center.y + radius;
+    max.z = center.z + radius;
+}
 
-    // Leftmost point.
-    if (point->x < min->x)
+static void computeMinMax(const RVector3* points, unsigned int begin, unsigned int end, RVector3* min, RVector3* max)
+{
+    if (begin >= end)
     {
-        min->x = point->x;
+        min->set(0, 0, 0);
+        max->set(0, 0, 0);
+        return;
     }
 
-    // Rightmost point.
-    if (point->x > max->x)
+    unsigned int i = begin;
+#ifdef MATH_SSE2
+    static_assert(sizeof(RVector3) == 3 * sizeof(float), "RVector3 must be tightly packed");
+
+    // Each unaligned load reads x, y, z and the x of the next point, so the last point
+    // is handled separately to avoid reading past the end of the array.
+    unsigned int last = end - 1;
+    if (i < last)
     {
-        max->x = point->x;
+        __m128 min0 = _mm_loadu_ps(&points[i].x);
+        __m128 max0 = min0;
+        __m128 min1 = min0;
+        __m128 max1 = min0;
+        for (++i; i + 1 < last; i += 2)
+        {
+            __m128 p0 = _mm_loadu_ps(&points[i].x);
+            __m128 p1 = _mm_loadu_ps(&points[i + 1].x);
+            min0 = _mm_min_ps(min0, p0);
+            max0 = _mm_max_ps(max0, p0);
+            min1 = _mm_min_ps(min1, p1);
+            max1 = _mm_max_ps(max1, p1);
+        }
+        for (; i < last; ++i)
+        {
+            __m128 p = _mm_loadu_ps(&points[i].x);
+            min0 = _mm_min_ps(min0, p);
+            max0 = _mm_max_ps(max0, p);
+        }
+
+        float mn[4];
+        float mx[4];
+        _mm_storeu_ps(mn, _mm_min_ps(min0, min1));
+        _mm_storeu_ps(mx, _mm_max_ps(max0, max1));
+        min->set(mn[0], mn[1], mn[2]);
+        max->set(mx[0], mx[1], mx[2]);
     }
-
-    // Lowest point.
-    if (point->y < min->y)
+    else
     {
-        min->y = point->y;
+        *min = points[i];
+        *max = points[i];
     }
-
-    // Highest point.
-    if (point->y > max->y)
+    i = last;
+#else
+    *min = points[i];
+    *max = points[i];
+    ++i;
+#endif
+
+    for (; i < end; ++i)
     {
-        max->y = point->y;
+        const RVector3& p = points[i];
+        min->set(std::min(min->x, p.x), std::min(min->y, p.y), std::min(min->z, p.z));
+        max->set(std::max(max->x, p.x), std::max(max->y, p.y), std::max(max->z, p.z));
     }
+}
 
-    // Farthest point.
-    if (point->z < min->z)
+// A min/max pass over fewer points than this is cheaper than handing it to another thread.
+static const unsigned int MIN_POINTS_PER_CHUNK = 1 << 16;
+
+API void RBoundingBox::set(const RVector3* points, unsigned int count, RJobSystem* jobs)
+{
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    if (count == 0)
     {
-        min->z = point->z;
+        set(RVector3::zero(), RVector3::zero());
+        return;
     }
 
-    // Nearest point.
-    if (point->z > max->z)
+    unsigned int chunkCount = RMath::getChunkCount(count, MIN_POINTS_PER_CHUNK, jobs);
+    std::vector<RBoundingBox> partial(chunkCount);
+    RMath::forEachChunk(count, chunkCount, [&](unsigned int chunk, unsigned int begin, unsigned int end)
+    {
+        computeMinMax(points, begin, end, &partial[chunk].min, &partial[chunk].max);
+    }, jobs);
+
+    set(partial[0]);
+    for (unsigned int i = 1; i < chunkCount; ++i)
     {
-        max->z = point->z;
+        merge(partial[i]);
     }
 }
 
-API void RBoundingBox::set(const RBoundingBox& box)
+API void RBoundingBox::createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount, RBoundingBox* dst,
+                                        RJobSystem* jobs)
 {
-    min = box.min;
-    max = box.max;
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    RMath::forEachChunk(setCount, RMath::getChunkCount(counts, setCount, MIN_POINTS_PER_CHUNK, jobs), [&](unsigned int, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            computeMinMax(points[i], 0, counts[i], &dst[i].min, &dst[i].max);
+        }
+    }, jobs);
 }
 
-API void RBoundingBox::set(const RBoundingSphere& sphere)
+API void RBoundingBox::setCenterExtents(const RVector3& center, const RVector3& extents)
 {
-    const RVector3& center = sphere.center;
-    float radius = sphere.radius;
-
-    // Calculate the minimum point for the box.
-    min.x = center.x - radius;
-    min.y = center.y - radius;
-    min.z = center.z - radius;
+    min.set(center.x - extents.x, center.y - extents.y, center.z - extents.z);
+    max.set(center.x + extents.x, center.y + extents.y, center.z + extents.z);
+}
 
-    // Calculate the maximum point for the box.
-    max.x = center.x + radius;
-    max.y = center.y + radius;
-    max.z = center.z + radius;
+/**
+ * Transforms a box in center-extent form by an affine matrix (Arvo).
+ */
+static inline void transformCenterExtents(const float* m, const RVector3& center, const RVector3& extents,
+                                          RVector3* dstCenter, RVector3* dstExtents)
+{
+#ifdef MATH_SSE2
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 c0 = _mm_loadu_ps(m);
+    __m128 c1 = _mm_loadu_ps(m + 4);
+    __m128 c2 = _mm_loadu_ps(m + 8);
+    __m128 c3 = _mm_loadu_ps(m + 12);
+
+    __m128 c = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(center.x)), _mm_mul_ps(c1, _mm_set1_ps(center.y))),
+                          _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(center.z)), c3));
+    __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, c0), _mm_set1_ps(extents.x)),
+                                     _mm_mul_ps(_mm_andnot_ps(signMask, c1), _mm_set1_ps(extents.y))),
+                          _mm_mul_ps(_mm_andnot_ps(signMask, c2), _mm_set1_ps(extents.z)));
+
+    float cv[4];
+    float ev[4];
+    _mm_storeu_ps(cv, c);
+    _mm_storeu_ps(ev, e);
+    dstCenter->set(cv[0], cv[1], cv[2]);
+    dstExtents->set(ev[0], ev[1], ev[2]);
+#else
+    float cx = center.x * m[0] + center.y * m[4] + center.z * m[8] + m[12];
+    float cy = center.x * m[1] + center.y * m[5] + center.z * m[9] + m[13];
+    float cz = center.x * m[2] + center.y * m[6] + center.z * m[10] + m[14];
+    float ex = fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y + fabsf(m[8]) * extents.z;
+    float ey = fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y + fabsf(m[9]) * extents.z;
+    float ez = fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y + fabsf(m[10]) * extents.z;
+    dstCenter->set(cx, cy, cz);
+    dstExtents->set(ex, ey, ez);
+#endif
 }
 
 API void RBoundingBox::transform(const RMatrix& matrix)
 {
-    // Calculate the corners.
-    RVector3 corners[8];
-    getCorners(corners);
-
-    // Transform the corners, recalculating the min and max points along the way.
-    RVector4 corner = (matrix* RVector4(corners[0].x, corners[0].y, corners[0].z, 1.0f));
-    RVector3 c = RVector3(corner.x, corner.y, corner.z);
-    corners[0] = c;
-    RVector3 newMin = corners[0];
-    RVector3 newMax = corners[0];
-    for (int i = 1; i < 8; i++)
+    RVector3 center;
+    RVector3 extents;
+    transformCenterExtents(matrix.m, getCenter(), getExtents(), &center, &extents);
+    setCenterExtents(center, extents);
+}
+
+API void RBoundingBox::transform(const RBoundingBox* boxes, const RMatrix* matrices, unsigned int count, RBoundingBox* dst)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const RBoundingBox& box = boxes[i];
+        RVector3 center((box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f);
+        RVector3 extents((box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f);
+        transformCenterExtents(matrices[i].m, center, extents, &center, &extents);
+        dst[i].setCenterExtents(center, extents);
+    }
+}
+
+API void RBoundingBox::transform(const RVector3* centers, const RVector3* extents, const RMatrix* matrices, unsigned int count,
+                                 RVector3* dstCenters, RVector3* dstExtents)
+{
+    for (unsigned int i = 0; i < count; ++i)
     {
-        corners[i] = c;
-        updateMinMax(&corners[i], &newMin, &newMax);
+        transformCenterExtents(matrices[i].m, centers[i], extents[i], &dstCenters[i], &dstExtents[i]);
     }
-    this->min.x = newMin.x;
-    this->min.y = newMin.y;
-    this->min.z = newMin.z;
-    this->max.x = newMax.x;
-    this->max.y = newMax.y;
-    this->max.z = newMax.z;
 }
 
-}
\ No newline at end of file
+}
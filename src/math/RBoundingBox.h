@@ -85,6 +85,22 @@ public:
      */
     void getCenter(RVector3* dst) const;
 
+    /**
+     * Gets the half-size of the bounding box along each axis.
+     *
+     * Together with getCenter() this is the center-extent form of the box.
+     *
+     * @return The extents of the bounding box.
+     */
+    RVector3 getExtents() const;
+
+    /**
+     * Gets the half-size of the bounding box along each axis and stores the result in dst.
+     *
+     * @param dst The vector to store the result in.
+     */
+    void getExtents(RVector3* dst) const;
+
     /**
      * Gets the corners of the bounding box in the specified array.
      *
@@ -202,13 +218,79 @@ public:
      */
     void set(const RBoundingSphere& sphere);
 
+    /**
+     * Sets this box to the smallest box that contains the specified points.
+     *
+     * The min/max reduction uses SIMD where available and is split across the
+     * job system's threads for large point sets. An empty point set yields an
+     * empty box at the origin.
+     *
+     * @param points The points to contain.
+     * @param count The number of points.
+     * @param jobs The job system to split large point sets across, or null to run on the calling thread.
+     */
+    void set(const RVector3* points, unsigned int count, RJobSystem* jobs = nullptr);
+
+    /**
+     * Computes the bounding boxes of several point sets (for example all the meshes of a model),
+     * distributing the point sets across the job system's threads.
+     *
+     * @param points The point sets.
+     * @param counts The number of points in each point set.
+     * @param setCount The number of point sets.
+     * @param dst An array of setCount bounding boxes to store the results in.
+     * @param jobs The job system to distribute the point sets across, or null to run on the calling thread.
+     */
+    static void createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount, RBoundingBox* dst,
+                                 RJobSystem* jobs = nullptr);
+
+    /**
+     * Sets this bounding box from its center-extent form.
+     *
+     * @param center The center point of the bounding box.
+     * @param extents The half-size of the bounding box along each axis.
+     */
+    void setCenterExtents(const RVector3& center, const RVector3& extents);
+
     /**
      * Transforms the bounding box by the given transformation matrix.
      *
+     * The result is the tightest axis-aligned box containing the transformed box. It is
+     * computed from the center-extent form (Arvo): the center is transformed as a point and
+     * the extents are multiplied by the absolute value of the upper 3x3 of the matrix, which
+     * is equivalent to transforming the eight corners at a fraction of the cost. The matrix
+     * must be affine.
+     *
      * @param matrix The transformation matrix to transform by.
      */
     void transform(const RMatrix& matrix);
 
+    /**
+     * Transforms an array of bounding boxes, each by its own affine matrix.
+     *
+     * @param boxes The bounding boxes to transform.
+     * @param matrices The matrices to transform each box by.
+     * @param count The number of boxes.
+     * @param dst An array of count bounding boxes to store the results in (may be the same array as boxes).
+     */
+    static void transform(const RBoundingBox* boxes, const RMatrix* matrices, unsigned int count, RBoundingBox* dst);
+
+    /**
+     * Transforms an array of bounding boxes in center-extent form, each by its own affine matrix.
+     *
+     * This is the fastest path for bounds updates: it needs no conversion from min/max,
+     * and the center-extent output feeds straight into plane and frustum tests.
+     *
+     * @param centers The centers of the bounding boxes.
+     * @param extents The half-sizes of the bounding boxes.
+     * @param matrices The matrices to transform each box by.
+     * @param count The number of boxes.
+     * @param dstCenters An array of count vectors to store the transformed centers in.
+     * @param dstExtents An array of count vectors to store the transformed extents in.
+     */
+    static void transform(const RVector3* centers, const RVector3* extents, const RMatrix* matrices, unsigned int count,
+                          RVector3* dstCenters, RVector3* dstExtents);
+
     /**
      * Transforms this bounding box by the given matrix.
      * 
@@ -0,0 +1,553 @@
+#include "common.h"
+#include "RBoundingOrientedBox.h"
+#include "RBoundingBox.h"
+#include "RBoundingSphere.h"
+#include "RTransform.h"
+#include "RMath.h"
+
+namespace rocket
+{
+
+API RBoundingOrientedBox::RBoundingOrientedBox()
+{
+    axes[0] = RVector3::unitX();
+    axes[1] = RVector3::unitY();
+    axes[2] = RVector3::unitZ();
+}
+
+API RBoundingOrientedBox::RBoundingOrientedBox(const RVector3& center, const RVector3& axisX, const RVector3& axisY, const RVector3& axisZ, const RVector3& extents)
+{
+    set(center, axisX, axisY, axisZ, extents);
+}
+
+API RBoundingOrientedBox::RBoundingOrientedBox(const RBoundingOrientedBox& copy)
+{
+    set(copy);
+}
+
+API RBoundingOrientedBox::~RBoundingOrientedBox()
+{
+}
+
+API const RBoundingOrientedBox& RBoundingOrientedBox::empty()
+{
+    static RBoundingOrientedBox b;
+    return b;
+}
+
+API void RBoundingOrientedBox::getCorners(RVector3* dst) const
+{
+    RVector3 x = axes[0] * extents.x;
+    RVector3 y = axes[1] * extents.y;
+    RVector3 z = axes[2] * extents.z;
+
+    // Near face, specified counter-clockwise looking towards the center from the positive local z-axis.
+    dst[0] = center - x + y + z;
+    dst[1] = center - x - y + z;
+    dst[2] = center + x - y + z;
+    dst[3] = center + x + y + z;
+
+    // Far face, specified counter-clockwise looking towards the center from the negative local z-axis.
+    dst[4] = center + x + y - z;
+    dst[5] = center + x - y - z;
+    dst[6] = center - x - y - z;
+    dst[7] = center - x + y - z;
+}
+
+API bool RBoundingOrientedBox::intersects(const RBoundingOrientedBox& box) const
+{
+    // Separating axis test (Ericson, Real-Time Collision Detection, 4.4.1).
+    const float a[3] = { extents.x, extents.y, extents.z };
+    const float b[3] = { box.extents.x, box.extents.y, box.extents.z };
+
+    // Rotation expressing the other box in the local frame of this box, and its absolute value.
+    // The epsilon counters arithmetic errors when two edges are parallel and their cross product is near zero.
+    float r[3][3];
+    float absR[3][3];
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            r[i][j] = axes[i].dot(box.axes[j]);
+            absR[i][j] = fabsf(r[i][j]) + MATH_EPSILON;
+        }
+    }
+
+    // Translation in the local frame of this box.
+    RVector3 d = box.center - center;
+    const float t[3] = { d.dot(axes[0]), d.dot(axes[1]), d.dot(axes[2]) };
+
+    // Axes of this box.
+    for (int i = 0; i < 3; ++i)
+    {
+        float rb = b[0] * absR[i][0] + b[1] * absR[i][1] + b[2] * absR[i][2];
+        if (fabsf(t[i]) > a[i] + rb)
+        {
+            return false;
+        }
+    }
+
+    // Axes of the other box.
+    for (int j = 0; j < 3; ++j)
+    {
+        float ra = a[0] * absR[0][j] + a[1] * absR[1][j] + a[2] * absR[2][j];
+        if (fabsf(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]) > ra + b[j])
+        {
+            return false;
+        }
+    }
+
+    // Cross products of the edges, axes[i] x box.axes[j].
+    for (int i = 0; i < 3; ++i)
+    {
+        int i1 = (i + 1) % 3;
+        int i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; ++j)
+        {
+            int j1 = (j + 1) % 3;
+            int j2 = (j + 2) % 3;
+            float ra = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+            float rb = b[j1] * absR[i][j2] + b[j2] * absR[i][j1];
+            if (fabsf(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+API bool RBoundingOrientedBox::intersects(const RBoundingBox& box) const
+{
+    RBoundingOrientedBox b;
+    b.set(box);
+    return intersects(b);
+}
+
+API bool RBoundingOrientedBox::intersects(const RBoundingSphere& sphere) const
+{
+    // Find the point of the box closest to the center of the sphere.
+    RVector3 d = sphere.center - center;
+    RVector3 closest = center;
+    const float e[3] = { extents.x, extents.y, extents.z };
+    for (int i = 0; i < 3; ++i)
+    {
+        float distance = d.dot(axes[i]);
+        closest += axes[i] * MATH_CLAMP(distance, -e[i], e[i]);
+    }
+    return closest.distanceSquared(sphere.center) <= sphere.radius * sphere.radius;
+}
+
+API bool RBoundingOrientedBox::intersects(const RFrustum& frustum) const
+{
+    // The box must either intersect or be in the positive half-space of all six planes of the frustum.
+    return (intersects(frustum.getNear()) != RPlane::INTERSECTS_BACK &&
+            intersects(frustum.getFar()) != RPlane::INTERSECTS_BACK &&
+            intersects(frustum.getLeft()) != RPlane::INTERSECTS_BACK &&
+            intersects(frustum.getRight()) != RPlane::INTERSECTS_BACK &&
+            intersects(frustum.getBottom()) != RPlane::INTERSECTS_BACK &&
+            intersects(frustum.getTop()) != RPlane::INTERSECTS_BACK);
+}
+
+API float RBoundingOrientedBox::intersects(const RPlane& plane) const
+{
+    // Project the extents of the box onto the plane normal.
+    const RVector3& normal = plane.getNormal();
+    float radius = extents.x * fabsf(normal.dot(axes[0])) +
+                   extents.y * fabsf(normal.dot(axes[1])) +
+                   extents.z * fabsf(normal.dot(axes[2]));
+    float distance = plane.distance(center);
+
+    if (fabsf(distance) <= radius)
+    {
+        return RPlane::INTERSECTS_INTERSECTING;
+    }
+
+    return (distance > 0.0f) ? (float)RPlane::INTERSECTS_FRONT : (float)RPlane::INTERSECTS_BACK;
+}
+
+API float RBoundingOrientedBox::intersects(const RRay& ray) const
+{
+    // Slab test in the local frame of the box.
+    RVector3 d = ray.getOrigin() - center;
+    const float e[3] = { extents.x, extents.y, extents.z };
+    float dnear = -FLT_MAX;
+    float dfar = FLT_MAX;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        float origin = d.dot(axes[i]);
+        float direction = ray.getDirection().dot(axes[i]);
+        if (fabsf(direction) < MATH_EPSILON)
+        {
+            // The ray is parallel to the slab; it misses unless the origin is inside it.
+            if (fabsf(origin) > e[i])
+            {
+                return RRay::INTERSECTS_NONE;
+            }
+            continue;
+        }
+
+        float div = 1.0f / direction;
+        float tmin = (-e[i] - origin) * div;
+        float tmax = (e[i] - origin) * div;
+        if (tmin > tmax)
+        {
+            std::swap(tmin, tmax);
+        }
+        dnear = std::max(dnear, tmin);
+        dfar = std::min(dfar, tmax);
+
+        // Check if the ray misses the box.
+        if (dnear > dfar || dfar < 0.0f)
+        {
+            return RRay::INTERSECTS_NONE;
+        }
+    }
+
+    // The ray origin may be inside the box.
+    return std::max(dnear, 0.0f);
+}
+
+API bool RBoundingOrientedBox::isEmpty() const
+{
+    return extents.x == 0.0f && extents.y == 0.0f && extents.z == 0.0f;
+}
+
+API void RBoundingOrientedBox::set(const RVector3& center, const RVector3& axisX, const RVector3& axisY, const RVector3& axisZ, const RVector3& extents)
+{
+    this->center = center;
+    axes[0] = axisX;
+    axes[1] = axisY;
+    axes[2] = axisZ;
+    this->extents = extents;
+}
+
+API void RBoundingOrientedBox::set(const RBoundingOrientedBox& box)
+{
+    set(box.center, box.axes[0], box.axes[1], box.axes[2], box.extents);
+}
+
+API void RBoundingOrientedBox::set(const RBoundingBox& box)
+{
+    set(box.getCenter(), RVector3::unitX(), RVector3::unitY(), RVector3::unitZ(), (box.max - box.min) * 0.5f);
+}
+
+API void RBoundingOrientedBox::set(const RTransform& transform, const RBoundingBox& localBox)
+{
+    RMatrix rotation;
+    RMatrix::createRotation(transform.getRotation(), &rotation);
+    axes[0].set(rotation.m[0], rotation.m[1], rotation.m[2]);
+    axes[1].set(rotation.m[4], rotation.m[5], rotation.m[6]);
+    axes[2].set(rotation.m[8], rotation.m[9], rotation.m[10]);
+
+    // center = T * R * S * localCenter, matching RTransform::getMatrix().
+    const RVector3& scale = transform.getScale();
+    RVector3 localCenter = localBox.getCenter();
+    RVector3 localExtents = (localBox.max - localBox.min) * 0.5f;
+    center = transform.getTranslation() +
+             axes[0] * (localCenter.x * scale.x) +
+             axes[1] * (localCenter.y * scale.y) +
+             axes[2] * (localCenter.z * scale.z);
+    extents.set(localExtents.x * fabsf(scale.x), localExtents.y * fabsf(scale.y), localExtents.z * fabsf(scale.z));
+}
+
+API void RBoundingOrientedBox::set(const RMatrix& matrix, const RBoundingBox& localBox)
+{
+    set(localBox);
+    transform(matrix);
+}
+
+/**
+ * Returns a unit vector perpendicular to the given unit vector.
+ */
+static RVector3 perpendicular(const RVector3& v)
+{
+    // Cross with the world axis least aligned with v, so the result never degenerates.
+    RVector3 axis = fabsf(v.x) < fabsf(v.y) ? (fabsf(v.x) < fabsf(v.z) ? RVector3::unitX() : RVector3::unitZ())
+                                              : (fabsf(v.y) < fabsf(v.z) ? RVector3::unitY() : RVector3::unitZ());
+    RVector3 dst;
+    RVector3::cross(v, axis, &dst);
+    dst.normalize();
+    return dst;
+}
+
+API void RBoundingOrientedBox::transform(const RMatrix& matrix)
+{
+    matrix.transformPoint(&center);
+
+    // The half-edges of the box carried through the matrix. Under non-uniform scale
+    // or shear they are no longer perpendicular, so the box became a parallelepiped.
+    const float e[3] = { extents.x, extents.y, extents.z };
+    RVector3 edges[3];
+    float lengths[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        matrix.transformVector(axes[i] * e[i], &edges[i]);
+        lengths[i] = edges[i].length();
+    }
+
+    // Orthonormalize the half-edges, longest first (Gram-Schmidt), keeping each axis in its slot.
+    int order[3] = { 0, 1, 2 };
+    std::sort(order, order + 3, [&](int a, int b) { return lengths[a] > lengths[b]; });
+    const int i0 = order[0], i1 = order[1], i2 = order[2];
+    if (lengths[i0] <= MATH_FLOAT_SMALL)
+    {
+        // Collapsed to a point; the old axes are as good as any.
+        extents.set(0.0f, 0.0f, 0.0f);
+        return;
+    }
+    axes[i0] = edges[i0] * (1.0f / lengths[i0]);
+    RVector3 second = edges[i1] - axes[i0] * edges[i1].dot(axes[i0]);
+    float secondLength = second.length();
+    axes[i1] = secondLength > MATH_EPSILON * lengths[i0] ? second * (1.0f / secondLength) : perpendicular(axes[i0]);
+    RVector3::cross(axes[i0], axes[i1], &axes[i2]);
+    if (axes[i2].dot(edges[i2]) < 0.0f)
+    {
+        axes[i2].negate();
+    }
+
+    // Grow each extent to the parallelepiped's reach along the new axis, so the box still
+    // contains it. Without scale or shear the half-edges are the axes and this is exact.
+    float* dst[3] = { &extents.x, &extents.y, &extents.z };
+    for (int k = 0; k < 3; ++k)
+    {
+        *dst[k] = fabsf(edges[0].dot(axes[k])) + fabsf(edges[1].dot(axes[k])) + fabsf(edges[2].dot(axes[k]));
+    }
+}
+
+// Point sets are only spread across threads once a chunk holds this many points in total.
+static const unsigned int MIN_POINTS_PER_CHUNK = 1 << 15;
+
+API void RBoundingOrientedBox::createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount, RBoundingOrientedBox* dst,
+                                                RJobSystem* jobs)
+{
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    RMath::forEachChunk(setCount, RMath::getChunkCount(counts, setCount, MIN_POINTS_PER_CHUNK, jobs), [&](unsigned int, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            dst[i].set(points[i], counts[i]);
+        }
+    }, jobs);
+}
+
+/**
+ * Computes the rotation (c, s) that zeroes a[p][q] of a symmetric matrix.
+ */
+static void symmetricSchur2(const double a[3][3], int p, int q, double* c, double* s)
+{
+    if (fabs(a[p][q]) > 1.0e-30)
+    {
+        double r = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+        double t = (r >= 0.0) ? 1.0 / (r + sqrt(1.0 + r * r)) : -1.0 / (-r + sqrt(1.0 + r * r));
+        *c = 1.0 / sqrt(1.0 + t * t);
+        *s = t * *c;
+    }
+    else
+    {
+        *c = 1.0;
+        *s = 0.0;
+    }
+}
+
+/**
+ * Diagonalizes the symmetric matrix a with cyclic Jacobi rotations, storing the
+ * eigenvectors in the columns of v (Ericson, Real-Time Collision Detection, 4.3.3).
+ */
+static void jacobi(double a[3][3], double v[3][3])
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            v[i][j] = (i == j) ? 1.0 : 0.0;
+        }
+    }
+
+    double previousOff = DBL_MAX;
+    for (int n = 0; n < 50; ++n)
+    {
+        // Pick the largest off-diagonal element.
+        int p = 0;
+        int q = 1;
+        if (fabs(a[0][2]) > fabs(a[p][q]))
+        {
+            q = 2;
+        }
+        if (fabs(a[1][2]) > fabs(a[p][q]))
+        {
+            p = 1;
+            q = 2;
+        }
+
+        double c, s;
+        symmetricSchur2(a, p, q, &c, &s);
+
+        double j[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+        j[p][p] = c;
+        j[p][q] = s;
+        j[q][p] = -s;
+        j[q][q] = c;
+
+        // v = v * j and a = j^T * a * j.
+        double t[3][3];
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                t[r][k] = v[r][0] * j[0][k] + v[r][1] * j[1][k] + v[r][2] * j[2][k];
+            }
+        }
+        memcpy(v, t, sizeof(t));
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                t[r][k] = a[r][0] * j[0][k] + a[r][1] * j[1][k] + a[r][2] * j[2][k];
+            }
+        }
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                a[r][k] = j[0][r] * t[0][k] + j[1][r] * t[1][k] + j[2][r] * t[2][k];
+            }
+        }
+
+        // Stop once the off-diagonal sum stops decreasing.
+        double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+        if (n > 2 && off >= previousOff)
+        {
+            return;
+        }
+        previousOff = off;
+    }
+}
+
+API void RBoundingOrientedBox::set(const RVector3* points, unsigned int count, RJobSystem* jobs)
+{
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    if (count == 0)
+    {
+        set(empty());
+        return;
+    }
+
+    unsigned int chunkCount = RMath::getChunkCount(count, MIN_POINTS_PER_CHUNK, jobs);
+
+    // Mean of the points, accumulated in double to stay accurate over millions of points.
+    std::vector<double> sums(chunkCount * 3, 0.0);
+    RMath::forEachChunk(count, chunkCount, [&](unsigned int chunk, unsigned int begin, unsigned int end)
+    {
+        double x = 0.0, y = 0.0, z = 0.0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            x += points[i].x;
+            y += points[i].y;
+            z += points[i].z;
+        }
+        sums[chunk * 3] = x;
+        sums[chunk * 3 + 1] = y;
+        sums[chunk * 3 + 2] = z;
+    }, jobs);
+    double mean[3] = { 0.0, 0.0, 0.0 };
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        mean[0] += sums[chunk * 3];
+        mean[1] += sums[chunk * 3 + 1];
+        mean[2] += sums[chunk * 3 + 2];
+    }
+    mean[0] /= count;
+    mean[1] /= count;
+    mean[2] /= count;
+
+    // Covariance of the points about the mean (xx, xy, xz, yy, yz, zz).
+    std::vector<double> moments(chunkCount * 6, 0.0);
+    RMath::forEachChunk(count, chunkCount, [&](unsigned int chunk, unsigned int begin, unsigned int end)
+    {
+        double xx = 0.0, xy = 0.0, xz = 0.0, yy = 0.0, yz = 0.0, zz = 0.0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            double x = points[i].x - mean[0];
+            double y = points[i].y - mean[1];
+            double z = points[i].z - mean[2];
+            xx += x * x;
+            xy += x * y;
+            xz += x * z;
+            yy += y * y;
+            yz += y * z;
+            zz += z * z;
+        }
+        double* m = &moments[chunk * 6];
+        m[0] = xx;
+        m[1] = xy;
+        m[2] = xz;
+        m[3] = yy;
+        m[4] = yz;
+        m[5] = zz;
+    }, jobs);
+    double c[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        for (int i = 0; i < 6; ++i)
+        {
+            c[i] += moments[chunk * 6 + i];
+        }
+    }
+    double covariance[3][3] =
+    {
+        { c[0], c[1], c[2] },
+        { c[1], c[3], c[4] },
+        { c[2], c[4], c[5] }
+    };
+
+    // The eigenvectors of the covariance matrix are the principal axes.
+    double v[3][3];
+    jacobi(covariance, v);
+    axes[0].set((float)v[0][0], (float)v[1][0], (float)v[2][0]);
+    axes[1].set((float)v[0][1], (float)v[1][1], (float)v[2][1]);
+    axes[0].normalize();
+    axes[1].normalize();
+    RVector3::cross(axes[0], axes[1], &axes[2]);
+    axes[2].normalize();
+
+    // Range of the points along each axis.
+    std::vector<float> ranges(chunkCount * 6);
+    RMath::forEachChunk(count, chunkCount, [&](unsigned int chunk, unsigned int begin, unsigned int end)
+    {
+        float* r = &ranges[chunk * 6];
+        for (int a = 0; a < 3; ++a)
+        {
+            r[a] = FLT_MAX;
+            r[a + 3] = -FLT_MAX;
+        }
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                float d = points[i].dot(axes[a]);
+                r[a] = std::min(r[a], d);
+                r[a + 3] = std::max(r[a + 3], d);
+            }
+        }
+    }, jobs);
+    float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+    float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    for (unsigned int chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            minimum[a] = std::min(minimum[a], ranges[chunk * 6 + a]);
+            maximum[a] = std::max(maximum[a], ranges[chunk * 6 + a + 3]);
+        }
+    }
+
+    center = axes[0] * ((minimum[0] + maximum[0]) * 0.5f) +
+             axes[1] * ((minimum[1] + maximum[1]) * 0.5f) +
+             axes[2] * ((minimum[2] + maximum[2]) * 0.5f);
+    extents.set((maximum[0] - minimum[0]) * 0.5f, (maximum[1] - minimum[1]) * 0.5f, (maximum[2] - minimum[2]) * 0.5f);
+}
+
+}
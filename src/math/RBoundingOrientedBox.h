@@ -0,0 +1,258 @@
+#pragma once
+
+#include "common.h"
+#include "RVector3.h"
+#include "RFrustum.h"
+
+namespace rocket
+{
+
+class RTransform;
+
+/**
+ * Defines a 3-dimensional oriented bounding box.
+ *
+ * The box is stored in center-extent form: a center point, three orthonormal
+ * axes and the half-size of the box along each axis. Unlike BoundingBox it
+ * stays tight when the object it bounds is rotated.
+ */
+class API RBoundingOrientedBox
+{
+public:
+
+    /**
+     * The center point.
+     */
+    RVector3 center;
+
+    /**
+     * The local x, y and z axes of the box in world space. These are orthonormal.
+     */
+    RVector3 axes[3];
+
+    /**
+     * The half-size of the box along each of its axes.
+     */
+    RVector3 extents;
+
+    /**
+     * Constructs an empty bounding box at the origin, aligned with the world axes.
+     */
+    RBoundingOrientedBox();
+
+    /**
+     * Constructs a new oriented bounding box from the specified values.
+     *
+     * @param center The center of the box.
+     * @param axisX The local x axis of the box.
+     * @param axisY The local y axis of the box.
+     * @param axisZ The local z axis of the box.
+     * @param extents The half-size of the box along each of its axes.
+     */
+    RBoundingOrientedBox(const RVector3& center, const RVector3& axisX, const RVector3& axisY, const RVector3& axisZ, const RVector3& extents);
+
+    /**
+     * Constructs a new oriented bounding box from the given one.
+     *
+     * @param copy The oriented bounding box to copy.
+     */
+    RBoundingOrientedBox(const RBoundingOrientedBox& copy);
+
+    /**
+     * Destructor.
+     */
+    ~RBoundingOrientedBox();
+
+    /**
+     * Returns an empty oriented bounding box.
+     */
+    static const RBoundingOrientedBox& empty();
+
+    /**
+     * Gets the corners of the oriented bounding box in the specified array.
+     *
+     * The corners are ordered like BoundingBox::getCorners(), in the local frame of the box.
+     *
+     * @param dst The array to store the corners in. Must be size 8.
+     */
+    void getCorners(RVector3* dst) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified oriented bounding box.
+     *
+     * This is an exact separating axis test over the 15 candidate axes (the face
+     * normals of both boxes and the cross products of their edges).
+     *
+     * @param box The oriented bounding box to test intersection with.
+     *
+     * @return true if the specified oriented bounding box intersects this one; false otherwise.
+     */
+    bool intersects(const RBoundingOrientedBox& box) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified axis-aligned bounding box.
+     *
+     * @param box The bounding box to test intersection with.
+     *
+     * @return true if the specified bounding box intersects this oriented bounding box; false otherwise.
+     */
+    bool intersects(const RBoundingBox& box) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified bounding sphere.
+     *
+     * @param sphere The bounding sphere to test intersection with.
+     *
+     * @return true if the specified bounding sphere intersects this oriented bounding box; false otherwise.
+     */
+    bool intersects(const RBoundingSphere& sphere) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified RFrustum.
+     *
+     * Like BoundingBox, the box is only rejected when it is entirely behind one of the
+     * planes, so boxes near the frustum corners may be reported as intersecting.
+     *
+     * @param frustum The RFrustum to test intersection with.
+     *
+     * @return true if this oriented bounding box intersects the specified RFrustum; false otherwise.
+     */
+    bool intersects(const RFrustum& frustum) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified plane.
+     *
+     * @param plane The plane to test intersection with.
+     *
+     * @return RPlane::INTERSECTS_BACK if this box is in the negative half-space of the plane,
+     *  RPlane::INTERSECTS_FRONT if it is in the positive half-space of the plane,
+     *  and RPlane::INTERSECTS_INTERSECTING if it intersects the plane.
+     */
+    float intersects(const RPlane& plane) const;
+
+    /**
+     * Tests whether this oriented bounding box intersects the specified ray.
+     *
+     * @param ray The ray to test intersection with.
+     *
+     * @return The distance from the origin of the ray to this box or
+     *  RRay::INTERSECTS_NONE if the ray does not intersect this box.
+     */
+    float intersects(const RRay& ray) const;
+
+    /**
+     * Determines if this oriented bounding box is empty.
+     *
+     * @return true if this oriented bounding box is empty; false otherwise.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Sets this oriented bounding box to the specified values.
+     *
+     * @param center The center of the box.
+     * @param axisX The local x axis of the box.
+     * @param axisY The local y axis of the box.
+     * @param axisZ The local z axis of the box.
+     * @param extents The half-size of the box along each of its axes.
+     */
+    void set(const RVector3& center, const RVector3& axisX, const RVector3& axisY, const RVector3& axisZ, const RVector3& extents);
+
+    /**
+     * Sets this oriented bounding box to the specified oriented bounding box.
+     *
+     * @param box The oriented bounding box to set to.
+     */
+    void set(const RBoundingOrientedBox& box);
+
+    /**
+     * Sets this box to the specified axis-aligned box.
+     *
+     * @param box The bounding box to set to.
+     */
+    void set(const RBoundingBox& box);
+
+    /**
+     * Sets this box to the given local axis-aligned box placed by a transform.
+     *
+     * The axes come straight from the transform's rotation and the extents are scaled by
+     * its scale, so unlike BoundingBox::transform() the result is exact and no corners
+     * are transformed.
+     *
+     * @param transform The transform placing the box.
+     * @param localBox The box in the local space of the transform.
+     */
+    void set(const RTransform& transform, const RBoundingBox& localBox);
+
+    /**
+     * Sets this box to the given local axis-aligned box placed by an affine matrix.
+     *
+     * The axes are the orthonormalized basis vectors of the matrix, as in transform(), so
+     * a matrix with shear gives a box that contains the sheared one.
+     *
+     * @param matrix The affine matrix placing the box.
+     * @param localBox The box in the local space of the matrix.
+     */
+    void set(const RMatrix& matrix, const RBoundingBox& localBox);
+
+    /**
+     * Sets this box to an oriented box fitted to the specified points.
+     *
+     * The axes are the eigenvectors of the covariance matrix of the points (principal
+     * component analysis), and the extents are the range of the points along those axes.
+     * This is not the minimal-volume box, but it is close for the elongated point sets
+     * typical of meshes. The mean, covariance and projection passes are split across
+     * the job system's threads for large point sets.
+     *
+     * @param points The points to contain.
+     * @param count The number of points.
+     * @param jobs The job system to split large point sets across, or null to run on the calling thread.
+     */
+    void set(const RVector3* points, unsigned int count, RJobSystem* jobs = nullptr);
+
+    /**
+     * Computes the oriented bounding boxes of several point sets (for example all the
+     * meshes of a model), distributing the point sets across the job system's threads.
+     *
+     * @param points The point sets.
+     * @param counts The number of points in each point set.
+     * @param setCount The number of point sets.
+     * @param dst An array of setCount oriented bounding boxes to store the results in.
+     * @param jobs The job system to distribute the point sets across, or null to run on the calling thread.
+     */
+    static void createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount, RBoundingOrientedBox* dst,
+                                 RJobSystem* jobs = nullptr);
+
+    /**
+     * Transforms the oriented bounding box by the given affine transformation matrix.
+     *
+     * Under rotation, translation and uniform scale the result is exact. Non-uniform
+     * scale or shear skews the box, so its axes are orthonormalized again and the
+     * extents grown until the box contains the skewed one.
+     *
+     * @param matrix The transformation matrix to transform by.
+     */
+    void transform(const RMatrix& matrix);
+
+    /**
+     * Transforms this oriented bounding box by the given matrix.
+     *
+     * @param matrix The matrix to transform by.
+     * @return This oriented bounding box, after the transformation occurs.
+     */
+    inline RBoundingOrientedBox& operator*=(const RMatrix& matrix);
+
+};
+
+/**
+ * Transforms the given oriented bounding box by the given matrix.
+ *
+ * @param matrix The matrix to transform by.
+ * @param box The oriented bounding box to transform.
+ * @return The resulting transformed oriented bounding box.
+ */
+API inline const RBoundingOrientedBox operator*(const RMatrix& matrix, const RBoundingOrientedBox& box);
+
+}
+
+#include "RBoundingOrientedBox.inl"
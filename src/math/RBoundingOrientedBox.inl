@@ -0,0 +1,20 @@
+#include "common.h"
+#include "RBoundingOrientedBox.h"
+
+namespace rocket
+{
+
+API inline RBoundingOrientedBox& RBoundingOrientedBox::operator*=(const RMatrix& matrix)
+{
+    transform(matrix);
+    return *this;
+}
+
+API inline const RBoundingOrientedBox operator*(const RMatrix& matrix, const RBoundingOrientedBox& box)
+{
+    RBoundingOrientedBox b(box);
+    b.transform(matrix);
+    return b;
+}
+
+}
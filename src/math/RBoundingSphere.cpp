@@ -1,6 +1,7 @@
 #include "common.h"
 #include "RBoundingSphere.h"
 #include "RBoundingBox.h"
+#include "RMath.h"
 
 using std::max;
 
@@ -305,6 +306,160 @@ API void RBoundingSphere::transform(const RMatrix& matrix)
     radius = r;
 }
 
+// Directions used to find extremal points: the three axes and the four cube diagonals.
+static const float EXTREMAL_DIRECTIONS[7][3] =
+{
+    { 1.0f,  0.0f,  0.0f },
+    { 0.0f,  1.0f,  0.0f },
+    { 0.0f,  0.0f,  1.0f },
+    { 1.0f,  1.0f,  1.0f },
+    { 1.0f,  1.0f, -1.0f },
+    { 1.0f, -1.0f,  1.0f },
+    { 1.0f, -1.0f, -1.0f }
+};
+
+struct ExtremalPoints
+{
+    unsigned int minIndex[7];
+    unsigned int maxIndex[7];
+    float minValue[7];
+    float maxValue[7];
+};
+
+static void findExtremalPoints(const RVector3* points, unsigned int begin, unsigned int end, ExtremalPoints* dst)
+{
+    for (int d = 0; d < 7; ++d)
+    {
+        dst->minIndex[d] = dst->maxIndex[d] = begin;
+        dst->minValue[d] = FLT_MAX;
+        dst->maxValue[d] = -FLT_MAX;
+    }
+
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        const RVector3& p = points[i];
+        for (int d = 0; d < 7; ++d)
+        {
+            float v = p.x * EXTREMAL_DIRECTIONS[d][0] + p.y * EXTREMAL_DIRECTIONS[d][1] + p.z * EXTREMAL_DIRECTIONS[d][2];
+            if (v < dst->minValue[d])
+            {
+                dst->minValue[d] = v;
+                dst->minIndex[d] = i;
+            }
+            if (v > dst->maxValue[d])
+            {
+                dst->maxValue[d] = v;
+                dst->maxIndex[d] = i;
+            }
+        }
+    }
+}
+
+// Point sets are only spread across threads once a chunk holds this many points in total.
+static const unsigned int MIN_POINTS_PER_CHUNK = 1 << 15;
+
+API void RBoundingSphere::createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount,
+                                           RBoundingSphere* dst, unsigned int refinements, RJobSystem* jobs)
+{
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    RMath::forEachChunk(setCount, RMath::getChunkCount(counts, setCount, MIN_POINTS_PER_CHUNK, jobs), [&](unsigned int, unsigned int begin, unsigned int end)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            dst[i].set(points[i], counts[i], refinements);
+        }
+    }, jobs);
+}
+
+API void RBoundingSphere::set(const RVector3* points, unsigned int count, unsigned int refinements, RJobSystem* jobs)
+{
+    RMemoryScope scope(RMemoryTracker::TAG_MATH);
+    if (count == 0)
+    {
+        set(RVector3::zero(), 0.0f);
+        return;
+    }
+
+    // Find the extremal points along each direction, per chunk, then reduce.
+    unsigned int chunkCount = RMath::getChunkCount(count, MIN_POINTS_PER_CHUNK, jobs);
+    std::vector<ExtremalPoints> partial(chunkCount);
+    RMath::forEachChunk(count, chunkCount, [&](unsigned int chunk, unsigned int begin, unsigned int end)
+    {
+        findExtremalPoints(points, begin, end, &partial[chunk]);
+    }, jobs);
+    ExtremalPoints& extremal = partial[0];
+    for (unsigned int i = 1; i < chunkCount; ++i)
+    {
+        for (int d = 0; d < 7; ++d)
+        {
+            if (partial[i].minValue[d] < extremal.minValue[d])
+            {
+                extremal.minValue[d] = partial[i].minValue[d];
+                extremal.minIndex[d] = partial[i].minIndex[d];
+            }
+            if (partial[i].maxValue[d] > extremal.maxValue[d])
+            {
+                extremal.maxValue[d] = partial[i].maxValue[d];
+                extremal.maxIndex[d] = partial[i].maxIndex[d];
+            }
+        }
+    }
+
+    // Seed the sphere with the most distant pair of extremal points.
+    float maxDistanceSquared = -1.0f;
+    for (int d = 0; d < 7; ++d)
+    {
+        const RVector3& p1 = points[extremal.minIndex[d]];
+        const RVector3& p2 = points[extremal.maxIndex[d]];
+        float distanceSquared = p1.distanceSquared(p2);
+        if (distanceSquared > maxDistanceSquared)
+        {
+            maxDistanceSquared = distanceSquared;
+            center.set((p1.x + p2.x) * 0.5f, (p1.y + p2.y) * 0.5f, (p1.z + p2.z) * 0.5f);
+            radius = sqrt(distanceSquared) * 0.5f;
+        }
+    }
+
+    // Ritter's pass: grow the sphere to include every point.
+    grow(points, count, false);
+
+    // Refine by shrinking and regrowing, alternating the traversal order.
+    for (unsigned int i = 0; i < refinements; ++i)
+    {
+        RBoundingSphere candidate(center, radius * 0.95f);
+        candidate.grow(points, count, (i & 1) == 0);
+        if (candidate.radius < radius)
+        {
+            set(candidate);
+        }
+    }
+}
+
+API void RBoundingSphere::grow(const RVector3* points, unsigned int count, bool reverse)
+{
+    float radiusSquared = radius * radius;
+    for (unsigned int n = 0; n < count; ++n)
+    {
+        const RVector3& p = points[reverse ? count - 1 - n : n];
+        float dx = p.x - center.x;
+        float dy = p.y - center.y;
+        float dz = p.z - center.z;
+        float distanceSquared = dx * dx + dy * dy + dz * dz;
+        if (distanceSquared > radiusSquared)
+        {
+            // Move the center towards the point so the far side of the sphere stays in place.
+            float distance = sqrt(distanceSquared);
+            float newRadius = (radius + distance) * 0.5f;
+            float k = (newRadius - radius) / distance;
+            center.x += dx * k;
+            center.y += dy * k;
+            center.z += dz * k;
+            radius = newRadius;
+            radiusSquared = radius * radius;
+        }
+    }
+}
+
 API float RBoundingSphere::distance(const RBoundingSphere& sphere, const RVector3& point)
 {
     return sqrt((point.x - sphere.center.x) * (point.x - sphere.center.x) +
@@ -145,6 +145,37 @@ public:
      */
     void set(const RBoundingBox& box);
 
+    /**
+     * Sets this bounding sphere to a tight sphere that contains the specified points.
+     *
+     * This uses Ritter's algorithm seeded with the most distant pair among the extremal
+     * points along seven directions (the axes and the cube diagonals), which is usually
+     * much tighter than seeding from the axes alone. Each refinement iteration then shrinks
+     * the sphere and regrows it over the points, keeping the result if it is smaller
+     * (Ericson, Real-Time Collision Detection, 4.3.5). The extremal point search is split
+     * across the job system's threads for large point sets.
+     *
+     * @param points The points to contain.
+     * @param count The number of points.
+     * @param refinements The number of shrink and regrow iterations.
+     * @param jobs The job system to split large point sets across, or null to run on the calling thread.
+     */
+    void set(const RVector3* points, unsigned int count, unsigned int refinements = 4, RJobSystem* jobs = nullptr);
+
+    /**
+     * Computes the bounding spheres of several point sets (for example all the meshes of a model),
+     * distributing the point sets across the job system's threads.
+     *
+     * @param points The point sets.
+     * @param counts The number of points in each point set.
+     * @param setCount The number of point sets.
+     * @param dst An array of setCount bounding spheres to store the results in.
+     * @param refinements The number of shrink and regrow iterations.
+     * @param jobs The job system to distribute the point sets across, or null to run on the calling thread.
+     */
+    static void createFromPoints(const RVector3* const* points, const unsigned int* counts, unsigned int setCount,
+                                 RBoundingSphere* dst, unsigned int refinements = 4, RJobSystem* jobs = nullptr);
+
     /**
      * Transforms the bounding sphere by the given transformation matrix.
      *
@@ -165,6 +196,8 @@ private:
     float distance(const RBoundingSphere& sphere, const RVector3&);
 
     bool contains(const RBoundingSphere& sphere, RVector3* points, unsigned int count);
+
+    void grow(const RVector3* points, unsigned int count, bool reverse);
 };
 
 /**
@@ -2,6 +2,7 @@
 #include "RFrustum.h"
 #include "RBoundingSphere.h"
 #include "RBoundingBox.h"
+#include "RBoundingOrientedBox.h"
 #include "RMatrix.h"
 #include "RVector3.h"
 
@@ -117,6 +118,11 @@ bool RFrustum::intersects(const RBoundingBox& box) const
     return box.intersects(*this);
 }
 
+bool RFrustum::intersects(const RBoundingOrientedBox& box) const
+{
+    return box.intersects(*this);
+}
+
 float RFrustum::intersects(const RPlane& plane) const
 {
     return plane.intersects(*this);
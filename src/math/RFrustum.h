@@ -169,6 +169,15 @@ public:
      */
     bool intersects(const RBoundingBox& box) const;
 
+    /**
+     * Tests whether this RFrustum intersects the specified oriented bounding box.
+     *
+     * @param box The oriented bounding box to test intersection with.
+     * 
+     * @return true if the specified oriented bounding box intersects this RFrustum; false otherwise.
+     */
+    bool intersects(const RBoundingOrientedBox& box) const;
+
     /**
      * Tests whether this RFrustum intersects the specified plane.
      *
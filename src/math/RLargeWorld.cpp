@@ -0,0 +1,48 @@
+#include "common.h"
+#include "RLargeWorld.h"
+#include "RTransform.h"
+
+namespace rocket
+{
+
+template class RVector3T<double>;
+template class RMatrixT<double>;
+template class RBoundingBoxT<double>;
+
+API void RCameraRelative::createWorld(const RMatrixd& world, const RVector3d& cameraPosition, RMatrix* dst)
+{
+    world.relativeTo(cameraPosition, dst);
+}
+
+API void RCameraRelative::createWorld(const RTransform& transform, const RVector3d& origin, const RVector3d& cameraPosition, RMatrix* dst)
+{
+    // Only the translation needs double precision: (origin + t) - camera.
+    RVector3d translation = origin + RVector3d(transform.getTranslation());
+
+    // Compose the matrix in TRS order, matching RTransform::getMatrix().
+    RMatrix::createTranslation(translation.relativeTo(cameraPosition), dst);
+    if (!transform.getRotation().isIdentity())
+    {
+        dst->rotate(transform.getRotation());
+    }
+    if (!transform.getScale().isOne())
+    {
+        dst->scale(transform.getScale());
+    }
+}
+
+API void RCameraRelative::createView(const RVector3d& cameraPosition, const RVector3d& targetPosition, const RVector3& up, RMatrix* dst)
+{
+    RMatrix::createLookAt(RVector3::zero(), targetPosition.relativeTo(cameraPosition), up, dst);
+}
+
+API void RCameraRelative::createView(const RQuaternion& cameraRotation, RMatrix* dst)
+{
+    // The view matrix of a camera at the origin is the inverse of its rotation,
+    // which for a unit quaternion is the rotation by its conjugate.
+    RQuaternion inverse;
+    cameraRotation.conjugate(&inverse);
+    RMatrix::createRotation(inverse, dst);
+}
+
+}
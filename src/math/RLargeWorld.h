@@ -0,0 +1,404 @@
+#pragma once
+
+#include "common.h"
+#include "RVector3.h"
+#include "RQuaternion.h"
+#include "RMatrix.h"
+#include "RBoundingBox.h"
+
+namespace rocket
+{
+
+class RTransform;
+
+/**
+ * Defines a 3-element vector with a configurable scalar precision.
+ *
+ * This is the large-world counterpart of RVector3. It is intended to hold absolute
+ * world positions (object origins, camera positions, streaming cell origins) that
+ * exceed the precision of a float at a few kilometers from the origin.
+ * It is not meant for inner loops; positions should be rebased to a local
+ * origin (typically the camera) and converted to float with relativeTo().
+ */
+template <typename T>
+class RVector3T
+{
+public:
+
+    /**
+     * The x-coordinate.
+     */
+    T x;
+
+    /**
+     * The y-coordinate.
+     */
+    T y;
+
+    /**
+     * The z-coordinate.
+     */
+    T z;
+
+    /**
+     * Constructs a new vector initialized to all zeros.
+     */
+    RVector3T();
+
+    /**
+     * Constructs a new vector initialized to the specified values.
+     *
+     * @param x The x coordinate.
+     * @param y The y coordinate.
+     * @param z The z coordinate.
+     */
+    RVector3T(T x, T y, T z);
+
+    /**
+     * Constructs a new vector from the given single precision vector.
+     *
+     * @param v The vector to widen.
+     */
+    explicit RVector3T(const RVector3& v);
+
+    /**
+     * Returns the zero vector.
+     *
+     * @return The 3-element vector of 0s.
+     */
+    static const RVector3T& zero();
+
+    /**
+     * Returns the dot product of this vector and the specified vector.
+     *
+     * @param v The vector to compute the dot product with.
+     *
+     * @return The dot product.
+     */
+    T dot(const RVector3T& v) const;
+
+    /**
+     * Returns the distance between this vector and v.
+     *
+     * @param v The other vector.
+     *
+     * @return The distance between this vector and v.
+     */
+    T distance(const RVector3T& v) const;
+
+    /**
+     * Computes the length of this vector.
+     *
+     * @return The length of the vector.
+     */
+    T length() const;
+
+    /**
+     * Sets the elements of this vector to the specified values.
+     *
+     * @param x The new x coordinate.
+     * @param y The new y coordinate.
+     * @param z The new z coordinate.
+     */
+    void set(T x, T y, T z);
+
+    /**
+     * Narrows this vector to single precision.
+     *
+     * Precision is lost for large coordinates; use relativeTo() for positions.
+     *
+     * @return The single precision vector.
+     */
+    RVector3 toFloat() const;
+
+    /**
+     * Computes this position relative to the given origin and narrows it to single precision.
+     *
+     * The subtraction happens at full precision, so the result keeps sub-millimeter
+     * accuracy as long as it is close to the origin, regardless of how far the origin
+     * itself is from the world origin.
+     *
+     * @param origin The origin to rebase to (typically the camera position).
+     *
+     * @return The rebased single precision vector.
+     */
+    RVector3 relativeTo(const RVector3T& origin) const;
+
+    inline const RVector3T operator+(const RVector3T& v) const;
+
+    inline RVector3T& operator+=(const RVector3T& v);
+
+    inline const RVector3T operator-(const RVector3T& v) const;
+
+    inline RVector3T& operator-=(const RVector3T& v);
+
+    inline const RVector3T operator-() const;
+
+    inline const RVector3T operator*(T s) const;
+
+    inline bool operator==(const RVector3T& v) const;
+
+    inline bool operator!=(const RVector3T& v) const;
+};
+
+/**
+ * Defines a 4 x 4 column-major matrix with a configurable scalar precision.
+ *
+ * The memory layout matches RMatrix. Only the operations needed to compose
+ * world matrices and rebase them for rendering are provided; everything else
+ * should happen on the single precision RMatrix after rebasing.
+ */
+template <typename T>
+class RMatrixT
+{
+public:
+
+    /**
+     * Stores the columns of this 4x4 matrix.
+     */
+    T m[16];
+
+    /**
+     * Constructs a matrix initialized to the identity matrix.
+     */
+    RMatrixT();
+
+    /**
+     * Constructs a matrix by widening the specified single precision matrix.
+     *
+     * @param matrix The matrix to widen.
+     */
+    explicit RMatrixT(const RMatrix& matrix);
+
+    /**
+     * Creates a translation matrix.
+     *
+     * @param translation The translation.
+     * @param dst A matrix to store the result in.
+     */
+    static void createTranslation(const RVector3T<T>& translation, RMatrixT* dst);
+
+    /**
+     * Creates a world matrix from the scale and rotation of the given transform
+     * and a translation given at full precision.
+     *
+     * This is the usual way to place an object whose local RTransform is kept
+     * in single precision relative to a large-world origin (such as a streaming cell).
+     *
+     * @param transform The transform providing scale, rotation and the local translation.
+     * @param origin The world origin the transform's translation is relative to.
+     * @param dst A matrix to store the result in.
+     */
+    static void createFromTransform(const RTransform& transform, const RVector3T<T>& origin, RMatrixT* dst);
+
+    /**
+     * Multiplies the specified matrices and stores the result in dst.
+     *
+     * @param m1 The first matrix.
+     * @param m2 The second matrix.
+     * @param dst The matrix to store the result in.
+     */
+    static void multiply(const RMatrixT& m1, const RMatrixT& m2, RMatrixT* dst);
+
+    /**
+     * Gets the translational component of this matrix.
+     *
+     * @param translation A vector to receive the translation.
+     */
+    void getTranslation(RVector3T<T>* translation) const;
+
+    /**
+     * Sets this matrix to the identity matrix.
+     */
+    void setIdentity();
+
+    /**
+     * Sets the translational component of this matrix.
+     *
+     * @param translation The translation.
+     */
+    void setTranslation(const RVector3T<T>& translation);
+
+    /**
+     * Transforms the specified point by this matrix, and stores the result in dst.
+     *
+     * @param point The point to transform.
+     * @param dst A vector to store the transformed point in.
+     */
+    void transformPoint(const RVector3T<T>& point, RVector3T<T>* dst) const;
+
+    /**
+     * Narrows this matrix to single precision.
+     *
+     * @param dst A matrix to store the result in.
+     */
+    void toFloat(RMatrix* dst) const;
+
+    /**
+     * Rebases this matrix to the given origin and narrows it to single precision.
+     *
+     * The translation is made relative to the origin at full precision before the
+     * conversion, so the result is free of jitter near the origin. Combine the
+     * result with a view matrix built with the camera at the origin
+     * (see RCameraRelative::createView).
+     *
+     * @param origin The origin to rebase to (typically the camera position).
+     * @param dst A matrix to store the result in.
+     */
+    void relativeTo(const RVector3T<T>& origin, RMatrix* dst) const;
+
+    inline const RMatrixT operator*(const RMatrixT& m) const;
+};
+
+/**
+ * Defines an axis-aligned bounding box with a configurable scalar precision.
+ */
+template <typename T>
+class RBoundingBoxT
+{
+public:
+
+    /**
+     * The minimum point.
+     */
+    RVector3T<T> min;
+
+    /**
+     * The maximum point.
+     */
+    RVector3T<T> max;
+
+    /**
+     * Constructs an empty bounding box at the origin.
+     */
+    RBoundingBoxT();
+
+    /**
+     * Constructs a new bounding box from the specified values.
+     *
+     * @param min The minimum point of the bounding box.
+     * @param max The maximum point of the bounding box.
+     */
+    RBoundingBoxT(const RVector3T<T>& min, const RVector3T<T>& max);
+
+    /**
+     * Constructs a bounding box by offsetting a single precision box by the given origin.
+     *
+     * @param box The box, relative to origin.
+     * @param origin The origin the box is relative to.
+     */
+    RBoundingBoxT(const RBoundingBox& box, const RVector3T<T>& origin);
+
+    /**
+     * Gets the center point of the bounding box.
+     *
+     * @return The center point of the bounding box.
+     */
+    RVector3T<T> getCenter() const;
+
+    /**
+     * Tests whether this bounding box intersects the specified bounding box.
+     *
+     * @param box The bounding box to test intersection with.
+     *
+     * @return true if the specified bounding box intersects this bounding box; false otherwise.
+     */
+    bool intersects(const RBoundingBoxT& box) const;
+
+    /**
+     * Sets this bounding box to the smallest bounding box
+     * that contains both this bounding box and the specified bounding box.
+     *
+     * @param box The bounding box to merge with.
+     */
+    void merge(const RBoundingBoxT& box);
+
+    /**
+     * Sets this bounding box to the specified values.
+     *
+     * @param min The minimum point of the bounding box.
+     * @param max The maximum point of the bounding box.
+     */
+    void set(const RVector3T<T>& min, const RVector3T<T>& max);
+
+    /**
+     * Transforms the bounding box by the given transformation matrix.
+     *
+     * @param matrix The transformation matrix to transform by.
+     */
+    void transform(const RMatrixT<T>& matrix);
+
+    /**
+     * Rebases this bounding box to the given origin and narrows it to single precision.
+     *
+     * @param origin The origin to rebase to (typically the camera position).
+     * @param dst A bounding box to store the result in.
+     */
+    void relativeTo(const RVector3T<T>& origin, RBoundingBox* dst) const;
+};
+
+using RVector3d = RVector3T<double>;
+using RMatrixd = RMatrixT<double>;
+using RBoundingBoxd = RBoundingBoxT<double>;
+
+/**
+ * Defines helpers for camera-relative rendering of large worlds.
+ *
+ * World positions are kept in double precision, and every matrix handed to the
+ * renderer is rebased so that the camera sits at the origin. The subtraction is
+ * done in double, and only the small camera-relative result is converted to float,
+ * which removes vertex jitter far from the world origin while all per-vertex and
+ * per-object inner loops keep running in single precision.
+ */
+class API RCameraRelative
+{
+public:
+
+    /**
+     * Creates a camera-relative world matrix from a double precision world matrix.
+     *
+     * @param world The world matrix of the object.
+     * @param cameraPosition The world position of the camera.
+     * @param dst A matrix to store the result in.
+     */
+    static void createWorld(const RMatrixd& world, const RVector3d& cameraPosition, RMatrix* dst);
+
+    /**
+     * Creates a camera-relative world matrix from a transform that is relative to a large-world origin.
+     *
+     * Only the translation is computed in double precision; the rotation and scale are
+     * composed in single precision exactly like RTransform::getMatrix().
+     *
+     * @param transform The transform of the object, relative to origin.
+     * @param origin The world origin the transform is relative to (for example a streaming cell origin).
+     * @param cameraPosition The world position of the camera.
+     * @param dst A matrix to store the result in.
+     */
+    static void createWorld(const RTransform& transform, const RVector3d& origin, const RVector3d& cameraPosition, RMatrix* dst);
+
+    /**
+     * Creates a view matrix for a camera placed at the origin.
+     *
+     * @param cameraPosition The world position of the camera.
+     * @param targetPosition The world position the camera looks at.
+     * @param up The up vector.
+     * @param dst A matrix to store the result in.
+     */
+    static void createView(const RVector3d& cameraPosition, const RVector3d& targetPosition, const RVector3& up, RMatrix* dst);
+
+    /**
+     * Creates a view matrix for a camera placed at the origin with the given orientation.
+     *
+     * @param cameraRotation The world rotation of the camera.
+     * @param dst A matrix to store the result in.
+     */
+    static void createView(const RQuaternion& cameraRotation, RMatrix* dst);
+
+private:
+
+    RCameraRelative();
+};
+
+}
+
+#include "RLargeWorld.inl"
@@ -0,0 +1,318 @@
+#include "common.h"
+#include "RLargeWorld.h"
+#include "RTransform.h"
+
+namespace rocket
+{
+
+template <typename T>
+RVector3T<T>::RVector3T()
+    : x(0), y(0), z(0)
+{
+}
+
+template <typename T>
+RVector3T<T>::RVector3T(T x, T y, T z)
+    : x(x), y(y), z(z)
+{
+}
+
+template <typename T>
+RVector3T<T>::RVector3T(const RVector3& v)
+    : x(v.x), y(v.y), z(v.z)
+{
+}
+
+template <typename T>
+const RVector3T<T>& RVector3T<T>::zero()
+{
+    static RVector3T<T> value(0, 0, 0);
+    return value;
+}
+
+template <typename T>
+T RVector3T<T>::dot(const RVector3T& v) const
+{
+    return x * v.x + y * v.y + z * v.z;
+}
+
+template <typename T>
+T RVector3T<T>::distance(const RVector3T& v) const
+{
+    return (*this - v).length();
+}
+
+template <typename T>
+T RVector3T<T>::length() const
+{
+    return std::sqrt(x * x + y * y + z * z);
+}
+
+template <typename T>
+void RVector3T<T>::set(T x, T y, T z)
+{
+    this->x = x;
+    this->y = y;
+    this->z = z;
+}
+
+template <typename T>
+RVector3 RVector3T<T>::toFloat() const
+{
+    return RVector3((float)x, (float)y, (float)z);
+}
+
+template <typename T>
+RVector3 RVector3T<T>::relativeTo(const RVector3T& origin) const
+{
+    return RVector3((float)(x - origin.x), (float)(y - origin.y), (float)(z - origin.z));
+}
+
+template <typename T>
+inline const RVector3T<T> RVector3T<T>::operator+(const RVector3T& v) const
+{
+    return RVector3T<T>(x + v.x, y + v.y, z + v.z);
+}
+
+template <typename T>
+inline RVector3T<T>& RVector3T<T>::operator+=(const RVector3T& v)
+{
+    x += v.x;
+    y += v.y;
+    z += v.z;
+    return *this;
+}
+
+template <typename T>
+inline const RVector3T<T> RVector3T<T>::operator-(const RVector3T& v) const
+{
+    return RVector3T<T>(x - v.x, y - v.y, z - v.z);
+}
+
+template <typename T>
+inline RVector3T<T>& RVector3T<T>::operator-=(const RVector3T& v)
+{
+    x -= v.x;
+    y -= v.y;
+    z -= v.z;
+    return *this;
+}
+
+template <typename T>
+inline const RVector3T<T> RVector3T<T>::operator-() const
+{
+    return RVector3T<T>(-x, -y, -z);
+}
+
+template <typename T>
+inline const RVector3T<T> RVector3T<T>::operator*(T s) const
+{
+    return RVector3T<T>(x * s, y * s, z * s);
+}
+
+template <typename T>
+inline bool RVector3T<T>::operator==(const RVector3T& v) const
+{
+    return x == v.x && y == v.y && z == v.z;
+}
+
+template <typename T>
+inline bool RVector3T<T>::operator!=(const RVector3T& v) const
+{
+    return x != v.x || y != v.y || z != v.z;
+}
+
+template <typename T>
+RMatrixT<T>::RMatrixT()
+{
+    setIdentity();
+}
+
+template <typename T>
+RMatrixT<T>::RMatrixT(const RMatrix& matrix)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        m[i] = matrix.m[i];
+    }
+}
+
+template <typename T>
+void RMatrixT<T>::createTranslation(const RVector3T<T>& translation, RMatrixT* dst)
+{
+    dst->setIdentity();
+    dst->setTranslation(translation);
+}
+
+template <typename T>
+void RMatrixT<T>::createFromTransform(const RTransform& transform, const RVector3T<T>& origin, RMatrixT* dst)
+{
+    // Rotation and scale are small and well conditioned, so compose them in single precision
+    // and only widen the translation.
+    RMatrix rotationScale;
+    RMatrix::createRotation(transform.getRotation(), &rotationScale);
+    rotationScale.scale(transform.getScale());
+
+    for (int i = 0; i < 12; ++i)
+    {
+        dst->m[i] = rotationScale.m[i];
+    }
+    dst->setTranslation(origin + RVector3T<T>(transform.getTranslation()));
+}
+
+template <typename T>
+void RMatrixT<T>::multiply(const RMatrixT& m1, const RMatrixT& m2, RMatrixT* dst)
+{
+    // Support the case where m1 or m2 is the same array as dst.
+    T product[16];
+    for (int column = 0; column < 4; ++column)
+    {
+        for (int row = 0; row < 4; ++row)
+        {
+            product[column * 4 + row] =
+                m1.m[row]      * m2.m[column * 4]     +
+                m1.m[4 + row]  * m2.m[column * 4 + 1] +
+                m1.m[8 + row]  * m2.m[column * 4 + 2] +
+                m1.m[12 + row] * m2.m[column * 4 + 3];
+        }
+    }
+    memcpy(dst->m, product, sizeof(product));
+}
+
+template <typename T>
+void RMatrixT<T>::getTranslation(RVector3T<T>* translation) const
+{
+    translation->set(m[12], m[13], m[14]);
+}
+
+template <typename T>
+void RMatrixT<T>::setIdentity()
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        m[i] = (i % 5 == 0) ? 1 : 0;
+    }
+}
+
+template <typename T>
+void RMatrixT<T>::setTranslation(const RVector3T<T>& translation)
+{
+    m[12] = translation.x;
+    m[13] = translation.y;
+    m[14] = translation.z;
+    m[15] = 1;
+}
+
+template <typename T>
+void RMatrixT<T>::transformPoint(const RVector3T<T>& point, RVector3T<T>* dst) const
+{
+    dst->set(point.x * m[0] + point.y * m[4] + point.z * m[8] + m[12],
+             point.x * m[1] + point.y * m[5] + point.z * m[9] + m[13],
+             point.x * m[2] + point.y * m[6] + point.z * m[10] + m[14]);
+}
+
+template <typename T>
+void RMatrixT<T>::toFloat(RMatrix* dst) const
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        dst->m[i] = (float)m[i];
+    }
+}
+
+template <typename T>
+void RMatrixT<T>::relativeTo(const RVector3T<T>& origin, RMatrix* dst) const
+{
+    for (int i = 0; i < 12; ++i)
+    {
+        dst->m[i] = (float)m[i];
+    }
+
+    // Rebase the translation before narrowing. For an affine matrix this is exactly T(-origin) * M.
+    dst->m[12] = (float)(m[12] - origin.x * m[15]);
+    dst->m[13] = (float)(m[13] - origin.y * m[15]);
+    dst->m[14] = (float)(m[14] - origin.z * m[15]);
+    dst->m[15] = (float)m[15];
+}
+
+template <typename T>
+inline const RMatrixT<T> RMatrixT<T>::operator*(const RMatrixT& m) const
+{
+    RMatrixT<T> result;
+    multiply(*this, m, &result);
+    return result;
+}
+
+template <typename T>
+RBoundingBoxT<T>::RBoundingBoxT()
+{
+}
+
+template <typename T>
+RBoundingBoxT<T>::RBoundingBoxT(const RVector3T<T>& min, const RVector3T<T>& max)
+    : min(min), max(max)
+{
+}
+
+template <typename T>
+RBoundingBoxT<T>::RBoundingBoxT(const RBoundingBox& box, const RVector3T<T>& origin)
+    : min(origin + RVector3T<T>(box.min)), max(origin + RVector3T<T>(box.max))
+{
+}
+
+template <typename T>
+RVector3T<T> RBoundingBoxT<T>::getCenter() const
+{
+    return RVector3T<T>((min.x + max.x) * (T)0.5, (min.y + max.y) * (T)0.5, (min.z + max.z) * (T)0.5);
+}
+
+template <typename T>
+bool RBoundingBoxT<T>::intersects(const RBoundingBoxT& box) const
+{
+    return min.x <= box.max.x && box.min.x <= max.x &&
+           min.y <= box.max.y && box.min.y <= max.y &&
+           min.z <= box.max.z && box.min.z <= max.z;
+}
+
+template <typename T>
+void RBoundingBoxT<T>::merge(const RBoundingBoxT& box)
+{
+    min.set(std::min(min.x, box.min.x), std::min(min.y, box.min.y), std::min(min.z, box.min.z));
+    max.set(std::max(max.x, box.max.x), std::max(max.y, box.max.y), std::max(max.z, box.max.z));
+}
+
+template <typename T>
+void RBoundingBoxT<T>::set(const RVector3T<T>& min, const RVector3T<T>& max)
+{
+    this->min = min;
+    this->max = max;
+}
+
+template <typename T>
+void RBoundingBoxT<T>::transform(const RMatrixT<T>& matrix)
+{
+    // Transform the center and project the extents onto the absolute rotation-scale
+    // part of the matrix (Arvo), which gives the tight enclosing box of the 8 corners.
+    RVector3T<T> center = getCenter();
+    RVector3T<T> extent = (max - min) * (T)0.5;
+
+    RVector3T<T> newCenter;
+    matrix.transformPoint(center, &newCenter);
+
+    const T* m = matrix.m;
+    RVector3T<T> newExtent(
+        std::abs(m[0]) * extent.x + std::abs(m[4]) * extent.y + std::abs(m[8]) * extent.z,
+        std::abs(m[1]) * extent.x + std::abs(m[5]) * extent.y + std::abs(m[9]) * extent.z,
+        std::abs(m[2]) * extent.x + std::abs(m[6]) * extent.y + std::abs(m[10]) * extent.z);
+
+    min = newCenter - newExtent;
+    max = newCenter + newExtent;
+}
+
+template <typename T>
+void RBoundingBoxT<T>::relativeTo(const RVector3T<T>& origin, RBoundingBox* dst) const
+{
+    dst->set(min.relativeTo(origin), max.relativeTo(origin));
+}
+
+}
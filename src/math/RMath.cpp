@@ -22,4 +22,247 @@ API void RMath::smooth(float* x, float target, float elapsedTime, float riseTime
     }
 }
 
-}
\ No newline at end of file
+API unsigned int RMath::getChunkCount(unsigned int count, unsigned int minChunkSize, RJobSystem* jobs)
+{
+    if (!jobs)
+    {
+        return 1;
+    }
+    unsigned int chunks = count / std::max(1u, minChunkSize);
+    return MATH_CLAMP(chunks, 1u, jobs->getThreadCount());
+}
+
+API unsigned int RMath::getChunkCount(const unsigned int* counts, unsigned int setCount, unsigned int minChunkSize, RJobSystem* jobs)
+{
+    if (!jobs)
+    {
+        return 1;
+    }
+    uint64_t total = 0;
+    for (unsigned int i = 0; i < setCount; ++i)
+    {
+        total += counts[i];
+    }
+    uint64_t chunks = total / std::max(1u, minChunkSize);
+    return (unsigned int)MATH_CLAMP(chunks, (uint64_t)1, (uint64_t)std::min(setCount, jobs->getThreadCount()));
+}
+
+API void RMath::forEachChunk(unsigned int count, unsigned int chunkCount,
+                             const std::function<void(unsigned int, unsigned int, unsigned int)>& function,
+                             RJobSystem* jobs)
+{
+    chunkCount = std::max(chunkCount, 1u);
+    auto runChunks = [&](unsigned int first, unsigned int last)
+    {
+        for (unsigned int chunk = first; chunk < last; ++chunk)
+        {
+            unsigned int begin = (unsigned int)((uint64_t)count * chunk / chunkCount);
+            unsigned int end = (unsigned int)((uint64_t)count * (chunk + 1) / chunkCount);
+            function(chunk, begin, end);
+        }
+    };
+
+    if (chunkCount == 1 || !jobs)
+    {
+        runChunks(0, chunkCount);
+        return;
+    }
+    jobs->parallelFor(chunkCount, runChunks, 1);
+}
+
+#ifdef MATH_SSE2
+
+static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline void sinCos4(__m128 x, __m128* sinDst, __m128* cosDst)
+{
+    // Same reduction and polynomials as RMath::fastSinCos, four lanes at a time.
+    __m128i q = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.636619772f)));
+    __m128 qf = _mm_cvtepi32_ps(q);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(qf, _mm_set1_ps(1.5703125f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(4.837512969970703125e-4f)));
+    r = _mm_sub_ps(r, _mm_mul_ps(qf, _mm_set1_ps(7.54978995489188216e-8f)));
+    __m128 z = _mm_mul_ps(r, r);
+
+    __m128 s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+    s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+    s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), r), r);
+
+    __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+    c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+    c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+    c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+    __m128i one = _mm_set1_epi32(1);
+    __m128i two = _mm_set1_epi32(2);
+    __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+    __m128 sinSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(q, two), 30));
+    __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30));
+
+    *sinDst = _mm_xor_ps(select(swap, c, s), sinSign);
+    *cosDst = _mm_xor_ps(select(swap, s, c), cosSign);
+}
+
+static inline __m128 atan24(__m128 y, __m128 x)
+{
+    __m128 signMask = _mm_set1_ps(-0.0f);
+    __m128 ax = _mm_andnot_ps(signMask, x);
+    __m128 ay = _mm_andnot_ps(signMask, y);
+    __m128 mx = _mm_max_ps(ax, ay);
+    __m128 mn = _mm_min_ps(ax, ay);
+    __m128 a = _mm_and_ps(_mm_cmpgt_ps(mx, _mm_setzero_ps()), _mm_div_ps(mn, mx));
+    __m128 s = _mm_mul_ps(a, a);
+
+    __m128 r = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.0028662257f), s), _mm_set1_ps(-0.0161657367f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.0429096138f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.0752896400f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1065626393f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.1420889944f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1999355085f));
+    r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.3333314528f));
+    r = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(r, s), a), a);
+
+    r = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(MATH_PIOVER2), r), r);
+    __m128 xNegative = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+    r = select(xNegative, _mm_sub_ps(_mm_set1_ps(MATH_PI), r), r);
+    return _mm_xor_ps(r, _mm_and_ps(y, signMask));
+}
+
+static inline __m128 exp4(__m128 x)
+{
+    x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.0f)), _mm_set1_ps(88.0f));
+
+    __m128i n = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(MATH_LOG2E)));
+    __m128 nf = _mm_cvtepi32_ps(n);
+    __m128 r = _mm_sub_ps(x, _mm_mul_ps(nf, _mm_set1_ps(0.693359375f)));
+    r = _mm_add_ps(r, _mm_mul_ps(nf, _mm_set1_ps(2.12194440e-4f)));
+
+    __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.9875691500e-4f), r), _mm_set1_ps(1.3981999507e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(8.3334519073e-3f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(4.1665795894e-2f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(1.6666665459e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(5.0000001201e-1f));
+    p = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, r), r), r), _mm_set1_ps(1.0f));
+
+    __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(p, scale);
+}
+
+static inline __m128 log4(__m128 x)
+{
+    __m128i bits = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000)));
+
+    __m128 small = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+    e = _mm_add_epi32(e, _mm_castps_si128(small));
+    m = _mm_sub_ps(_mm_add_ps(m, _mm_and_ps(small, m)), _mm_set1_ps(1.0f));
+
+    __m128 z = _mm_mul_ps(m, m);
+    __m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(7.0376836292e-2f), m), _mm_set1_ps(-1.1514610310e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.1676998740e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.2420140846e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.4249322787e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.6668057665e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(2.0000714765e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-2.4999993993e-1f));
+    y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(3.3333331174e-1f));
+    y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+
+    __m128 ef = _mm_cvtepi32_ps(e);
+    y = _mm_add_ps(y, _mm_mul_ps(ef, _mm_set1_ps(-2.12194440e-4f)));
+    y = _mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(0.5f), z));
+    return _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(ef, _mm_set1_ps(0.693359375f)));
+}
+
+static inline __m128 rsqrt4(__m128 x)
+{
+    __m128 y = _mm_rsqrt_ps(x);
+    __m128 yy = _mm_mul_ps(_mm_mul_ps(x, y), y);
+    return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_set1_ps(0.5f), yy)));
+}
+
+#endif
+
+API void RMath::fastSinCos(const float* x, float* sinDst, float* cosDst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MATH_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 s, c;
+        sinCos4(_mm_loadu_ps(x + i), &s, &c);
+        _mm_storeu_ps(sinDst + i, s);
+        _mm_storeu_ps(cosDst + i, c);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        fastSinCos(x[i], sinDst + i, cosDst + i);
+    }
+}
+
+API void RMath::fastAtan2(const float* y, const float* x, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MATH_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, atan24(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = fastAtan2(y[i], x[i]);
+    }
+}
+
+API void RMath::fastExp(const float* x, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MATH_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, exp4(_mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = fastExp(x[i]);
+    }
+}
+
+API void RMath::fastLog(const float* x, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MATH_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, log4(_mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = fastLog(x[i]);
+    }
+}
+
+API void RMath::fastRsqrt(const float* x, float* dst, unsigned int count)
+{
+    unsigned int i = 0;
+#ifdef MATH_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, rsqrt4(_mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = fastRsqrt(x[i]);
+    }
+}
+
+}
@@ -2,6 +2,11 @@
 
 #include "common.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace rocket
 {
 
@@ -14,6 +19,9 @@ class API RMath
 {
     friend class RMatrix;
     friend class RVector3;
+    friend class RBoundingBox;
+    friend class RBoundingSphere;
+    friend class RBoundingOrientedBox;
 
 public:
 
@@ -46,6 +54,141 @@ public:
      */
     static void smooth(float* x, float target, float elapsedTime, float riseTime, float fallTime);
 
+    /**
+     * Computes an approximation of the sine of the given angle.
+     *
+     * The argument is reduced to [-pi/4, pi/4] and evaluated with a minimax polynomial.
+     * The maximum absolute error is 1.2e-7 for |x| <= 1e4. Accuracy degrades for
+     * larger arguments; results are undefined for |x| > 1e9.
+     *
+     * @param x The angle in radians.
+     *
+     * @return The approximate sine of x.
+     */
+    inline static float fastSin(float x);
+
+    /**
+     * Computes an approximation of the cosine of the given angle.
+     *
+     * The error bounds are the same as for fastSin().
+     *
+     * @param x The angle in radians.
+     *
+     * @return The approximate cosine of x.
+     */
+    inline static float fastCos(float x);
+
+    /**
+     * Computes approximations of the sine and the cosine of the given angle at once.
+     *
+     * This costs about the same as a single fastSin() call. The error bounds are the same as for fastSin().
+     *
+     * @param x The angle in radians.
+     * @param sinDst The approximate sine of x.
+     * @param cosDst The approximate cosine of x.
+     */
+    inline static void fastSinCos(float x, float* sinDst, float* cosDst);
+
+    /**
+     * Computes an approximation of the arc tangent of y / x, using the signs of both to
+     * determine the quadrant.
+     *
+     * The maximum absolute error is 3e-7 radians. atan2(0, 0) returns 0 (or pi for x = -0).
+     *
+     * @param y The y coordinate.
+     * @param x The x coordinate.
+     *
+     * @return The approximate angle in radians, in [-pi, pi].
+     */
+    inline static float fastAtan2(float y, float x);
+
+    /**
+     * Computes an approximation of e raised to the given power.
+     *
+     * The maximum relative error is 1.5e-7. The argument is clamped to [-87, 88]
+     * so the result is always a finite, normalized float.
+     *
+     * @param x The exponent.
+     *
+     * @return The approximate value of e^x.
+     */
+    inline static float fastExp(float x);
+
+    /**
+     * Computes an approximation of the natural logarithm of the given value.
+     *
+     * The maximum absolute error is 1e-7 for x in [0.5, 2] and the maximum
+     * relative error is 1.5e-7 elsewhere. x must be a positive, finite, normalized float;
+     * zero, negative, denormal, infinite and NaN arguments give undefined results.
+     *
+     * @param x The value.
+     *
+     * @return The approximate natural logarithm of x.
+     */
+    inline static float fastLog(float x);
+
+    /**
+     * Computes an approximation of 1 / sqrt(x).
+     *
+     * Uses the hardware estimate (or an integer estimate when unavailable) refined with
+     * Newton-Raphson. The maximum relative error is 3e-7 with SSE2 and 5e-6 without.
+     * x must be positive and finite.
+     *
+     * @param x The value.
+     *
+     * @return The approximate reciprocal square root of x.
+     */
+    inline static float fastRsqrt(float x);
+
+    /**
+     * Computes fastSinCos() for each element of an array.
+     *
+     * The arrays may not overlap, except that x may be the same array as sinDst or cosDst.
+     *
+     * @param x The angles in radians.
+     * @param sinDst The array to store the sines in.
+     * @param cosDst The array to store the cosines in.
+     * @param count The number of elements.
+     */
+    static void fastSinCos(const float* x, float* sinDst, float* cosDst, unsigned int count);
+
+    /**
+     * Computes fastAtan2() for each pair of elements of two arrays.
+     *
+     * @param y The y coordinates.
+     * @param x The x coordinates.
+     * @param dst The array to store the angles in (may be the same array as y or x).
+     * @param count The number of elements.
+     */
+    static void fastAtan2(const float* y, const float* x, float* dst, unsigned int count);
+
+    /**
+     * Computes fastExp() for each element of an array.
+     *
+     * @param x The exponents.
+     * @param dst The array to store the results in (may be the same array as x).
+     * @param count The number of elements.
+     */
+    static void fastExp(const float* x, float* dst, unsigned int count);
+
+    /**
+     * Computes fastLog() for each element of an array.
+     *
+     * @param x The values.
+     * @param dst The array to store the results in (may be the same array as x).
+     * @param count The number of elements.
+     */
+    static void fastLog(const float* x, float* dst, unsigned int count);
+
+    /**
+     * Computes fastRsqrt() for each element of an array.
+     *
+     * @param x The values.
+     * @param dst The array to store the results in (may be the same array as x).
+     * @param count The number of elements.
+     */
+    static void fastRsqrt(const float* x, float* dst, unsigned int count);
+
 private:
 
     inline static void addMatrix(const float* m, float scalar, float* dst);
@@ -68,6 +211,43 @@ private:
 
     inline static void crossVector3(const float* v1, const float* v2, float* dst);
 
+    /**
+     * Returns the number of chunks forEachChunk() splits count elements into,
+     * so callers can size their per-chunk partial results.
+     *
+     * @param count The number of elements.
+     * @param minChunkSize The smallest number of elements worth handing to another thread.
+     * @param jobs The job system the chunks will run on, or null to run them on the calling thread.
+     */
+    static unsigned int getChunkCount(unsigned int count, unsigned int minChunkSize, RJobSystem* jobs);
+
+    /**
+     * Returns the number of chunks to split setCount sets of elements into, so that
+     * each chunk holds at least minChunkSize elements in total. A few small sets are
+     * not worth handing to other threads however many there are.
+     *
+     * @param counts The number of elements in each set.
+     * @param setCount The number of sets.
+     * @param minChunkSize The smallest total number of elements worth handing to another thread.
+     * @param jobs The job system the chunks will run on, or null to run them on the calling thread.
+     */
+    static unsigned int getChunkCount(const unsigned int* counts, unsigned int setCount, unsigned int minChunkSize, RJobSystem* jobs);
+
+    /**
+     * Splits [0, count) into chunkCount contiguous ranges and calls function(chunk, begin, end)
+     * for each of them, across the job system's threads when one is given and on the calling
+     * thread otherwise. Called from inside a job, the chunks share the same workers rather
+     * than oversubscribing the cores.
+     *
+     * @param count The number of elements.
+     * @param chunkCount The number of chunks, as returned by getChunkCount().
+     * @param function The function to call for each chunk.
+     * @param jobs The job system to run the chunks on, or null.
+     */
+    static void forEachChunk(unsigned int count, unsigned int chunkCount,
+                             const std::function<void(unsigned int, unsigned int, unsigned int)>& function,
+                             RJobSystem* jobs);
+
     RMath();
 };
 
@@ -174,4 +174,135 @@ API inline void RMath::crossVector3(const float* v1, const float* v2, float* dst
     dst[2] = z;
 }
 
-}
\ No newline at end of file
+API inline float RMath::fastSin(float x)
+{
+    float s, c;
+    fastSinCos(x, &s, &c);
+    return s;
+}
+
+API inline float RMath::fastCos(float x)
+{
+    float s, c;
+    fastSinCos(x, &s, &c);
+    return c;
+}
+
+API inline void RMath::fastSinCos(float x, float* sinDst, float* cosDst)
+{
+    // Reduce x = q * pi/2 + r with r in [-pi/4, pi/4], subtracting pi/2 in three parts (Cody-Waite)
+    // so the reduction stays exact for large quadrant numbers.
+    int q = (int)(x * 0.636619772f + (x < 0.0f ? -0.5f : 0.5f));
+    float qf = (float)q;
+    float r = ((x - qf * 1.5703125f) - qf * 4.837512969970703125e-4f) - qf * 7.54978995489188216e-8f;
+    float z = r * r;
+
+    // Minimax polynomials for sin and cos on [-pi/4, pi/4] (Cephes).
+    float s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+    float c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+
+    // Rotate the result into the quadrant.
+    if (q & 1)
+    {
+        float t = s;
+        s = c;
+        c = t;
+    }
+    *sinDst = (q & 2) ? -s : s;
+    *cosDst = ((q + 1) & 2) ? -c : c;
+}
+
+API inline float RMath::fastAtan2(float y, float x)
+{
+    float ax = fabsf(x);
+    float ay = fabsf(y);
+    float mx = std::max(ax, ay);
+    float mn = std::min(ax, ay);
+    float a = (mx > 0.0f) ? mn / mx : 0.0f;
+    float s = a * a;
+
+    // Polynomial for atan on [0, 1] (Abramowitz & Stegun 4.4.49).
+    float r = ((((((((0.0028662257f * s - 0.0161657367f) * s + 0.0429096138f) * s - 0.0752896400f) * s
+              + 0.1065626393f) * s - 0.1420889944f) * s + 0.1999355085f) * s - 0.3333314528f) * s) * a + a;
+
+    if (ay > ax)
+    {
+        r = MATH_PIOVER2 - r;
+    }
+    if (std::signbit(x))
+    {
+        r = MATH_PI - r;
+    }
+    return std::signbit(y) ? -r : r;
+}
+
+API inline float RMath::fastExp(float x)
+{
+    x = MATH_CLAMP(x, -87.0f, 88.0f);
+
+    // Reduce x = n * ln(2) + r and compute e^x = 2^n * e^r.
+    int n = (int)(x * MATH_LOG2E + (x < 0.0f ? -0.5f : 0.5f));
+    float nf = (float)n;
+    float r = (x - nf * 0.693359375f) + nf * 2.12194440e-4f;
+
+    // Polynomial for e^r on [-ln(2)/2, ln(2)/2] (Cephes).
+    float p = (((((1.9875691500e-4f * r + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r
+              + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1.0f;
+
+    uint32_t bits = (uint32_t)(n + 127) << 23;
+    float scale;
+    memcpy(&scale, &bits, sizeof(float));
+    return p * scale;
+}
+
+API inline float RMath::fastLog(float x)
+{
+    // Split x = m * 2^e with m in [sqrt(0.5), sqrt(2)).
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(float));
+    int e = (int)(bits >> 23) - 126;
+    bits = (bits & 0x007fffff) | 0x3f000000;
+    float m;
+    memcpy(&m, &bits, sizeof(float));
+    if (m < 0.707106781186547524f)
+    {
+        e -= 1;
+        m = m + m - 1.0f;
+    }
+    else
+    {
+        m = m - 1.0f;
+    }
+
+    // Polynomial for log(1 + m) (Cephes).
+    float z = m * m;
+    float y = ((((((((7.0376836292e-2f * m - 1.1514610310e-1f) * m + 1.1676998740e-1f) * m - 1.2420140846e-1f) * m
+              + 1.4249322787e-1f) * m - 1.6668057665e-1f) * m + 2.0000714765e-1f) * m - 2.4999993993e-1f) * m
+              + 3.3333331174e-1f) * m * z;
+
+    // Add e * ln(2) in two parts.
+    float ef = (float)e;
+    y += ef * -2.12194440e-4f;
+    y -= 0.5f * z;
+    return (m + y) + ef * 0.693359375f;
+}
+
+API inline float RMath::fastRsqrt(float x)
+{
+#ifdef MATH_SSE2
+    // 12-bit hardware estimate and one Newton-Raphson step.
+    float y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    return y * (1.5f - 0.5f * x * y * y);
+#else
+    // Integer estimate and two Newton-Raphson steps.
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(float));
+    bits = 0x5f375a86 - (bits >> 1);
+    float y;
+    memcpy(&y, &bits, sizeof(float));
+    y = y * (1.5f - 0.5f * x * y * y);
+    return y * (1.5f - 0.5f * x * y * y);
+#endif
+}
+
+}
@@ -4,6 +4,7 @@
 #include "RFrustum.h"
 #include "RBoundingSphere.h"
 #include "RBoundingBox.h"
+#include "RBoundingOrientedBox.h"
 
 
 namespace rocket
@@ -75,6 +76,11 @@ float RRay::intersects(const RBoundingBox& box) const
     return box.intersects(*this);
 }
 
+float RRay::intersects(const RBoundingOrientedBox& box) const
+{
+    return box.intersects(*this);
+}
+
 float RRay::intersects(const RFrustum& RFrustum) const
 {
     RPlane n = RFrustum.getNear();
@@ -9,6 +9,7 @@ class RFrustum;
 class RPlane;
 class RBoundingSphere;
 class RBoundingBox;
+class RBoundingOrientedBox;
 
 
 /**
@@ -128,6 +129,16 @@ public:
      */
     float intersects(const RBoundingBox& box) const;
 
+    /**
+     * Tests whether this ray intersects the specified oriented bounding box.
+     *
+     * @param box The oriented bounding box to test intersection with.
+     * 
+     * @return The distance from the origin of this ray to the bounding object or
+     *     INTERSECTS_NONE if this ray does not intersect the bounding object.
+     */
+    float intersects(const RBoundingOrientedBox& box) const;
+
     /**
      * Tests whether this ray intersects the specified RFrustum.
      *
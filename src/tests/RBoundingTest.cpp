@@ -0,0 +1,413 @@
+#include "common.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace rocket;
+
+namespace
+{
+
+std::vector<RVector3> randomPoints(unsigned int count, unsigned int seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    std::vector<RVector3> points(count);
+    for (RVector3& point : points)
+    {
+        point.set(distribution(random), distribution(random) * 0.25f, distribution(random));
+    }
+    return points;
+}
+
+void expectNear(const RVector3& a, const RVector3& b)
+{
+    EXPECT_NEAR(a.x, b.x, 1e-3f);
+    EXPECT_NEAR(a.y, b.y, 1e-3f);
+    EXPECT_NEAR(a.z, b.z, 1e-3f);
+}
+
+// A box with a random center, orientation and size.
+RBoundingOrientedBox randomOrientedBox(std::mt19937& random, float spread, float size)
+{
+    std::uniform_real_distribution<float> position(-spread, spread);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> extent(0.1f * size, size);
+    RVector3 axis(unit(random), unit(random), unit(random));
+    if (axis.lengthSquared() < 1e-4f)
+    {
+        axis = RVector3::unitY();
+    }
+    axis.normalize();
+    RMatrix rotation;
+    RMatrix::createRotation(axis, unit(random) * MATH_PI, &rotation);
+    return RBoundingOrientedBox(RVector3(position(random), position(random), position(random)), RVector3(rotation.m[0], rotation.m[1], rotation.m[2]),
+                                RVector3(rotation.m[4], rotation.m[5], rotation.m[6]), RVector3(rotation.m[8], rotation.m[9], rotation.m[10]),
+                                RVector3(extent(random), extent(random), extent(random)));
+}
+
+// A point of the box, from coordinates in [-1, 1] along each of its axes.
+RVector3 pointInBox(const RBoundingOrientedBox& box, float u, float v, float w)
+{
+    return box.center + box.axes[0] * (u * box.extents.x) + box.axes[1] * (v * box.extents.y) + box.axes[2] * (w * box.extents.z);
+}
+
+bool contains(const RBoundingOrientedBox& box, const RVector3& point, float tolerance)
+{
+    const RVector3 d = point - box.center;
+    return fabsf(d.dot(box.axes[0])) <= box.extents.x + tolerance && fabsf(d.dot(box.axes[1])) <= box.extents.y + tolerance &&
+           fabsf(d.dot(box.axes[2])) <= box.extents.z + tolerance;
+}
+
+void expectOrthonormal(const RBoundingOrientedBox& box)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_NEAR(box.axes[i].length(), 1.0f, 1e-4f);
+        EXPECT_NEAR(box.axes[i].dot(box.axes[(i + 1) % 3]), 0.0f, 1e-4f);
+    }
+}
+
+}
+
+// Large enough that every fit splits into several chunks on the job system.
+TEST(RBounding, JobSystemFitsMatchSerialFits)
+{
+    RJobSystem jobs(3);
+    const std::vector<RVector3> points = randomPoints(300000, 1);
+    const unsigned int count = (unsigned int)points.size();
+
+    RBoundingBox box, boxParallel;
+    box.set(points.data(), count);
+    boxParallel.set(points.data(), count, &jobs);
+    expectNear(box.min, boxParallel.min);
+    expectNear(box.max, boxParallel.max);
+
+    RBoundingSphere sphere, sphereParallel;
+    sphere.set(points.data(), count);
+    sphereParallel.set(points.data(), count, 4, &jobs);
+    expectNear(sphere.center, sphereParallel.center);
+    EXPECT_NEAR(sphere.radius, sphereParallel.radius, 1e-3f);
+
+    RBoundingOrientedBox obb, obbParallel;
+    obb.set(points.data(), count);
+    obbParallel.set(points.data(), count, &jobs);
+    expectNear(obb.center, obbParallel.center);
+    expectNear(obb.extents, obbParallel.extents);
+}
+
+TEST(RBounding, CreateFromPointsMatchesSet)
+{
+    RJobSystem jobs(3);
+    std::vector<std::vector<RVector3>> sets;
+    std::vector<const RVector3*> points;
+    std::vector<unsigned int> counts;
+    for (unsigned int i = 0; i < 40; ++i)
+    {
+        sets.push_back(randomPoints(1000 + i * 997, 10 + i));
+    }
+    for (const std::vector<RVector3>& set : sets)
+    {
+        points.push_back(set.data());
+        counts.push_back((unsigned int)set.size());
+    }
+    const unsigned int setCount = (unsigned int)sets.size();
+
+    std::vector<RBoundingBox> boxes(setCount);
+    std::vector<RBoundingSphere> spheres(setCount);
+    std::vector<RBoundingOrientedBox> obbs(setCount);
+    RBoundingBox::createFromPoints(points.data(), counts.data(), setCount, boxes.data(), &jobs);
+    RBoundingSphere::createFromPoints(points.data(), counts.data(), setCount, spheres.data(), 4, &jobs);
+    RBoundingOrientedBox::createFromPoints(points.data(), counts.data(), setCount, obbs.data(), &jobs);
+
+    for (unsigned int i = 0; i < setCount; ++i)
+    {
+        RBoundingBox box;
+        box.set(points[i], counts[i]);
+        expectNear(boxes[i].min, box.min);
+        expectNear(boxes[i].max, box.max);
+
+        RBoundingSphere sphere;
+        sphere.set(points[i], counts[i]);
+        EXPECT_NEAR(spheres[i].radius, sphere.radius, 1e-3f);
+
+        RBoundingOrientedBox obb;
+        obb.set(points[i], counts[i]);
+        expectNear(obbs[i].extents, obb.extents);
+    }
+}
+
+// Non-uniform scale applied across a rotated box skews it; the result must stay a
+// true oriented box that contains every corner of the skewed one.
+TEST(RBounding, OrientedBoxTransformContainsSkewedBox)
+{
+    std::mt19937 random(7);
+    for (unsigned int i = 0; i < 200; ++i)
+    {
+        const RBoundingOrientedBox box = randomOrientedBox(random, 10.0f, 5.0f);
+        const RBoundingOrientedBox frame = randomOrientedBox(random, 10.0f, 1.0f);
+        RMatrix rotation, scale, translation, matrix;
+        RMatrix::createRotation(RVector3(1.0f, 2.0f, 3.0f).normalize(), 0.1f * (float)i, &rotation);
+        RMatrix::createScale(3.0f, 0.25f, 1.0f + (float)(i % 5), &scale);
+        RMatrix::createTranslation(frame.center, &translation);
+        RMatrix::multiply(scale, rotation, &matrix);
+        RMatrix::multiply(translation, matrix, &matrix);
+
+        RBoundingOrientedBox transformed(box);
+        transformed.transform(matrix);
+        expectOrthonormal(transformed);
+
+        RVector3 corners[8];
+        box.getCorners(corners);
+        const float tolerance = 1e-4f * (1.0f + transformed.extents.length());
+        for (const RVector3& corner : corners)
+        {
+            RVector3 point;
+            matrix.transformPoint(corner, &point);
+            EXPECT_TRUE(contains(transformed, point, tolerance)) << "box " << i;
+        }
+    }
+
+    // Rotation, translation and uniform scale keep the box exact.
+    RBoundingOrientedBox box(RVector3(1.0f, 2.0f, 3.0f), RVector3::unitX(), RVector3::unitY(), RVector3::unitZ(), RVector3(1.0f, 2.0f, 3.0f));
+    RMatrix rotation, scale, matrix;
+    RMatrix::createRotationY(0.7f, &rotation);
+    RMatrix::createScale(2.0f, 2.0f, 2.0f, &scale);
+    RMatrix::multiply(rotation, scale, &matrix);
+    box.transform(matrix);
+    expectOrthonormal(box);
+    expectNear(box.extents, RVector3(2.0f, 4.0f, 6.0f));
+}
+
+// The separating axis test never reports a miss for boxes that share a sampled point,
+// and never reports a hit for boxes whose bounding spheres are apart.
+TEST(RBounding, OrientedBoxIntersectsOrientedBoxWithoutFalseNegatives)
+{
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        const RBoundingOrientedBox a = randomOrientedBox(random, 6.0f, 3.0f);
+        const RBoundingOrientedBox b = randomOrientedBox(random, 6.0f, 3.0f);
+        const bool result = a.intersects(b);
+        EXPECT_EQ(result, b.intersects(a)) << "pair " << i;
+
+        bool shared = false;
+        for (unsigned int sample = 0; sample < 200 && !shared; ++sample)
+        {
+            shared = contains(b, pointInBox(a, unit(random), unit(random), unit(random)), 0.0f);
+        }
+        if (shared)
+        {
+            EXPECT_TRUE(result) << "pair " << i;
+        }
+        if (a.center.distance(b.center) > a.extents.length() + b.extents.length())
+        {
+            EXPECT_FALSE(result) << "pair " << i;
+        }
+        hits += shared ? 1 : 0;
+        misses += result ? 0 : 1;
+    }
+    EXPECT_GT(hits, 100u);
+    EXPECT_GT(misses, 100u);
+}
+
+// A box with a sampled point inside the view volume is never culled, and a box
+// entirely behind the camera is.
+TEST(RBounding, OrientedBoxIntersectsFrustumWithoutFalseNegatives)
+{
+    RMatrix projection, view, viewProjection;
+    RMatrix::createPerspective(60.0f, 1.5f, 1.0f, 50.0f, &projection);
+    RMatrix::createLookAt(RVector3(0.0f, 0.0f, 0.0f), RVector3(0.0f, 0.0f, -1.0f), RVector3::unitY(), &view);
+    RMatrix::multiply(projection, view, &viewProjection);
+    const RFrustum frustum(viewProjection);
+
+    std::mt19937 random(13);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        const RBoundingOrientedBox box = randomOrientedBox(random, 40.0f, 4.0f);
+        const bool result = box.intersects(frustum);
+        bool inside = false;
+        for (unsigned int sample = 0; sample < 200 && !inside; ++sample)
+        {
+            const RVector3 point = pointInBox(box, unit(random), unit(random), unit(random));
+            RVector4 clip;
+            viewProjection.transformVector(RVector4(point.x, point.y, point.z, 1.0f), &clip);
+            inside = fabsf(clip.x) <= clip.w && fabsf(clip.y) <= clip.w && fabsf(clip.z) <= clip.w;
+        }
+        if (inside)
+        {
+            EXPECT_TRUE(result) << "box " << i;
+        }
+        visible += inside ? 1 : 0;
+    }
+    EXPECT_GT(visible, 50u);
+
+    const RBoundingOrientedBox behind(RVector3(0.0f, 0.0f, 10.0f), RVector3::unitX(), RVector3::unitY(), RVector3::unitZ(), RVector3(2.0f, 2.0f, 2.0f));
+    EXPECT_FALSE(behind.intersects(frustum));
+}
+
+// A ray that passes through a sampled point of the box hits it no further away
+// than that point, and the reported hit lies on the box.
+TEST(RBounding, OrientedBoxIntersectsRayWithoutFalseNegatives)
+{
+    std::mt19937 random(17);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    unsigned int hits = 0;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        const RBoundingOrientedBox box = randomOrientedBox(random, 5.0f, 3.0f);
+        const RVector3 origin(unit(random) * 20.0f, unit(random) * 20.0f, unit(random) * 20.0f);
+        const RVector3 target = pointInBox(box, unit(random), unit(random), unit(random));
+        const bool throughBox = (i & 1) == 0;
+        RVector3 direction = throughBox ? target - origin : RVector3(unit(random), unit(random), unit(random));
+        if (direction.lengthSquared() < 1e-6f)
+        {
+            continue;
+        }
+        direction.normalize();
+        const RRay ray(origin, direction);
+        const float distance = box.intersects(ray);
+
+        if (throughBox)
+        {
+            ASSERT_NE(distance, (float)RRay::INTERSECTS_NONE) << "ray " << i;
+            EXPECT_LE(distance, origin.distance(target) + 1e-3f) << "ray " << i;
+        }
+        if (distance != (float)RRay::INTERSECTS_NONE)
+        {
+            EXPECT_TRUE(contains(box, origin + direction * distance, 1e-3f)) << "ray " << i;
+            ++hits;
+        }
+    }
+    EXPECT_GT(hits, 1000u);
+}
+
+// The center-extent (Arvo) transforms give the box of the eight transformed corners,
+// including under non-uniform and negative scale and shear.
+TEST(RBounding, CenterExtentTransformMatchesEightCorners)
+{
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const unsigned int COUNT = 500;
+    std::vector<RBoundingBox> boxes(COUNT);
+    std::vector<RMatrix> matrices(COUNT);
+    std::vector<RVector3> centers(COUNT);
+    std::vector<RVector3> extents(COUNT);
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        const RVector3 center(unit(random) * 50.0f, unit(random) * 50.0f, unit(random) * 50.0f);
+        const RVector3 extent(0.1f + fabsf(unit(random)) * 10.0f, 0.1f + fabsf(unit(random)) * 10.0f, 0.1f + fabsf(unit(random)) * 10.0f);
+        boxes[i].set(center - extent, center + extent);
+        centers[i] = center;
+        extents[i] = extent;
+
+        // An arbitrary affine matrix: random upper 3x3 and translation.
+        RMatrix& matrix = matrices[i];
+        matrix.set(RMatrix::identity());
+        for (unsigned int column = 0; column < 4; ++column)
+        {
+            for (unsigned int row = 0; row < 3; ++row)
+            {
+                matrix.m[column * 4 + row] = unit(random) * (column == 3 ? 100.0f : 3.0f);
+            }
+        }
+    }
+
+    std::vector<RBoundingBox> batched(COUNT);
+    std::vector<RVector3> dstCenters(COUNT);
+    std::vector<RVector3> dstExtents(COUNT);
+    RBoundingBox::transform(boxes.data(), matrices.data(), COUNT, batched.data());
+    RBoundingBox::transform(centers.data(), extents.data(), matrices.data(), COUNT, dstCenters.data(), dstExtents.data());
+
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        RVector3 corners[8];
+        boxes[i].getCorners(corners);
+        RBoundingBox expected;
+        for (unsigned int c = 0; c < 8; ++c)
+        {
+            RVector3 corner;
+            matrices[i].transformPoint(corners[c], &corner);
+            if (c == 0)
+            {
+                expected.set(corner, corner);
+            }
+            else
+            {
+                expected.min.set(std::min(expected.min.x, corner.x), std::min(expected.min.y, corner.y), std::min(expected.min.z, corner.z));
+                expected.max.set(std::max(expected.max.x, corner.x), std::max(expected.max.y, corner.y), std::max(expected.max.z, corner.z));
+            }
+        }
+
+        RBoundingBox single(boxes[i]);
+        single.transform(matrices[i]);
+        expectNear(single.min, expected.min);
+        expectNear(single.max, expected.max);
+        expectNear(batched[i].min, expected.min);
+        expectNear(batched[i].max, expected.max);
+        expectNear(dstCenters[i] - dstExtents[i], expected.min);
+        expectNear(dstCenters[i] + dstExtents[i], expected.max);
+    }
+}
+
+// The Ritter sphere and the PCA box contain every point they are fitted to, serially
+// and on the job system, including for clustered and degenerate point sets.
+TEST(RBounding, FittedSpheresAndOrientedBoxesContainEveryPoint)
+{
+    RJobSystem jobs(3);
+    std::vector<std::vector<RVector3>> sets;
+    sets.push_back(randomPoints(300000, 23));
+    sets.push_back(randomPoints(1000, 29));
+    // Two distant clusters, a line, a plane, duplicates of one point and a single point.
+    std::mt19937 random(31);
+    std::normal_distribution<float> normal(0.0f, 1.0f);
+    std::vector<RVector3> clusters;
+    for (unsigned int i = 0; i < 5000; ++i)
+    {
+        const float offset = i % 2 == 0 ? -500.0f : 500.0f;
+        clusters.emplace_back(offset + normal(random), normal(random) * 3.0f, offset * 0.5f + normal(random));
+    }
+    sets.push_back(clusters);
+    std::vector<RVector3> line;
+    std::vector<RVector3> plane;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+        const float t = normal(random) * 40.0f;
+        line.emplace_back(1.0f + t, 2.0f - t * 0.5f, 3.0f + t * 2.0f);
+        plane.emplace_back(normal(random) * 20.0f, normal(random) * 5.0f, 7.0f);
+    }
+    sets.push_back(line);
+    sets.push_back(plane);
+    sets.push_back(std::vector<RVector3>(100, RVector3(4.0f, -5.0f, 6.0f)));
+    sets.push_back(std::vector<RVector3>(1, RVector3(-1.0f, 0.5f, 2.0f)));
+
+    for (size_t s = 0; s < sets.size(); ++s)
+    {
+        const std::vector<RVector3>& points = sets[s];
+        const unsigned int count = (unsigned int)points.size();
+        for (RJobSystem* system : { (RJobSystem*)nullptr, &jobs })
+        {
+            RBoundingSphere sphere;
+            sphere.set(points.data(), count, 4, system);
+            RBoundingOrientedBox box;
+            box.set(points.data(), count, system);
+            expectOrthonormal(box);
+
+            const float sphereTolerance = 1e-5f * (1.0f + sphere.radius + sphere.center.length());
+            const float boxTolerance = 1e-5f * (1.0f + box.extents.length() + box.center.length());
+            unsigned int outsideSphere = 0;
+            unsigned int outsideBox = 0;
+            for (const RVector3& point : points)
+            {
+                outsideSphere += point.distance(sphere.center) <= sphere.radius + sphereTolerance ? 0 : 1;
+                outsideBox += contains(box, point, boxTolerance) ? 0 : 1;
+            }
+            EXPECT_EQ(outsideSphere, 0u) << "set " << s << (system ? " on jobs" : "");
+            EXPECT_EQ(outsideBox, 0u) << "set " << s << (system ? " on jobs" : "");
+        }
+    }
+}
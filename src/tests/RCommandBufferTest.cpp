@@ -0,0 +1,84 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+const unsigned int THREADS = 4;
+const uint32_t DRAWS_PER_THREAD = 5000;
+
+// Thread t binds program t + 1, then draws with fields derived from t and the draw number.
+void record(RCommandBuffer& buffer, unsigned int thread)
+{
+    buffer.bindProgram(thread + 1);
+    for (uint32_t i = 0; i < DRAWS_PER_THREAD; ++i)
+    {
+        buffer.drawIndexed(PRIMITIVE_TRIANGLES, (i & 1) != 0, 3 * (i % 5 + 1), i, (int32_t)thread, i % 3 + 1, thread);
+    }
+}
+
+}
+
+// Buffers recorded on four threads, in small chunks, replay in submission order with every field intact.
+TEST(RCommandBuffer, FourThreadRecordingReplaysInOrder)
+{
+    std::vector<std::unique_ptr<RCommandBuffer>> buffers;
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < THREADS; ++t)
+    {
+        buffers.emplace_back(new RCommandBuffer(nullptr, 256));
+    }
+    for (unsigned int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back(record, std::ref(*buffers[t]), t);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    RNullBackend backend;
+    backend.setRecording(true);
+    for (const std::unique_ptr<RCommandBuffer>& buffer : buffers)
+    {
+        EXPECT_EQ(buffer->getCommandCount(), DRAWS_PER_THREAD + 1);
+        backend.submit(*buffer);
+    }
+
+    ASSERT_EQ(backend.getRecordedCount(), (size_t)THREADS * (DRAWS_PER_THREAD + 1));
+    EXPECT_EQ(backend.getCount(RCommand::BIND_PROGRAM), THREADS);
+    EXPECT_EQ(backend.getCount(RCommand::DRAW_INDEXED), (uint64_t)THREADS * DRAWS_PER_THREAD);
+
+    uint64_t triangles = 0;
+    uint64_t instances = 0;
+    size_t next = 0;
+    for (unsigned int t = 0; t < THREADS; ++t)
+    {
+        const RCommand& bind = backend.getRecorded(next++);
+        ASSERT_EQ(bind.type, RCommand::BIND_PROGRAM);
+        EXPECT_EQ(bind.as<RBindProgramCommand>().program, t + 1);
+        for (uint32_t i = 0; i < DRAWS_PER_THREAD; ++i)
+        {
+            const RCommand& command = backend.getRecorded(next++);
+            ASSERT_EQ(command.type, RCommand::DRAW_INDEXED);
+            const RDrawIndexedCommand& draw = command.as<RDrawIndexedCommand>();
+            ASSERT_EQ(draw.primitive, PRIMITIVE_TRIANGLES);
+            ASSERT_EQ(draw.index32, (i & 1) != 0);
+            ASSERT_EQ(draw.indexCount, 3 * (i % 5 + 1));
+            ASSERT_EQ(draw.firstIndex, i);
+            ASSERT_EQ(draw.baseVertex, (int32_t)t);
+            ASSERT_EQ(draw.instanceCount, i % 3 + 1);
+            ASSERT_EQ(draw.baseInstance, t);
+            triangles += (i % 5 + 1) * (i % 3 + 1);
+            instances += i % 3 + 1;
+        }
+    }
+
+    const RRenderStats& stats = backend.getStats();
+    EXPECT_EQ(stats.commands, (uint64_t)THREADS * (DRAWS_PER_THREAD + 1));
+    EXPECT_EQ(stats.drawCalls, (uint64_t)THREADS * DRAWS_PER_THREAD);
+    EXPECT_EQ(stats.instances, instances);
+    EXPECT_EQ(stats.triangles, triangles);
+}
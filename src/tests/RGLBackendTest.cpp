@@ -0,0 +1,158 @@
+#include "RGLTest.h"
+
+#ifdef ROCKET_HAS_EGL
+
+using namespace rocket;
+
+// A clear recorded after a blend state that masks channels out must still clear every channel.
+TEST_F(RGLTest, ClearWritesEveryChannelAfterMaskedBlendState)
+{
+    RBlendState::Desc desc;
+    desc.writeMask = RBlendState::RED;
+    const RBlendState* redOnly = RBlendState::create(desc);
+
+    RGLBackend backend;
+    RCommandBuffer buffer;
+    buffer.bindFramebuffer(getFramebuffer());
+    buffer.setViewport(0, 0, WIDTH, 1);
+    buffer.bindBlendState(redOnly);
+    buffer.clear(RClearCommand::COLOR, RVector4(0.0f, 1.0f, 0.0f, 1.0f));
+    backend.submit(buffer);
+    EXPECT_EQ(readPixel(0), rgba(0, 255, 0, 255));
+
+    // Binding the masked state again must restore its mask rather than be elided.
+    buffer.reset();
+    buffer.bindBlendState(redOnly);
+    backend.submit(buffer);
+    GLboolean mask[4];
+    glGetBooleanv(GL_COLOR_WRITEMASK, mask);
+    EXPECT_TRUE(mask[0]);
+    EXPECT_FALSE(mask[1]);
+    EXPECT_FALSE(mask[2]);
+    EXPECT_FALSE(mask[3]);
+    EXPECT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+}
+
+// A recorded clear and indexed draw of the left half of the target read back as recorded.
+TEST_F(RGLTest, RecordedClearAndIndexedDrawReadBack)
+{
+    const ColorVertex vertices[4] = { { { -1.0f, -1.0f }, rgba(255, 0, 0, 255) },
+                                      { { 0.0f, -1.0f }, rgba(255, 0, 0, 255) },
+                                      { { 0.0f, 1.0f }, rgba(255, 0, 0, 255) },
+                                      { { -1.0f, 1.0f }, rgba(255, 0, 0, 255) } };
+    const uint16_t indices[6] = { 0, 1, 2, 0, 2, 3 };
+    GLuint buffers[2];
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[0]);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffers[1]);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    GLuint vertexArray = createColorVertexArray();
+    GLuint program = createColorProgram();
+    glBindVertexArray(0);
+
+    RGLBackend backend;
+    RCommandBuffer buffer;
+    buffer.bindFramebuffer(getFramebuffer());
+    buffer.setViewport(0, 0, WIDTH, 1);
+    buffer.clear(RClearCommand::COLOR, RVector4(0.0f, 0.0f, 1.0f, 1.0f));
+    buffer.bindProgram(program);
+    buffer.bindVertexArray(vertexArray);
+    buffer.bindVertexBuffer(0, buffers[0], 0, sizeof(ColorVertex));
+    buffer.bindIndexBuffer(buffers[1]);
+    buffer.drawIndexed(PRIMITIVE_TRIANGLES, false, 6);
+    backend.submit(buffer);
+
+    EXPECT_EQ(readPixel(0), rgba(255, 0, 0, 255));
+    EXPECT_EQ(readPixel(1), rgba(255, 0, 0, 255));
+    EXPECT_EQ(readPixel(2), rgba(0, 0, 255, 255));
+    EXPECT_EQ(readPixel(3), rgba(0, 0, 255, 255));
+    EXPECT_EQ(backend.getStats().drawCalls, 1u);
+    EXPECT_EQ(backend.getStats().triangles, 2u);
+
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteBuffers(2, buffers);
+    EXPECT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+}
+
+// A second buffer binding the same program, texture, blend and cull state issues no
+// GL calls; after invalidate() the same bindings go through again.
+TEST_F(RGLTest, StateCacheElidesRepeatedBindingsUntilInvalidated)
+{
+    GLuint program = createColorProgram();
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    const uint32_t texel = rgba(255, 255, 255, 255);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texel);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+
+    RBlendState::Desc blendDesc;
+    blendDesc.enabled = true;
+    const RBlendState* blend = RBlendState::create(blendDesc);
+    RCullState::Desc cullDesc;
+    cullDesc.mode = RCullState::BACK;
+    const RCullState* cull = RCullState::create(cullDesc);
+
+    RMetrics metrics;
+    RGLBackend backend;
+    backend.setMetrics(&metrics);
+    RGLStateCache& cache = backend.getStateCache();
+    RCommandBuffer buffer;
+    buffer.bindProgram(program);
+    buffer.bindTexture(0, RBindTextureCommand::TEXTURE_2D, texture);
+    buffer.bindBlendState(blend);
+    buffer.bindCullState(cull);
+
+    // The program; the texture unit and bind; the blend enable, factors, equations and
+    // mask; the cull enable, face and winding.
+    const uint64_t CALLS = 10;
+    uint64_t issued = cache.getIssuedCount();
+    uint64_t elided = cache.getElidedCount();
+    backend.submit(buffer);
+    EXPECT_EQ(cache.getIssuedCount() - issued, CALLS);
+    EXPECT_EQ(cache.getElidedCount() - elided, 0u);
+
+    issued = cache.getIssuedCount();
+    elided = cache.getElidedCount();
+    backend.submit(buffer);
+    EXPECT_EQ(cache.getIssuedCount() - issued, 0u);
+    EXPECT_EQ(cache.getElidedCount() - elided, CALLS);
+
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(metrics.find("gl_calls_issued")), (int64_t)CALLS);
+    EXPECT_EQ(metrics.getValue(metrics.find("gl_calls_elided")), (int64_t)CALLS);
+
+    // Code outside the cache resets the state; the cache must be told before the next submission.
+    glUseProgram(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    cache.invalidate();
+    issued = cache.getIssuedCount();
+    elided = cache.getElidedCount();
+    backend.submit(buffer);
+    EXPECT_EQ(cache.getIssuedCount() - issued, CALLS);
+    EXPECT_EQ(cache.getElidedCount() - elided, 0u);
+
+    GLint current = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &current);
+    EXPECT_EQ((GLuint)current, program);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &current);
+    EXPECT_EQ((GLuint)current, texture);
+    EXPECT_TRUE(glIsEnabled(GL_BLEND));
+    EXPECT_TRUE(glIsEnabled(GL_CULL_FACE));
+
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(metrics.find("gl_calls_issued")), (int64_t)CALLS);
+    EXPECT_EQ(metrics.getValue(metrics.find("gl_calls_elided")), 0);
+
+    glUseProgram(0);
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDeleteTextures(1, &texture);
+    EXPECT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+}
+
+#endif
@@ -0,0 +1,158 @@
+#pragma once
+#include "common.h"
+#include <gtest/gtest.h>
+
+#ifdef ROCKET_HAS_EGL
+
+namespace rocket
+{
+    /**
+     * Defines the fixture for tests that need an OpenGL context.
+     *
+     * Each test gets a headless core context (llvmpipe on machines without a
+     * GPU) and a bound WIDTH x 1 RGBA8 framebuffer to draw into and read back.
+     * Tests are skipped when no context can be created.
+     */
+    class RGLTest : public ::testing::Test
+    {
+    public:
+        static const int WIDTH = 4;
+
+    protected:
+        void SetUp() override
+        {
+            if (!_context.create(4, 5))
+            {
+                GTEST_SKIP() << "No headless OpenGL 4.5 context";
+            }
+            glGenTextures(1, &_target);
+            glBindTexture(GL_TEXTURE_2D, _target);
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, WIDTH, 1);
+            glGenFramebuffers(1, &_framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _target, 0);
+            glViewport(0, 0, WIDTH, 1);
+        }
+
+        void TearDown() override
+        {
+            if (_context.isValid())
+            {
+                for (GLuint program : _programs)
+                {
+                    glDeleteProgram(program);
+                }
+                glDeleteFramebuffers(1, &_framebuffer);
+                glDeleteTextures(1, &_target);
+                _context.destroy();
+            }
+        }
+
+        /**
+         * Returns the RGBA8 color of a pixel of the framebuffer, red in the lowest byte.
+         */
+        uint32_t readPixel(int x)
+        {
+            uint32_t pixel = 0;
+            glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+            glReadPixels(x, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+            return pixel;
+        }
+
+        /**
+         * Compiles and links a program, failing the test on errors. The fixture deletes it.
+         */
+        GLuint createProgram(const char* vertexSource, const char* fragmentSource)
+        {
+            GLuint program = glCreateProgram();
+            const char* sources[2] = { vertexSource, fragmentSource };
+            const GLenum types[2] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+            for (int i = 0; i < 2; ++i)
+            {
+                GLuint shader = glCreateShader(types[i]);
+                glShaderSource(shader, 1, &sources[i], nullptr);
+                glCompileShader(shader);
+                GLint compiled = 0;
+                glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+                char log[1024] = {};
+                glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                EXPECT_TRUE(compiled) << log;
+                glAttachShader(program, shader);
+                glDeleteShader(shader);
+            }
+            glLinkProgram(program);
+            GLint linked = 0;
+            glGetProgramiv(program, GL_LINK_STATUS, &linked);
+            EXPECT_TRUE(linked);
+            _programs.push_back(program);
+            return program;
+        }
+
+        /**
+         * Defines the vertex createColorProgram() draws: a clip-space position and an RGBA8 color.
+         */
+        struct ColorVertex
+        {
+            float position[2];
+            uint32_t color;
+        };
+
+        /**
+         * Creates a program drawing ColorVertex vertices from attributes 0 and 1.
+         */
+        GLuint createColorProgram()
+        {
+            return createProgram(R"(#version 450 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec4 color;
+out vec4 vertexColor;
+void main()
+{
+    vertexColor = color;
+    gl_Position = vec4(position, 0.0, 1.0);
+})",
+                                 R"(#version 450 core
+in vec4 vertexColor;
+out vec4 fragmentColor;
+void main()
+{
+    fragmentColor = vertexColor;
+})");
+        }
+
+        /**
+         * Creates a vertex array reading ColorVertex vertices from binding 0. The caller deletes it.
+         */
+        GLuint createColorVertexArray()
+        {
+            GLuint vertexArray = 0;
+            glGenVertexArrays(1, &vertexArray);
+            glBindVertexArray(vertexArray);
+            glEnableVertexAttribArray(0);
+            glVertexAttribFormat(0, 2, GL_FLOAT, GL_FALSE, offsetof(ColorVertex, position));
+            glVertexAttribBinding(0, 0);
+            glEnableVertexAttribArray(1);
+            glVertexAttribFormat(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, offsetof(ColorVertex, color));
+            glVertexAttribBinding(1, 0);
+            return vertexArray;
+        }
+
+        GLuint getFramebuffer() const { return _framebuffer; }
+
+    private:
+        RHeadlessContext _context;
+        GLuint _target = 0;
+        GLuint _framebuffer = 0;
+        std::vector<GLuint> _programs;
+    };
+
+    /**
+     * Packs a color the way readPixel() returns it.
+     */
+    inline uint32_t rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a)
+    {
+        return r | g << 8 | b << 16 | a << 24;
+    }
+}
+
+#endif
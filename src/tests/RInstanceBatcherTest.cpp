@@ -0,0 +1,116 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+RMeshInstance makeInstance(const RMesh* mesh, const RMaterial* material, float x)
+{
+    RMeshInstance instance(mesh, material);
+    RMatrix world;
+    RMatrix::createTranslation(x, 0.0f, 0.0f, &world);
+    instance.setWorld(world);
+    return instance;
+}
+
+}
+
+// Opaque instances merge into one draw; translucent ones are drawn singly, farthest first, after them.
+TEST(RInstanceBatcher, TranslucentInstancesDrawBackToFront)
+{
+    RMesh mesh(1, PRIMITIVE_TRIANGLES, false, 36);
+    RMaterial opaque(1);
+    RMaterial glass(1, 0, RBlendState::alphaBlend());
+
+    std::vector<RMeshInstance> instances;
+    const float glassPositions[] = { 30.0f, 90.0f, 10.0f, 60.0f };
+    for (float x : glassPositions)
+    {
+        instances.push_back(makeInstance(&mesh, &glass, x));
+        instances.push_back(makeInstance(&mesh, &opaque, x));
+    }
+
+    RInstanceBatcher batcher;
+    for (const RMeshInstance& instance : instances)
+    {
+        batcher.add(&instance);
+    }
+    batcher.build();
+    ASSERT_EQ(batcher.getBatchCount(), 5u);
+    std::vector<RInstanceData> data(batcher.getInstanceCount());
+    batcher.write(data.data());
+
+    RDrawList list;
+    batcher.submit(list, 0, RVector3::zero(), 100.0f);
+    list.sort();
+    ASSERT_EQ(list.getCount(), 5u);
+    EXPECT_EQ(list.getSorted(0).instanceCount, 4u);
+    EXPECT_FALSE(RSortKey::isTranslucent(list.getSortedKey(0)));
+
+    const float expected[] = { 90.0f, 60.0f, 30.0f, 10.0f };
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        const RDrawPacket& packet = list.getSorted(1 + i);
+        EXPECT_TRUE(RSortKey::isTranslucent(list.getSortedKey(1 + i)));
+        ASSERT_EQ(packet.instanceCount, 1u);
+        // The packet's instance is the one packed at its base instance.
+        EXPECT_EQ(data[packet.baseInstance].world[12], expected[i]);
+    }
+}
+
+// Materials share a pipeline id exactly when their program, blend and cull state all match.
+TEST(RInstanceBatcher, PipelineIdCoversBlendAndCullState)
+{
+    RMaterial a(7);
+    RMaterial b(7, 3);
+    RMaterial blended(7, 0, RBlendState::additive());
+    RMaterial unculled(7, 0, nullptr, RCullState::none());
+    RMaterial otherProgram(8);
+
+    EXPECT_EQ(a.getPipelineId(), b.getPipelineId());
+    EXPECT_NE(a.getPipelineId(), blended.getPipelineId());
+    EXPECT_NE(a.getPipelineId(), unculled.getPipelineId());
+    EXPECT_NE(blended.getPipelineId(), unculled.getPipelineId());
+    EXPECT_NE(a.getPipelineId(), otherProgram.getPipelineId());
+
+    RMesh mesh(1, PRIMITIVE_TRIANGLES, false, 36);
+    EXPECT_EQ(RSortKey::getPipeline(RSortKey::opaque(0, unculled.getPipelineId(), unculled.getId(), mesh.getId(), 0.0f)),
+              unculled.getPipelineId());
+}
+
+// Ids of destroyed meshes and materials are reused, so churning through many
+// never pushes the ids past what the sort key fields hold.
+TEST(RInstanceBatcher, MeshAndMaterialIdsAreReused)
+{
+    uint32_t meshId = 0;
+    uint32_t materialId = 0;
+    {
+        RMesh mesh(1, PRIMITIVE_TRIANGLES, false, 36);
+        RMaterial material(1);
+        meshId = mesh.getId();
+        materialId = material.getId();
+    }
+
+    uint32_t highestMesh = 0;
+    uint32_t highestMaterial = 0;
+    for (unsigned int i = 0; i < (1u << RSortKey::MATERIAL_BITS) * 2; ++i)
+    {
+        RMesh mesh(1, PRIMITIVE_TRIANGLES, false, 36);
+        RMaterial material(1);
+        highestMesh = std::max(highestMesh, mesh.getId());
+        highestMaterial = std::max(highestMaterial, material.getId());
+    }
+    EXPECT_LE(highestMesh, meshId);
+    EXPECT_LE(highestMaterial, materialId);
+
+    // Live objects never share an id.
+    std::vector<std::unique_ptr<RMesh>> meshes;
+    std::set<uint32_t> ids;
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        meshes.emplace_back(new RMesh(1, PRIMITIVE_TRIANGLES, false, 36));
+        EXPECT_TRUE(ids.insert(meshes.back()->getId()).second);
+    }
+}
@@ -0,0 +1,102 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+const unsigned int BLOCKS = 64;
+const size_t BLOCK_SIZE = 1000;
+
+// Kept reachable so the compiler cannot pair up and elide the allocations under test.
+void* volatile sink[BLOCKS];
+
+void allocateBlocks()
+{
+    for (unsigned int i = 0; i < BLOCKS; ++i)
+    {
+        sink[i] = ::operator new(BLOCK_SIZE);
+    }
+}
+
+void freeBlocks()
+{
+    for (unsigned int i = 0; i < BLOCKS; ++i)
+    {
+        ::operator delete(sink[i]);
+        sink[i] = nullptr;
+    }
+}
+
+RMemoryStats getStats(RMemoryTracker::Tag tag)
+{
+    RMemoryStats stats;
+    RMemoryTracker::getStats(tag, &stats);
+    return stats;
+}
+
+}
+
+// Allocations inside a scope move that tag's current, peak and count values, and only that tag's.
+TEST(RMemoryTrackerTest, ScopeChargesItsTag)
+{
+    ASSERT_TRUE(RMemoryTracker::isEnabled());
+    RMemoryTracker::endFrame();
+    const RMemoryStats before = getStats(RMemoryTracker::TAG_UI);
+
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_UI);
+        EXPECT_EQ(RMemoryTracker::getTag(), RMemoryTracker::TAG_UI);
+        allocateBlocks();
+    }
+    EXPECT_EQ(RMemoryTracker::getTag(), RMemoryTracker::TAG_GENERAL);
+
+    const RMemoryStats during = getStats(RMemoryTracker::TAG_UI);
+    EXPECT_EQ(during.currentBytes, before.currentBytes + BLOCKS * BLOCK_SIZE);
+    EXPECT_EQ(during.currentAllocations, before.currentAllocations + BLOCKS);
+    EXPECT_EQ(during.totalAllocations, before.totalAllocations + BLOCKS);
+
+    RMemoryTracker::endFrame();
+    const RMemoryStats sampled = getStats(RMemoryTracker::TAG_UI);
+    EXPECT_GE(sampled.peakFrameBytes, before.currentBytes + BLOCKS * BLOCK_SIZE);
+    EXPECT_EQ(sampled.frameAllocations, BLOCKS);
+
+    // Freed from outside the scope, the blocks are still returned to the tag they were charged to.
+    freeBlocks();
+    RMemoryTracker::endFrame();
+    const RMemoryStats after = getStats(RMemoryTracker::TAG_UI);
+    EXPECT_EQ(after.currentBytes, before.currentBytes);
+    EXPECT_EQ(after.currentAllocations, before.currentAllocations);
+    EXPECT_EQ(after.totalAllocations, before.totalAllocations + BLOCKS);
+    EXPECT_EQ(after.peakFrameBytes, sampled.peakFrameBytes);
+    EXPECT_EQ(after.frameAllocations, 0u);
+}
+
+// A job runs under the tag of the thread that scheduled it, on whichever worker and
+// fiber it lands, and keeps it across a wait that switches the fiber out.
+TEST(RMemoryTrackerTest, JobsRunUnderTheSubmittersTag)
+{
+    RJobSystem jobs(2);
+    const RMemoryStats before = getStats(RMemoryTracker::TAG_AUDIO);
+
+    RJobCounter counter;
+    {
+        RMemoryScope scope(RMemoryTracker::TAG_AUDIO);
+        jobs.run([&jobs]()
+        {
+            RJobCounter inner;
+            jobs.run([]() {}, &inner);
+            jobs.wait(inner);
+            EXPECT_EQ(RMemoryTracker::getTag(), RMemoryTracker::TAG_AUDIO);
+            allocateBlocks();
+        }, &counter);
+    }
+    jobs.wait(counter);
+
+    const RMemoryStats during = getStats(RMemoryTracker::TAG_AUDIO);
+    EXPECT_GE(during.currentBytes, before.currentBytes + BLOCKS * BLOCK_SIZE);
+    EXPECT_GE(during.currentAllocations, before.currentAllocations + BLOCKS);
+    freeBlocks();
+    EXPECT_EQ(getStats(RMemoryTracker::TAG_AUDIO).currentBytes, during.currentBytes - BLOCKS * BLOCK_SIZE);
+}
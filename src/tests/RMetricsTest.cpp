@@ -0,0 +1,158 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+// Each thread adds to its own block; endFrame() sums the blocks into the frame's value.
+TEST(RMetrics, CountersSumAcrossThreads)
+{
+    RMetrics metrics;
+    const RMetrics::Id INVALID = RMetrics::INVALID;
+    const RMetrics::Id custom = metrics.registerMetric("custom");
+    ASSERT_NE(custom, INVALID);
+    EXPECT_EQ(metrics.registerMetric("custom"), custom);
+    EXPECT_EQ(metrics.find("custom"), custom);
+
+    const unsigned int THREADS = 4;
+    const unsigned int ADDS = 1000;
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&metrics, custom]() {
+            for (unsigned int i = 0; i < ADDS; ++i)
+            {
+                metrics.add(RMetrics::DRAW_CALLS);
+                metrics.add(custom, 3);
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    metrics.add(RMetrics::DRAW_CALLS, 5);
+
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(RMetrics::DRAW_CALLS), (int64_t)(THREADS * ADDS + 5));
+    EXPECT_EQ(metrics.getValue(custom), (int64_t)(THREADS * ADDS * 3));
+
+    // A counter reads as the frame's total, not the running one.
+    metrics.add(custom);
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(RMetrics::DRAW_CALLS), 0);
+    EXPECT_EQ(metrics.getValue(custom), 1);
+    EXPECT_EQ(metrics.getFrameCount(), 2u);
+}
+
+// A gauge keeps its last value across frames until it is set again.
+TEST(RMetrics, GaugesHoldTheirLastValue)
+{
+    RMetrics metrics;
+    metrics.set(RMetrics::JOB_QUEUE_DEPTH, 5);
+    metrics.endFrame();
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(RMetrics::JOB_QUEUE_DEPTH), 5);
+
+    metrics.set(RMetrics::JOB_QUEUE_DEPTH, 7);
+    metrics.set(RMetrics::JOB_QUEUE_DEPTH, 2);
+    metrics.endFrame();
+    const RMetricSummary summary = metrics.getSummary(RMetrics::JOB_QUEUE_DEPTH);
+    EXPECT_EQ(summary.value, 2);
+    EXPECT_EQ(summary.min, 2);
+    EXPECT_EQ(summary.max, 5);
+    EXPECT_EQ(summary.frames, 3u);
+}
+
+TEST(RMetrics, PercentilesOfAKnownSequence)
+{
+    RMetrics metrics;
+    // 1..100 in a shuffled order, one value a frame.
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        metrics.add(RMetrics::TRIANGLES, (i * 37) % 100 + 1);
+        metrics.endFrame();
+    }
+    const RMetricSummary summary = metrics.getSummary(RMetrics::TRIANGLES);
+    EXPECT_EQ(summary.frames, 100u);
+    EXPECT_EQ(summary.min, 1);
+    EXPECT_EQ(summary.max, 100);
+    EXPECT_DOUBLE_EQ(summary.mean, 50.5);
+    EXPECT_EQ(summary.p50, 51);
+    EXPECT_EQ(summary.p95, 95);
+    EXPECT_EQ(summary.p99, 99);
+}
+
+// Past HISTORY frames the oldest values drop out of the window.
+TEST(RMetrics, WindowWraps)
+{
+    RMetrics metrics;
+    const unsigned int HISTORY = RMetrics::HISTORY;
+    const unsigned int FRAMES = HISTORY + 100;
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+    {
+        metrics.add(RMetrics::DRAW_CALLS, frame);
+        metrics.endFrame();
+    }
+    const RMetricSummary summary = metrics.getSummary(RMetrics::DRAW_CALLS);
+    EXPECT_EQ(summary.frames, HISTORY);
+    EXPECT_EQ(summary.value, (int64_t)FRAMES - 1);
+    EXPECT_EQ(summary.min, 100);
+    EXPECT_EQ(summary.max, (int64_t)FRAMES - 1);
+    EXPECT_DOUBLE_EQ(summary.mean, (100.0 + (FRAMES - 1)) / 2.0);
+    EXPECT_EQ(metrics.getValue(RMetrics::DRAW_CALLS), (int64_t)FRAMES - 1);
+}
+
+// The dump file gains one complete JSON object per interval.
+TEST(RMetrics, DumpFileAppendsALinePerInterval)
+{
+    const std::string path = ::testing::TempDir() + "rocket_metrics_dump.json";
+    std::remove(path.c_str());
+
+    RMetrics metrics;
+    metrics.setDumpFile(path, 10);
+    for (unsigned int frame = 0; frame < 35; ++frame)
+    {
+        metrics.add(RMetrics::DRAW_CALLS, 2);
+        metrics.endFrame();
+    }
+    metrics.setDumpFile(path, 0);
+    metrics.endFrame();
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);)
+    {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 3u);
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(lines[i].rfind("{\"frame\":" + std::to_string((i + 1) * 10) + ",\"metrics\":{", 0), 0u) << lines[i];
+        EXPECT_EQ(lines[i].substr(lines[i].size() - 2), "}}");
+        EXPECT_NE(lines[i].find("\"draw_calls\":{\"value\":2,\"min\":2,\"max\":2,\"mean\":2,\"p50\":2,\"p95\":2,\"p99\":2}"), std::string::npos);
+        EXPECT_NE(lines[i].find("\"audio_underruns\":"), std::string::npos);
+    }
+    file.close();
+    std::remove(path.c_str());
+}
+
+// Ids past the registered metrics, INVALID included, are dropped rather than written out of bounds.
+TEST(RMetrics, UnregisteredIdsAreIgnored)
+{
+    RMetrics metrics;
+    const unsigned int count = metrics.getMetricCount();
+    EXPECT_EQ(count, (unsigned int)RMetrics::BUILTIN_COUNT);
+    metrics.add(RMetrics::INVALID, 10);
+    metrics.set(RMetrics::INVALID, 10);
+    metrics.add(count, 10);
+    metrics.set(count, 10);
+    metrics.add(RMetrics::MAX_METRICS - 1, 10);
+    metrics.endFrame();
+
+    // A metric registered afterwards starts from nothing.
+    const RMetrics::Id late = metrics.registerMetric("late");
+    EXPECT_EQ(late, count);
+    metrics.endFrame();
+    EXPECT_EQ(metrics.getValue(late), 0);
+    EXPECT_EQ(metrics.getMetricCount(), count + 1);
+}
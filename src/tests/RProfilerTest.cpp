@@ -0,0 +1,109 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+const char ZONE_NAME[] = "ProfilerTest";
+
+size_t countZones(const std::string& trace)
+{
+    size_t count = 0;
+    for (size_t at = trace.find(ZONE_NAME); at != std::string::npos; at = trace.find(ZONE_NAME, at + 1))
+    {
+        ++count;
+    }
+    return count;
+}
+
+}
+
+// Exports run while a thread wraps its ring several times over; under ThreadSanitizer
+// this checks that copying slots the thread is overwriting is race-free.
+TEST(RProfiler, ExportWhileRecordingWrapsTheRing)
+{
+    const size_t CAPACITY = RProfiler::EVENTS_PER_THREAD;
+    const size_t ZONES = CAPACITY * 3;
+    RProfiler::clear();
+
+    std::atomic<bool> done(false);
+    std::thread recorder([&]() {
+        RProfiler::setThreadName("Recorder");
+        for (size_t i = 0; i < ZONES; ++i)
+        {
+            uint64_t start = RProfiler::now();
+            RProfiler::record(ZONE_NAME, start, start + 1);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    unsigned int exports = 0;
+    do
+    {
+        std::ostringstream stream;
+        RProfiler::writeChromeTrace(stream);
+        const std::string trace = stream.str();
+        EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+        EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+        EXPECT_LE(countZones(trace), CAPACITY);
+        ++exports;
+    } while (!done.load(std::memory_order_acquire));
+    recorder.join();
+    EXPECT_GT(exports, 0u);
+
+    // Once the thread is quiet the export holds exactly the last ring's worth.
+    std::ostringstream stream;
+    RProfiler::writeChromeTrace(stream);
+    const std::string trace = stream.str();
+    EXPECT_EQ(countZones(trace), CAPACITY);
+    EXPECT_NE(trace.find("\"name\":\"Recorder\""), std::string::npos);
+}
+
+// A thread gets a ring only once it records, and an exited thread's ring goes to
+// the next thread that records after its events have been exported.
+TEST(RProfiler, ThreadBuffersAreAllocatedLazilyAndReused)
+{
+    auto countThreads = [](const std::string& trace) {
+        size_t count = 0;
+        for (size_t at = trace.find("thread_name"); at != std::string::npos; at = trace.find("thread_name", at + 1))
+        {
+            ++count;
+        }
+        return count;
+    };
+    auto exportTrace = []() {
+        std::ostringstream stream;
+        RProfiler::writeChromeTrace(stream);
+        return stream.str();
+    };
+    RProfiler::clear();
+    const size_t threads = countThreads(exportTrace());
+
+    std::thread([]() { RProfiler::setThreadName("Named"); }).join();
+    std::string trace = exportTrace();
+    EXPECT_EQ(countThreads(trace), threads);
+    EXPECT_EQ(trace.find("\"name\":\"Named\""), std::string::npos);
+
+    auto recordOne = [](const char* name) {
+        RProfiler::setThreadName(name);
+        uint64_t start = RProfiler::now();
+        RProfiler::record(ZONE_NAME, start, start + 1);
+    };
+    std::thread(recordOne, "First").join();
+    trace = exportTrace();
+    EXPECT_EQ(countThreads(trace), threads + 1);
+    EXPECT_NE(trace.find("\"name\":\"First\""), std::string::npos);
+
+    std::thread(recordOne, "Second").join();
+    trace = exportTrace();
+    EXPECT_EQ(countThreads(trace), threads + 1);
+    EXPECT_EQ(trace.find("\"name\":\"First\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Second\""), std::string::npos);
+    EXPECT_EQ(countZones(trace), 1u);
+
+    // Clearing frees the exited thread's ring altogether.
+    RProfiler::clear();
+    EXPECT_EQ(countThreads(exportTrace()), threads);
+}
@@ -0,0 +1,157 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+const unsigned int PRODUCERS = 4;
+const unsigned int CONSUMERS = 4;
+const uint64_t VALUES_PER_PRODUCER = 50000;
+const size_t BATCH = 7;
+
+// Producer p pushes p * VALUES_PER_PRODUCER + i for every i, alternating single
+// pushes with batches of varying size, against a queue small enough to wrap often.
+template <typename Queue>
+void produce(Queue& queue, unsigned int producer)
+{
+    uint64_t next = producer * VALUES_PER_PRODUCER;
+    const uint64_t end = next + VALUES_PER_PRODUCER;
+    uint64_t values[BATCH];
+    unsigned int round = 0;
+    while (next < end)
+    {
+        if (round++ % 2 == 0)
+        {
+            if (!queue.tryPush(next))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            ++next;
+        }
+        else
+        {
+            size_t count = std::min<uint64_t>(1 + round % BATCH, end - next);
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = next + i;
+            }
+            size_t pushed = queue.tryPushBatch(values, count);
+            if (pushed == 0)
+            {
+                std::this_thread::yield();
+            }
+            next += pushed;
+        }
+    }
+}
+
+// Pops until every value has been seen, alternating single pops with batches.
+template <typename Queue>
+void consume(Queue& queue, std::atomic<uint64_t>& remaining, std::vector<std::atomic<uint32_t>>& seen)
+{
+    uint64_t values[BATCH];
+    unsigned int round = 0;
+    while (remaining.load(std::memory_order_relaxed) > 0)
+    {
+        size_t popped;
+        if (round++ % 2 == 0)
+        {
+            popped = queue.tryPop(values[0]) ? 1 : 0;
+        }
+        else
+        {
+            popped = queue.tryPopBatch(values, 1 + round % BATCH);
+        }
+        if (popped == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < popped; ++i)
+        {
+            seen[values[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+        remaining.fetch_sub(popped, std::memory_order_relaxed);
+    }
+}
+
+}
+
+TEST(RMpmcQueue, StressMixedSingleAndBatchDeliversEveryValueOnce)
+{
+    const uint64_t total = PRODUCERS * VALUES_PER_PRODUCER;
+    RMpmcQueue<uint64_t> queue(64);
+    std::vector<std::atomic<uint32_t>> seen(total);
+    std::atomic<uint64_t> remaining(total);
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < CONSUMERS; ++i)
+    {
+        threads.emplace_back([&] { consume(queue, remaining, seen); });
+    }
+    for (unsigned int i = 0; i < PRODUCERS; ++i)
+    {
+        threads.emplace_back([&queue, i] { produce(queue, i); });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint64_t wrong = 0;
+    for (uint64_t value = 0; value < total; ++value)
+    {
+        wrong += seen[value].load() != 1;
+    }
+    EXPECT_EQ(wrong, 0u);
+    EXPECT_EQ(queue.getSize(), 0u);
+}
+
+TEST(RSpscQueue, StressMixedSingleAndBatchKeepsOrder)
+{
+    RSpscQueue<uint64_t> queue(64);
+    uint64_t mismatches = 0;
+
+    std::thread consumer([&]
+    {
+        uint64_t expected = 0;
+        uint64_t values[BATCH];
+        unsigned int round = 0;
+        while (expected < VALUES_PER_PRODUCER)
+        {
+            size_t popped = round++ % 2 == 0 ? (queue.tryPop(values[0]) ? 1 : 0)
+                                             : queue.tryPopBatch(values, 1 + round % BATCH);
+            for (size_t i = 0; i < popped; ++i)
+            {
+                mismatches += values[i] != expected++;
+            }
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+    produce(queue, 0);
+    consumer.join();
+
+    EXPECT_EQ(mismatches, 0u);
+    EXPECT_EQ(queue.getSize(), 0u);
+}
+
+TEST(RMpmcQueue, BatchStopsAtCapacity)
+{
+    RMpmcQueue<int> queue(4);
+    int values[6] = { 1, 2, 3, 4, 5, 6 };
+    EXPECT_EQ(queue.tryPushBatch(values, 6), 4u);
+    EXPECT_FALSE(queue.tryPush(7));
+
+    int popped[6] = {};
+    EXPECT_EQ(queue.tryPopBatch(popped, 6), 4u);
+    EXPECT_EQ(popped[0], 1);
+    EXPECT_EQ(popped[3], 4);
+    int value;
+    EXPECT_FALSE(queue.tryPop(value));
+}
@@ -0,0 +1,84 @@
+#include "common.h"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace rocket;
+
+namespace
+{
+
+enum Distribution
+{
+    RANDOM,
+    // Only a few bytes vary, so most passes are skipped.
+    SPARSE,
+    // Many equal keys, so stability shows.
+    FEW_VALUES
+};
+
+std::vector<RSortItem> randomItems(size_t count, Distribution distribution, unsigned int seed)
+{
+    std::mt19937_64 random(seed);
+    std::vector<RSortItem> items(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t value = random();
+        switch (distribution)
+        {
+        case RANDOM:
+            items[i].key = value;
+            break;
+        case SPARSE:
+            items[i].key = (value & 0xFF00000000000000ull) | (value & 0x0000FF00ull);
+            break;
+        case FEW_VALUES:
+            items[i].key = (value % 5) << 40;
+            break;
+        }
+        items[i].index = (uint32_t)i;
+    }
+    return items;
+}
+
+void expectSortedLikeStableSort(size_t count, Distribution distribution, RJobSystem* jobs)
+{
+    std::vector<RSortItem> items = randomItems(count, distribution, (unsigned int)count + distribution);
+    std::vector<RSortItem> expected = items;
+    std::stable_sort(expected.begin(), expected.end(), [](const RSortItem& a, const RSortItem& b) { return a.key < b.key; });
+
+    std::vector<RSortItem> scratch(count);
+    RRadixSort::sort(items.data(), scratch.data(), count, jobs);
+    for (size_t i = 0; i < count; ++i)
+    {
+        ASSERT_EQ(items[i].key, expected[i].key) << "item " << i << " of " << count;
+        ASSERT_EQ(items[i].index, expected[i].index) << "item " << i << " of " << count;
+    }
+}
+
+// Covers the empty list, both sides of the insertion sort and parallel thresholds, and large lists.
+const size_t SIZES[] = { 0, 1, 2, 63, 64, 65, 1000, 32767, 32768, 32769, 100000, 300000 };
+
+}
+
+TEST(RRadixSort, SerialMatchesStableSort)
+{
+    for (size_t count : SIZES)
+    {
+        for (Distribution distribution : { RANDOM, SPARSE, FEW_VALUES })
+        {
+            expectSortedLikeStableSort(count, distribution, nullptr);
+        }
+    }
+}
+
+TEST(RRadixSort, JobSystemMatchesStableSort)
+{
+    RJobSystem jobs(3);
+    for (size_t count : SIZES)
+    {
+        for (Distribution distribution : { RANDOM, SPARSE, FEW_VALUES })
+        {
+            expectSortedLikeStableSort(count, distribution, &jobs);
+        }
+    }
+}
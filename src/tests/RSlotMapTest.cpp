@@ -0,0 +1,124 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+// Throws from its constructor when asked to, to check that emplace() leaves the map intact.
+struct Fragile
+{
+    int value;
+
+    Fragile(int value, bool fail) : value(value)
+    {
+        if (fail)
+        {
+            throw std::runtime_error("Fragile");
+        }
+    }
+};
+
+}
+
+// A handle to a removed value stays stale after its slot is given to a new value.
+TEST(RSlotMap, StaleHandleFailsAfterRemoveAndReinsert)
+{
+    RSlotMap<int> map;
+    const RHandle<int> first = map.insert(1);
+    EXPECT_FALSE(first.isNull());
+    ASSERT_TRUE(map.remove(first));
+    const RHandle<int> second = map.insert(2);
+
+    EXPECT_EQ(second.index, first.index);
+    EXPECT_NE(second.generation, first.generation);
+    EXPECT_FALSE(map.contains(first));
+    EXPECT_EQ(map.get(first), nullptr);
+    EXPECT_FALSE(map.remove(first));
+    ASSERT_NE(map.get(second), nullptr);
+    EXPECT_EQ(*map.get(second), 2);
+
+    EXPECT_FALSE(map.contains(RHandle<int>()));
+    map.clear();
+    EXPECT_FALSE(map.contains(second));
+    EXPECT_TRUE(map.empty());
+}
+
+// Removed slots are handed out again before new ones, and the values stay dense.
+TEST(RSlotMap, FreeSlotsAreReused)
+{
+    const unsigned int COUNT = 64;
+    RSlotMap<int> map;
+    std::vector<RHandle<int>> handles;
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        handles.push_back(map.insert((int)i));
+    }
+    for (unsigned int i = 0; i < COUNT; i += 2)
+    {
+        ASSERT_TRUE(map.remove(handles[i]));
+    }
+    EXPECT_EQ(map.size(), COUNT / 2);
+
+    for (unsigned int i = 0; i < COUNT; i += 2)
+    {
+        handles[i] = map.insert(1000 + (int)i);
+        EXPECT_LT(handles[i].index, COUNT);
+    }
+    EXPECT_EQ(map.size(), COUNT);
+    for (unsigned int i = 0; i < COUNT; ++i)
+    {
+        ASSERT_NE(map.get(handles[i]), nullptr);
+        EXPECT_EQ(*map.get(handles[i]), i % 2 == 0 ? 1000 + (int)i : (int)i);
+    }
+    for (size_t i = 0; i < map.size(); ++i)
+    {
+        EXPECT_EQ(map.get(map.getHandle(i)), map.data() + i);
+    }
+}
+
+// Generations skip zero, which marks null handles, when they wrap.
+TEST(RSlotMap, GenerationWrapsPastZero)
+{
+    EXPECT_EQ(RSlotMap<int>::nextGeneration(1), 2u);
+    EXPECT_EQ(RSlotMap<int>::nextGeneration(0xFFFFFFFEu), 0xFFFFFFFFu);
+    EXPECT_EQ(RSlotMap<int>::nextGeneration(0xFFFFFFFFu), 1u);
+
+    // Each removal moves the slot on one generation.
+    RSlotMap<int> map;
+    RHandle<int> handle = map.insert(0);
+    for (int i = 1; i <= 100; ++i)
+    {
+        const uint32_t generation = handle.generation;
+        ASSERT_TRUE(map.remove(handle));
+        handle = map.insert(i);
+        EXPECT_EQ(handle.generation, RSlotMap<int>::nextGeneration(generation));
+    }
+}
+
+// A constructor that throws publishes no slot and leaves every handle valid.
+TEST(RSlotMap, ThrowingConstructorLeavesMapUnchanged)
+{
+    RSlotMap<Fragile> map;
+    const RHandle<Fragile> a = map.emplace(1, false);
+    const RHandle<Fragile> b = map.emplace(2, false);
+    ASSERT_TRUE(map.remove(a));
+
+    EXPECT_THROW(map.emplace(3, true), std::runtime_error);
+    EXPECT_THROW(map.emplace(4, true), std::runtime_error);
+    EXPECT_EQ(map.size(), 1u);
+    ASSERT_NE(map.get(b), nullptr);
+    EXPECT_EQ(map.get(b)->value, 2);
+
+    // The freed slot is still free, and the next value takes it.
+    const RHandle<Fragile> c = map.emplace(5, false);
+    EXPECT_EQ(c.index, a.index);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.get(c)->value, 5);
+    EXPECT_EQ(map.get(b)->value, 2);
+    for (size_t i = 0; i < map.size(); ++i)
+    {
+        EXPECT_EQ(map.get(map.getHandle(i)), map.data() + i);
+    }
+}
@@ -0,0 +1,112 @@
+#include "RGLTest.h"
+
+#ifdef ROCKET_HAS_EGL
+
+using namespace rocket;
+
+// Ranges are aligned, never split across the end, and reused only once the GPU is done with them.
+TEST_F(RGLTest, StreamBufferRingWrapsAndDrains)
+{
+    ASSERT_TRUE(RStreamBuffer::isSupported());
+    const size_t FRAME_SIZE = 1000;
+    RStreamBuffer buffer(GL_ARRAY_BUFFER, FRAME_SIZE, 3);
+    ASSERT_EQ(buffer.getCapacity(), 3 * FRAME_SIZE);
+
+    unsigned int wraps = 0;
+    size_t previous = 0;
+    for (unsigned int frame = 0; frame < 2000; ++frame)
+    {
+        const size_t size = 100 + frame % 7 * 100;
+        size_t offset = 0;
+        unsigned char* data = (unsigned char*)buffer.reserve(size, 48, &offset);
+        ASSERT_NE(data, nullptr);
+        EXPECT_EQ(offset % 48, 0u);
+        EXPECT_LE(offset + size, buffer.getCapacity());
+        EXPECT_LE(buffer.getUsed(), buffer.getCapacity());
+        memset(data, (int)frame, size);
+        wraps += offset < previous ? 1 : 0;
+        previous = offset;
+        buffer.endFrame();
+    }
+    EXPECT_GT(wraps, 100u);
+
+    // A range larger than the buffer is refused rather than waited for.
+    size_t offset = 0;
+    EXPECT_EQ(buffer.reserve(buffer.getCapacity() + 1, 1, &offset), nullptr);
+
+    glFinish();
+    buffer.endFrame();
+    EXPECT_EQ(buffer.getUsed(), 0u);
+
+    // A range that only fits by wrapping an idle ring is handed out, frame after frame:
+    // 70 bytes fit neither after offset 60 nor, counting the skipped padding, in the ring.
+    RStreamBuffer small(GL_ARRAY_BUFFER, 100, 1);
+    ASSERT_NE(small.reserve(60, 1, &offset), nullptr);
+    small.endFrame();
+    glFinish();
+    for (unsigned int frame = 0; frame < 4; ++frame)
+    {
+        ASSERT_NE(small.reserve(70, 1, &offset), nullptr) << "frame " << frame;
+        EXPECT_EQ(offset, 0u);
+        small.endFrame();
+        glFinish();
+    }
+    small.endFrame();
+    EXPECT_EQ(small.getUsed(), 0u);
+    EXPECT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+}
+
+// Every frame streams a quad of a new color through both rings and reads it back.
+TEST_F(RGLTest, StreamedQuadsReadBackWhileTheRingsWrap)
+{
+    ASSERT_TRUE(RStreamBuffer::isSupported());
+    GLuint program = createColorProgram();
+    RVertexBuffer vertices(sizeof(ColorVertex), 4 * 3);
+    RIndexBuffer indices(RIndexBuffer::INDEX16, 6 * 3);
+
+    GLuint vertexArray = createColorVertexArray();
+    glBindVertexBuffer(0, vertices.getHandle(), 0, sizeof(ColorVertex));
+    indices.bind();
+    glUseProgram(program);
+
+    const unsigned int FRAMES = 300;
+    for (unsigned int frame = 0; frame < FRAMES; ++frame)
+    {
+        // Two quads a frame: the ring of three frames wraps every one and a half frames.
+        uint32_t color = 0;
+        for (unsigned int quad = 0; quad < 2; ++quad)
+        {
+            color = rgba(frame & 255, (frame * 7 + quad) & 255, quad * 255, 255);
+            unsigned int firstVertex = 0;
+            ColorVertex* vertex = vertices.allocate<ColorVertex>(4, &firstVertex);
+            ASSERT_NE(vertex, nullptr);
+            const float corners[4][2] = { { -1.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f }, { -1.0f, 1.0f } };
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                vertex[i] = { { corners[i][0], corners[i][1] }, color };
+            }
+
+            unsigned int firstIndex = 0;
+            uint16_t* index = (uint16_t*)indices.allocate(6, &firstIndex);
+            ASSERT_NE(index, nullptr);
+            const uint16_t quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+            memcpy(index, quadIndices, sizeof(quadIndices));
+
+            glDrawElementsBaseVertex(GL_TRIANGLES, 6, indices.getType(), indices.getOffset(firstIndex), (GLint)firstVertex);
+        }
+        vertices.endFrame();
+        indices.endFrame();
+
+        ASSERT_EQ(readPixel(frame % WIDTH), color) << "frame " << frame;
+    }
+
+    glFinish();
+    vertices.endFrame();
+    indices.endFrame();
+    EXPECT_EQ(vertices.getUsed(), 0u);
+    EXPECT_EQ(indices.getUsed(), 0u);
+    glDeleteVertexArrays(1, &vertexArray);
+    EXPECT_EQ(glGetError(), (GLenum)GL_NO_ERROR);
+}
+
+#endif
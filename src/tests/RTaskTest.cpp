@@ -0,0 +1,221 @@
+#include "common.h"
+#include <gtest/gtest.h>
+
+using namespace rocket;
+
+namespace
+{
+
+// Updates the scheduler until the condition holds, or fails after a few seconds.
+template <typename Condition>
+void updateUntil(RTaskScheduler& scheduler, Condition condition)
+{
+    const int64_t deadline = RClock::now() + RClock::toNanoseconds(5.0);
+    while (!condition() && RClock::now() < deadline)
+    {
+        scheduler.update();
+        std::this_thread::yield();
+    }
+    ASSERT_TRUE(condition());
+}
+
+RTask<int> chain(int depth)
+{
+    if (depth == 0)
+    {
+        co_return 0;
+    }
+    co_return 1 + co_await chain(depth - 1);
+}
+
+RTask<int> fail()
+{
+    throw std::runtime_error("task");
+    co_return 0;
+}
+
+// Sets a flag when the coroutine frame holding it is destroyed.
+struct FrameGuard
+{
+    bool* destroyed;
+
+    ~FrameGuard() { *destroyed = true; }
+};
+
+}
+
+// Each awaited task resumes its parent by symmetric transfer, so a deep chain runs to the end.
+TEST(RTask, AwaitedChainsRunToCompletion)
+{
+    RJobSystem jobs(1);
+    RTaskScheduler scheduler(&jobs);
+    int result = -1;
+    scheduler.spawn([](int* result) -> RTask<void> { *result = co_await chain(10000); }(&result));
+    EXPECT_EQ(result, 10000);
+
+    RTask<int> task = chain(3);
+    EXPECT_FALSE(task.isDone());
+}
+
+// A coroutine that awaits nextFrame() is resumed by the next REngine::present(), not before.
+TEST(RTask, NextFrameResumesOnTheNextPresent)
+{
+    const Ref<REngine>& engine = REngine::instance();
+    engine->setHeadless(true);
+    engine->init();
+    RTaskScheduler& scheduler = *engine->getTaskScheduler();
+
+    int steps = 0;
+    scheduler.spawn([](RTaskScheduler* scheduler, int* steps) -> RTask<void>
+    {
+        ++*steps;
+        co_await scheduler->nextFrame();
+        ++*steps;
+        co_await scheduler->nextFrame();
+        ++*steps;
+    }(&scheduler, &steps));
+
+    EXPECT_EQ(steps, 1);
+    EXPECT_EQ(scheduler.getPendingCount(), 1u);
+    engine->present();
+    EXPECT_EQ(steps, 2);
+    engine->present();
+    EXPECT_EQ(steps, 3);
+    EXPECT_EQ(scheduler.getPendingCount(), 0u);
+    engine->shutdown();
+}
+
+// wait(counter) resumes on the updating thread only once every job on the counter is done.
+TEST(RTask, WaitResumesOnceTheCounterIsDone)
+{
+    RJobSystem jobs(2);
+    RTaskScheduler scheduler(&jobs);
+    const unsigned int JOBS = 16;
+    std::atomic<unsigned int> finished(0);
+    RJobCounter counter;
+    for (unsigned int i = 0; i < JOBS; ++i)
+    {
+        jobs.run([&finished]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            finished.fetch_add(1);
+        }, &counter);
+    }
+
+    bool done = false;
+    unsigned int seen = 0;
+    std::thread::id thread;
+    scheduler.spawn([](RTaskScheduler* scheduler, RJobCounter* counter, std::atomic<unsigned int>* finished, unsigned int* seen,
+                       std::thread::id* thread, bool* done) -> RTask<void>
+    {
+        co_await scheduler->wait(*counter);
+        *seen = finished->load();
+        *thread = std::this_thread::get_id();
+        *done = true;
+    }(&scheduler, &counter, &finished, &seen, &thread, &done));
+
+    updateUntil(scheduler, [&done]() { return done; });
+    EXPECT_EQ(seen, JOBS);
+    EXPECT_EQ(thread, std::this_thread::get_id());
+}
+
+// run(fn) runs the function on a worker and resumes on the updating thread with its result.
+TEST(RTask, RunReturnsTheResultOnTheUpdatingThread)
+{
+    RJobSystem jobs(2);
+    RTaskScheduler scheduler(&jobs);
+    bool done = false;
+    std::thread::id worker;
+    std::thread::id resumed;
+    scheduler.spawn([](RTaskScheduler* scheduler, std::thread::id* worker, std::thread::id* resumed, bool* done) -> RTask<void>
+    {
+        // A named local, as readFile() does: GCC 12 mishandles awaiting a temporary awaitable with captures.
+        auto job = scheduler->run([worker]()
+        {
+            *worker = std::this_thread::get_id();
+            return 42;
+        });
+        int value = co_await job;
+        EXPECT_EQ(value, 42);
+        *resumed = std::this_thread::get_id();
+        *done = true;
+    }(&scheduler, &worker, &resumed, &done));
+
+    updateUntil(scheduler, [&done]() { return done; });
+    EXPECT_NE(worker, std::this_thread::get_id());
+    EXPECT_EQ(resumed, std::this_thread::get_id());
+}
+
+TEST(RTask, ReadFileReturnsTheContents)
+{
+    const std::string path = ::testing::TempDir() + "rocket_task_read.bin";
+    const std::string contents("rocket\0engine", 13);
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(contents.data(), (std::streamsize)contents.size());
+    }
+
+    RJobSystem jobs(1);
+    RTaskScheduler scheduler(&jobs);
+    bool done = false;
+    std::vector<char> data;
+    std::vector<char> missing(1);
+    scheduler.spawn([](RTaskScheduler* scheduler, std::string path, std::vector<char>* data, std::vector<char>* missing, bool* done) -> RTask<void>
+    {
+        *data = co_await scheduler->readFile(path);
+        *missing = co_await scheduler->readFile(path + ".missing");
+        *done = true;
+    }(&scheduler, path, &data, &missing, &done));
+
+    updateUntil(scheduler, [&done]() { return done; });
+    EXPECT_EQ(std::string(data.begin(), data.end()), contents);
+    EXPECT_TRUE(missing.empty());
+    std::remove(path.c_str());
+}
+
+// Exceptions reach whoever awaits the task or the job, and a detached task that throws
+// is destroyed and reported by the spawn() or update() call that resumed it.
+TEST(RTask, ExceptionsPropagate)
+{
+    RJobSystem jobs(1);
+    RTaskScheduler scheduler(&jobs);
+
+    bool done = false;
+    scheduler.spawn([](RTaskScheduler* scheduler, bool* done) -> RTask<void>
+    {
+        EXPECT_THROW(co_await fail(), std::runtime_error);
+        auto job = scheduler->run([]() -> int { throw std::logic_error("job"); });
+        EXPECT_THROW(co_await job, std::logic_error);
+        *done = true;
+    }(&scheduler, &done));
+    updateUntil(scheduler, [&done]() { return done; });
+
+    bool destroyed = false;
+    EXPECT_THROW(scheduler.spawn([](bool* destroyed) -> RTask<void>
+    {
+        FrameGuard guard = { destroyed };
+        co_await fail();
+    }(&destroyed)), std::runtime_error);
+    EXPECT_TRUE(destroyed);
+
+    // Thrown after a suspension, the exception comes out of update(), once the
+    // other coroutines due in that update have been resumed.
+    destroyed = false;
+    bool other = false;
+    scheduler.spawn([](RTaskScheduler* scheduler, bool* destroyed) -> RTask<void>
+    {
+        FrameGuard guard = { destroyed };
+        co_await scheduler->nextFrame();
+        throw std::runtime_error("detached");
+    }(&scheduler, &destroyed));
+    scheduler.spawn([](RTaskScheduler* scheduler, bool* other) -> RTask<void>
+    {
+        co_await scheduler->nextFrame();
+        *other = true;
+    }(&scheduler, &other));
+    EXPECT_FALSE(destroyed);
+    EXPECT_THROW(scheduler.update(), std::runtime_error);
+    EXPECT_TRUE(destroyed);
+    EXPECT_TRUE(other);
+    EXPECT_NO_THROW(scheduler.update());
+}
@@ -0,0 +1,120 @@
+#include "common.h"
+#include "RFiber.h"
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) && !defined(WIN32)
+// void rocketFiberSwitch(void** from, void* to)
+// Saves the callee-saved registers and the SSE/x87 control words on the current
+// stack, stores the stack pointer in *from, then restores the same from the stack at to.
+extern "C" void rocketFiberSwitch(void** from, void* to);
+asm(R"(
+    .text
+    .globl rocketFiberSwitch
+    .hidden rocketFiberSwitch
+    .type rocketFiberSwitch, @function
+rocketFiberSwitch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size rocketFiberSwitch, .-rocketFiberSwitch
+    .section .note.GNU-stack,"",@progbits
+)");
+#endif
+
+namespace rocket
+{
+    RFiber::RFiber(void (*entry)(), size_t stackSize) : _stack(nullptr), _stackSize(0)
+    {
+#ifndef WIN32
+        size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        stackSize = (stackSize + pageSize - 1) & ~(pageSize - 1);
+
+        // Reserve one extra page below the stack and make it inaccessible, so an
+        // overflow faults instead of silently corrupting the neighbouring stack.
+        void* memory = mmap(nullptr, stackSize + pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            throw std::bad_alloc();
+        }
+        mprotect(memory, pageSize, PROT_NONE);
+        _stack = memory;
+        _stackSize = stackSize + pageSize;
+        char* top = (char*)memory + _stackSize;
+
+#ifdef __x86_64__
+        // Lay out the frame rocketFiberSwitch() pops: the control words, six registers,
+        // then the entry point as the return address, followed by a null return address
+        // for the entry function itself so that it starts with the ABI's stack alignment.
+        uint64_t* sp = (uint64_t*)(top - 72);
+        sp[0] = 0x037F00001F80ull;  // mxcsr 0x1F80, x87 control word 0x037F
+        for (int i = 1; i <= 6; ++i)
+        {
+            sp[i] = 0;
+        }
+        sp[7] = (uint64_t)(uintptr_t)entry;
+        sp[8] = 0;
+        _context.stackPointer = sp;
+#else
+        getcontext(&_context.context);
+        _context.context.uc_stack.ss_sp = (char*)memory + pageSize;
+        _context.context.uc_stack.ss_size = stackSize;
+        _context.context.uc_link = nullptr;
+        makecontext(&_context.context, entry, 0);
+#endif
+#endif
+    }
+
+    RFiber::~RFiber()
+    {
+#ifndef WIN32
+        if (_stack)
+        {
+            munmap(_stack, _stackSize);
+        }
+#endif
+    }
+
+    void RFiber::switchTo(Context* from, Context* to)
+    {
+#if defined(__x86_64__) && !defined(WIN32)
+        rocketFiberSwitch(&from->stackPointer, to->stackPointer);
+#elif !defined(WIN32)
+        swapcontext(&from->context, &to->context);
+#endif
+    }
+
+    RFiber::Context* RFiber::getContext()
+    {
+        return &_context;
+    }
+
+    bool RFiber::isSupported()
+    {
+#ifdef WIN32
+        return false;
+#else
+        return true;
+#endif
+    }
+}
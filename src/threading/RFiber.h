@@ -0,0 +1,78 @@
+#pragma once
+#include "../common.h"
+
+#if !defined(WIN32) && !defined(__x86_64__)
+#include <ucontext.h>
+#endif
+
+namespace rocket
+{
+    /**
+     * Defines a user-mode fiber: a stack and a saved register context that can be
+     * switched to and from without involving the kernel.
+     *
+     * A fiber starts running its entry function the first time it is switched to.
+     * The entry function must never return; it switches away instead. On x86-64
+     * the switch is a few instructions that save the callee-saved registers;
+     * elsewhere it falls back to ucontext. Fibers are not available on Windows.
+     *
+     * Code running on a fiber may be resumed on a different thread than it was
+     * suspended on, so it must not keep pointers to thread_local data across a switch.
+     */
+    class API RFiber
+    {
+    public:
+        /**
+         * Defines a saved execution context, either of a fiber or of a thread's own stack.
+         */
+        struct Context
+        {
+#if defined(__x86_64__) && !defined(WIN32)
+            void* stackPointer;
+#elif !defined(WIN32)
+            ucontext_t context;
+#endif
+        };
+
+        /**
+         * The default stack size, in bytes.
+         */
+        static const size_t DEFAULT_STACK_SIZE = 64 * 1024;
+
+        /**
+         * Constructs a fiber.
+         *
+         * @param entry The function the fiber runs; it must never return.
+         * @param stackSize The size of the stack, in bytes. A guard page below it catches overflows.
+         */
+        RFiber(void (*entry)(), size_t stackSize = DEFAULT_STACK_SIZE);
+
+        ~RFiber();
+
+        RFiber(const RFiber&) = delete;
+        RFiber& operator=(const RFiber&) = delete;
+
+        /**
+         * Saves the calling context into from and switches to the context to.
+         *
+         * Returns when something switches back to from. Either context may belong
+         * to a thread's own stack rather than to a fiber.
+         */
+        static void switchTo(Context* from, Context* to);
+
+        /**
+         * Returns this fiber's context.
+         */
+        Context* getContext();
+
+        /**
+         * Returns true if fibers are supported on this platform.
+         */
+        static bool isSupported();
+
+    private:
+        Context _context;
+        void* _stack;
+        size_t _stackSize;
+    };
+}
@@ -0,0 +1,484 @@
+#include "common.h"
+#include "RJobSystem.h"
+
+namespace rocket
+{
+    namespace
+    {
+        // The system the calling thread belongs to, and its index in it.
+        thread_local RJobSystem* currentSystem = nullptr;
+        thread_local int currentIndex = -1;
+
+        // The number of times an idle worker looks for work before going to sleep.
+        const unsigned int IDLE_SPIN_COUNT = 64;
+
+        // The number of free fibers a thread keeps for itself.
+        const unsigned int FIBER_CACHE_SIZE = 4;
+    }
+
+    struct RJobSystem::Fiber
+    {
+        RFiber fiber;
+        RJob* job;
+        bool finished;
+        // The memory tag the fiber's job was running under when it last switched out.
+        RMemoryTracker::Tag memoryTag;
+        Fiber* next;
+
+        Fiber(size_t stackSize) :
+            fiber(&RJobSystem::fiberMain, stackSize), job(nullptr), finished(false), memoryTag(RMemoryTracker::TAG_GENERAL), next(nullptr)
+        {
+        }
+    };
+
+    // The fiber state of a thread. A fiber can be resumed on a different thread than
+    // it was suspended on, but the compiler assumes the address of a thread_local never
+    // changes within a function. Code that switches therefore always goes through
+    // getThreadState(), which is neither inlined nor treated as a pure function.
+    struct RJobSystem::ThreadState
+    {
+        RFiber::Context scheduler;
+        Fiber* fiber;
+        RJobCounter* pendingWait;
+    };
+
+#ifdef _MSC_VER
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    RJobSystem::ThreadState* RJobSystem::getThreadState()
+    {
+        static thread_local ThreadState state;
+        ThreadState* result = &state;
+#ifndef _MSC_VER
+        asm volatile("" : "+r"(result));
+#endif
+        return result;
+    }
+
+    RJobCounter::RJobCounter() : _value(0), _waiting(nullptr)
+    {
+    }
+
+    RJobCounter::~RJobCounter()
+    {
+    }
+
+    void RJobCounter::increment()
+    {
+        _value.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    RJob* RJobCounter::decrement()
+    {
+        unsigned int value = _value.load(std::memory_order_relaxed);
+        RJob* released = nullptr;
+        for (;;)
+        {
+            if ((value & COUNT_MASK) > 1 || !(value & WAITING_FLAG))
+            {
+                // Once the count reaches zero the counter may be destroyed by a waiter,
+                // so this exchange must be the last time it is touched.
+                if (_value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+                {
+                    return released;
+                }
+                continue;
+            }
+
+            // The last job is completing and others are waiting: take them first,
+            // then retry, since more may be added until the count reaches zero.
+            std::lock_guard<std::mutex> lock(_mutex);
+            RJob* waiting = _waiting;
+            _waiting = nullptr;
+            while (waiting)
+            {
+                RJob* next = waiting->next;
+                waiting->next = released;
+                released = waiting;
+                waiting = next;
+            }
+            value = _value.fetch_and(~WAITING_FLAG, std::memory_order_relaxed) & ~WAITING_FLAG;
+        }
+    }
+
+    bool RJobCounter::addWaiting(RJob* job)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        unsigned int value = _value.load(std::memory_order_acquire);
+        do
+        {
+            if ((value & COUNT_MASK) == 0)
+            {
+                return false;
+            }
+        } while (!_value.compare_exchange_weak(value, value | WAITING_FLAG, std::memory_order_acq_rel, std::memory_order_acquire));
+
+        job->next = _waiting;
+        _waiting = job;
+        return true;
+    }
+
+    RJobSystem::RJobSystem(unsigned int workerCount, unsigned int maxFibers, size_t fiberStackSize)
+        : _jobPool(256, true), _injectHead(nullptr), _injectTail(nullptr), _queued(0), _sleeping(0), _running(true),
+          _freeFibers(nullptr), _maxFibers(RFiber::isSupported() ? maxFibers : 0), _fiberStackSize(fiberStackSize)
+    {
+        if (workerCount == 0)
+        {
+            unsigned int hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+        _threadCount = workerCount + 1;
+        _workers.reset(new Worker[_threadCount]);
+
+        currentSystem = this;
+        currentIndex = 0;
+        for (unsigned int i = 0; i < _threadCount; ++i)
+        {
+            _workers[i].random = 0x9E3779B9u * (i + 1);
+            _workers[i].freeFibers = nullptr;
+            _workers[i].freeFiberCount = 0;
+        }
+        for (unsigned int i = 1; i < _threadCount; ++i)
+        {
+            _workers[i].thread = std::thread(&RJobSystem::workerMain, this, i);
+        }
+    }
+
+    RJobSystem::~RJobSystem()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _running.store(false);
+        }
+        _wake.notify_all();
+        for (unsigned int i = 1; i < _threadCount; ++i)
+        {
+            _workers[i].thread.join();
+        }
+
+        // Run whatever is left so that no counter is left waiting.
+        while (RJob* job = findJob(0))
+        {
+            execute(job);
+        }
+        if (currentSystem == this)
+        {
+            currentSystem = nullptr;
+            currentIndex = -1;
+        }
+    }
+
+    void RJobSystem::wait(RJobCounter& counter)
+    {
+        ThreadState* state = getThreadState();
+        if (state->fiber)
+        {
+            // Park the fiber. The scheduler registers it with the counter once the
+            // switch is complete, so it cannot be resumed before its context is saved.
+            if (!counter.isDone())
+            {
+                state->pendingWait = &counter;
+                RFiber::switchTo(state->fiber->fiber.getContext(), &state->scheduler);
+            }
+            return;
+        }
+
+        int thread = getThreadIndex();
+        while (!counter.isDone())
+        {
+            RJob* job = findJob(thread);
+            if (job)
+            {
+                execute(job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    unsigned int RJobSystem::getQueuedCount() const
+    {
+        int queued = _queued.load(std::memory_order_relaxed);
+        return queued > 0 ? (unsigned int)queued : 0;
+    }
+
+    unsigned int RJobSystem::getWorkerCount() const
+    {
+        return _threadCount - 1;
+    }
+
+    unsigned int RJobSystem::getThreadCount() const
+    {
+        return _threadCount;
+    }
+
+    int RJobSystem::getThreadIndex() const
+    {
+        return currentSystem == this ? currentIndex : -1;
+    }
+
+    void RJobSystem::schedule(RJob* job, RJobCounter* dependency)
+    {
+        if (dependency && dependency->addWaiting(job))
+        {
+            return;
+        }
+        submit(job);
+    }
+
+    void RJobSystem::submit(RJob* job)
+    {
+        int thread = getThreadIndex();
+        if (thread >= 0)
+        {
+            _workers[thread].queue.push(job);
+        }
+        else
+        {
+            job->next = nullptr;
+            std::lock_guard<std::mutex> lock(_injectMutex);
+            if (_injectTail)
+            {
+                _injectTail->next = job;
+            }
+            else
+            {
+                _injectHead.store(job, std::memory_order_relaxed);
+            }
+            _injectTail = job;
+        }
+
+        // Pairs with the check in workerMain(): either the worker sees the job or we see it sleeping.
+        _queued.fetch_add(1, std::memory_order_seq_cst);
+        if (_sleeping.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _wake.notify_one();
+        }
+    }
+
+    RJob* RJobSystem::findJob(int thread)
+    {
+        RJob* job = nullptr;
+        if (thread >= 0)
+        {
+            job = _workers[thread].queue.pop();
+        }
+
+        if (!job && _injectHead.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(_injectMutex);
+            job = _injectHead.load(std::memory_order_relaxed);
+            if (job)
+            {
+                _injectHead.store(job->next, std::memory_order_relaxed);
+                if (!job->next)
+                {
+                    _injectTail = nullptr;
+                }
+            }
+        }
+
+        if (!job && _threadCount > 1)
+        {
+            // Steal, starting from a random victim so thieves spread out.
+            uint32_t& random = _workers[thread >= 0 ? thread : 0].random;
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            unsigned int start = random % _threadCount;
+            for (unsigned int i = 0; i < _threadCount && !job; ++i)
+            {
+                unsigned int victim = (start + i) % _threadCount;
+                if ((int)victim != thread)
+                {
+                    job = _workers[victim].queue.steal();
+                }
+            }
+        }
+
+        if (job)
+        {
+            _queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    void RJobSystem::execute(RJob* job)
+    {
+        Fiber* fiber;
+        if (!job->invoke)
+        {
+            // A fiber whose wait is over.
+            fiber = *(Fiber**)job->storage;
+            _jobPool.destroy(job);
+        }
+        else
+        {
+            fiber = acquireFiber();
+            if (!fiber)
+            {
+                RMemoryTracker::Tag previous = RMemoryTracker::setTag(job->memoryTag);
+                job->invoke(job);
+                RMemoryTracker::setTag(previous);
+                complete(job);
+                return;
+            }
+            fiber->job = job;
+            fiber->finished = false;
+            fiber->memoryTag = job->memoryTag;
+        }
+
+        // This always runs on a thread's own stack, never on a fiber, so state stays valid across the switch.
+        // The memory tag is per thread, so it travels with the fiber rather than staying with the thread.
+        ThreadState* state = getThreadState();
+        state->fiber = fiber;
+        RMemoryTracker::Tag schedulerTag = RMemoryTracker::setTag(fiber->memoryTag);
+        RFiber::switchTo(&state->scheduler, fiber->fiber.getContext());
+        fiber->memoryTag = RMemoryTracker::setTag(schedulerTag);
+        state->fiber = nullptr;
+
+        if (fiber->finished)
+        {
+            RJob* done = fiber->job;
+            releaseFiber(fiber);
+            complete(done);
+        }
+        else
+        {
+            RJobCounter* counter = state->pendingWait;
+            state->pendingWait = nullptr;
+
+            RJob* resume = _jobPool.create();
+            resume->invoke = nullptr;
+            resume->destroy = nullptr;
+            resume->counter = nullptr;
+            resume->next = nullptr;
+            resume->memoryTag = fiber->memoryTag;
+            *(Fiber**)resume->storage = fiber;
+            schedule(resume, counter);
+        }
+    }
+
+    void RJobSystem::complete(RJob* job)
+    {
+        job->destroy(job);
+
+        RJobCounter* counter = job->counter;
+        _jobPool.destroy(job);
+        if (counter)
+        {
+            RJob* released = counter->decrement();
+            while (released)
+            {
+                RJob* next = released->next;
+                submit(released);
+                released = next;
+            }
+        }
+    }
+
+    RJobSystem::Fiber* RJobSystem::acquireFiber()
+    {
+        if (_maxFibers == 0)
+        {
+            return nullptr;
+        }
+
+        // Each thread keeps a few free fibers of its own so the common case takes no lock.
+        int thread = getThreadIndex();
+        if (thread >= 0 && _workers[thread].freeFibers)
+        {
+            Worker& worker = _workers[thread];
+            Fiber* fiber = worker.freeFibers;
+            worker.freeFibers = fiber->next;
+            worker.freeFiberCount--;
+            return fiber;
+        }
+
+        std::lock_guard<std::mutex> lock(_fiberMutex);
+        Fiber* fiber = _freeFibers;
+        if (fiber)
+        {
+            _freeFibers = fiber->next;
+        }
+        else if (_fibers.size() < _maxFibers)
+        {
+            fiber = new Fiber(_fiberStackSize);
+            _fibers.emplace_back(fiber);
+        }
+        return fiber;
+    }
+
+    void RJobSystem::releaseFiber(Fiber* fiber)
+    {
+        int thread = getThreadIndex();
+        if (thread >= 0 && _workers[thread].freeFiberCount < FIBER_CACHE_SIZE)
+        {
+            Worker& worker = _workers[thread];
+            fiber->next = worker.freeFibers;
+            worker.freeFibers = fiber;
+            worker.freeFiberCount++;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_fiberMutex);
+        fiber->next = _freeFibers;
+        _freeFibers = fiber;
+    }
+
+    void RJobSystem::fiberMain()
+    {
+        for (;;)
+        {
+            ThreadState* state = getThreadState();
+            Fiber* fiber = state->fiber;
+            fiber->job->invoke(fiber->job);
+            fiber->finished = true;
+
+            // The job may have waited and been resumed on another thread.
+            state = getThreadState();
+            RFiber::switchTo(fiber->fiber.getContext(), &state->scheduler);
+        }
+    }
+
+    void RJobSystem::workerMain(unsigned int index)
+    {
+        currentSystem = this;
+        currentIndex = (int)index;
+#ifdef ROCKET_PROFILING
+        RProfiler::setThreadName("Worker " + std::to_string(index));
+#endif
+
+        unsigned int idle = 0;
+        while (_running.load(std::memory_order_relaxed))
+        {
+            RJob* job = findJob((int)index);
+            if (job)
+            {
+                execute(job);
+                idle = 0;
+                continue;
+            }
+
+            if (++idle < IDLE_SPIN_COUNT)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _sleeping.fetch_add(1, std::memory_order_seq_cst);
+            while (_queued.load(std::memory_order_seq_cst) <= 0 && _running.load())
+            {
+                _wake.wait(lock);
+            }
+            _sleeping.fetch_sub(1, std::memory_order_seq_cst);
+            idle = 0;
+        }
+    }
+}
@@ -0,0 +1,221 @@
+#pragma once
+#include "../common.h"
+#include "RWorkStealingQueue.h"
+#include "RFiber.h"
+#include <atomic>
+#include <condition_variable>
+
+namespace rocket
+{
+    /**
+     * Defines a unit of work scheduled on an RJobSystem.
+     *
+     * The callable is stored inline when it fits, so scheduling a small lambda
+     * allocates nothing beyond a recycled job from the system's pool.
+     */
+    struct RJob
+    {
+        /**
+         * The number of bytes of callable stored inline.
+         */
+        static const size_t STORAGE_SIZE = 64;
+
+        void (*invoke)(RJob* job);
+        void (*destroy)(RJob* job);
+        RJobCounter* counter;
+        RJob* next;
+        // The memory tag of the thread that scheduled the job, which it runs under.
+        RMemoryTracker::Tag memoryTag;
+        alignas(std::max_align_t) unsigned char storage[STORAGE_SIZE];
+    };
+
+    /**
+     * Defines a counter of outstanding jobs.
+     *
+     * Every job scheduled with a counter increments it and decrements it when the
+     * job completes, so a counter reaching zero means a whole group of jobs is
+     * done. Jobs can also depend on a counter: they are held back until it reaches
+     * zero, which is how task graphs are built.
+     *
+     * A counter must outlive the jobs that signal it; RJobSystem::wait() returns
+     * only once the last job no longer touches it.
+     */
+    class API RJobCounter
+    {
+        friend class RJobSystem;
+    public:
+        RJobCounter();
+        ~RJobCounter();
+
+        RJobCounter(const RJobCounter&) = delete;
+        RJobCounter& operator=(const RJobCounter&) = delete;
+
+        /**
+         * Returns true if every job signalling this counter has completed.
+         */
+        bool isDone() const { return _value.load(std::memory_order_acquire) == 0; }
+
+        /**
+         * Returns the number of outstanding jobs.
+         */
+        unsigned int getValue() const { return _value.load(std::memory_order_acquire) & COUNT_MASK; }
+
+    private:
+        // Set while jobs are waiting on the counter; it is only ever set while the count is non-zero.
+        static const unsigned int WAITING_FLAG = 0x80000000u;
+        static const unsigned int COUNT_MASK = 0x7FFFFFFFu;
+
+        void increment();
+        RJob* decrement();
+        bool addWaiting(RJob* job);
+
+        std::atomic<unsigned int> _value;
+        RJob* _waiting;
+        std::mutex _mutex;
+    };
+
+    /**
+     * Defines a work-stealing job scheduler.
+     *
+     * There is one worker thread per additional hardware thread, each with its own
+     * RWorkStealingQueue. The thread that creates the system (the main thread) owns
+     * a queue too but only runs jobs while it waits, so waiting on a counter never
+     * idles a core. Idle workers steal from random victims and sleep when there is
+     * nothing to steal.
+     *
+     * Jobs scheduled from threads that do not belong to the system go through a
+     * shared, locked queue.
+     *
+     * Where fibers are supported, every job runs on a pooled RFiber. A job that
+     * waits on a counter then suspends its fiber instead of blocking its thread;
+     * the thread goes on with other jobs and the fiber is rescheduled, possibly
+     * on another thread, once the counter reaches zero. When the pool is used up
+     * jobs run directly on the thread's stack and waiting falls back to running
+     * other jobs until the counter is done.
+     */
+    class API RJobSystem
+    {
+    public:
+        /**
+         * Constructs a job system and starts its worker threads.
+         *
+         * @param workerCount The number of worker threads, or 0 to use one per hardware thread minus one.
+         * @param maxFibers The maximum number of fibers jobs run on, or 0 to run jobs on thread stacks.
+         * @param fiberStackSize The stack size of each fiber, in bytes.
+         */
+        explicit RJobSystem(unsigned int workerCount = 0, unsigned int maxFibers = 256, size_t fiberStackSize = RFiber::DEFAULT_STACK_SIZE);
+
+        /**
+         * Stops the worker threads. Jobs still queued are run first.
+         */
+        ~RJobSystem();
+
+        RJobSystem(const RJobSystem&) = delete;
+        RJobSystem& operator=(const RJobSystem&) = delete;
+
+        /**
+         * Schedules a job.
+         *
+         * @param function The callable to run, taking no arguments.
+         * @param counter The counter to signal when the job completes, or null.
+         * @param dependency A counter that must reach zero before the job may start, or null.
+         */
+        template <typename Function>
+        void run(Function&& function, RJobCounter* counter = nullptr, RJobCounter* dependency = nullptr);
+
+        /**
+         * Runs function(begin, end) over [0, count) split into chunks across all
+         * threads, and returns when every chunk is done.
+         *
+         * @param count The number of items.
+         * @param function The callable taking the unsigned int begin and end of a chunk.
+         * @param grainSize The minimum number of items per chunk, or 0 to pick one
+         *  that gives each thread a few chunks to balance uneven work.
+         */
+        template <typename Function>
+        void parallelFor(unsigned int count, Function&& function, unsigned int grainSize = 0);
+
+        /**
+         * Waits for a counter to reach zero.
+         *
+         * Called from a job running on a fiber, the fiber is suspended until the
+         * counter is done. Called from anywhere else, the calling thread runs other
+         * jobs in the meantime.
+         */
+        void wait(RJobCounter& counter);
+
+        /**
+         * Returns the number of worker threads, not counting the main thread.
+         */
+        unsigned int getWorkerCount() const;
+
+        /**
+         * Returns the number of threads that run jobs, including the main thread.
+         */
+        unsigned int getThreadCount() const;
+
+        /**
+         * Returns the number of jobs ready to run and not yet picked up by a thread.
+         */
+        unsigned int getQueuedCount() const;
+
+        /**
+         * Returns the index of the calling thread in this system (0 for the main
+         * thread, 1 and up for workers), or -1 for threads that do not belong to it.
+         */
+        int getThreadIndex() const;
+
+    private:
+        struct Fiber;
+        struct ThreadState;
+
+        struct alignas(64) Worker
+        {
+            RWorkStealingQueue queue;
+            std::thread thread;
+            uint32_t random;
+            Fiber* freeFibers;
+            unsigned int freeFiberCount;
+        };
+
+        template <typename Function>
+        RJob* createJob(Function&& function, RJobCounter* counter);
+
+        void submit(RJob* job);
+        void schedule(RJob* job, RJobCounter* dependency);
+        RJob* findJob(int thread);
+        void execute(RJob* job);
+        void complete(RJob* job);
+        void workerMain(unsigned int index);
+
+        Fiber* acquireFiber();
+        void releaseFiber(Fiber* fiber);
+        static ThreadState* getThreadState();
+        static void fiberMain();
+
+        std::unique_ptr<Worker[]> _workers;
+        unsigned int _threadCount;
+        RObjectPool<RJob> _jobPool;
+
+        // Jobs scheduled from threads outside the system.
+        std::mutex _injectMutex;
+        std::atomic<RJob*> _injectHead;
+        RJob* _injectTail;
+
+        // Idle workers sleep on _wake; _queued counts jobs that are ready to run.
+        std::atomic<int> _queued;
+        std::atomic<int> _sleeping;
+        std::atomic<bool> _running;
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+
+        // All fibers created so far, and the ones not running or suspended in a job.
+        std::vector<std::unique_ptr<Fiber>> _fibers;
+        Fiber* _freeFibers;
+        unsigned int _maxFibers;
+        size_t _fiberStackSize;
+        std::mutex _fiberMutex;
+    };
+}
+
+#include "RJobSystem.inl"
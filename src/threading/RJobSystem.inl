@@ -0,0 +1,76 @@
+#include "RJobSystem.h"
+
+namespace rocket
+{
+    template <typename Function>
+    RJob* RJobSystem::createJob(Function&& function, RJobCounter* counter)
+    {
+        typedef typename std::decay<Function>::type Callable;
+
+        RJob* job = _jobPool.create();
+        if constexpr (sizeof(Callable) <= RJob::STORAGE_SIZE && alignof(Callable) <= alignof(std::max_align_t))
+        {
+            new (job->storage) Callable(std::forward<Function>(function));
+            job->invoke = [](RJob* job) { (*(Callable*)job->storage)(); };
+            job->destroy = [](RJob* job) { ((Callable*)job->storage)->~Callable(); };
+        }
+        else
+        {
+            // Too big to store inline: keep it on the heap.
+            *(Callable**)job->storage = new Callable(std::forward<Function>(function));
+            job->invoke = [](RJob* job) { (**(Callable**)job->storage)(); };
+            job->destroy = [](RJob* job) { delete *(Callable**)job->storage; };
+        }
+        job->counter = counter;
+        job->next = nullptr;
+        job->memoryTag = RMemoryTracker::getTag();
+        if (counter)
+        {
+            counter->increment();
+        }
+        return job;
+    }
+
+    template <typename Function>
+    void RJobSystem::run(Function&& function, RJobCounter* counter, RJobCounter* dependency)
+    {
+        schedule(createJob(std::forward<Function>(function), counter), dependency);
+    }
+
+    template <typename Function>
+    void RJobSystem::parallelFor(unsigned int count, Function&& function, unsigned int grainSize)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (grainSize == 0)
+        {
+            // About four chunks per thread: enough to even out uneven chunks
+            // without paying the scheduling overhead for tiny ones.
+            grainSize = count / (_threadCount * 4);
+            if (grainSize < 1)
+            {
+                grainSize = 1;
+            }
+        }
+
+        unsigned int chunkCount = (count + grainSize - 1) / grainSize;
+        if (chunkCount == 1)
+        {
+            function(0u, count);
+            return;
+        }
+
+        // The calling thread takes the first chunk itself.
+        RJobCounter counter;
+        for (unsigned int chunk = 1; chunk < chunkCount; ++chunk)
+        {
+            unsigned int begin = chunk * grainSize;
+            unsigned int end = begin + grainSize < count ? begin + grainSize : count;
+            run([&function, begin, end]() { function(begin, end); }, &counter);
+        }
+        function(0u, grainSize);
+        wait(counter);
+    }
+}
@@ -0,0 +1,107 @@
+#include "common.h"
+#include "RTask.h"
+
+namespace rocket
+{
+    RTaskScheduler::RTaskScheduler(RJobSystem* jobSystem) : _jobSystem(jobSystem)
+    {
+    }
+
+    RTaskScheduler::~RTaskScheduler()
+    {
+        // Coroutines still waiting here are abandoned; their frames belong to the tasks awaiting them.
+    }
+
+    void RTaskScheduler::spawn(RTask<void> task)
+    {
+        if (task.isDone())
+        {
+            return;
+        }
+        std::coroutine_handle<RTask<void>::promise_type> handle = task._handle;
+        task._handle = nullptr;
+        handle.promise().scheduler = this;
+        handle.resume();
+        rethrowFailure();
+    }
+
+    void RTaskScheduler::update()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _resuming.swap(_ready);
+        }
+
+        // Coroutines posted while these run (including by nextFrame()) wait for the next update.
+        for (size_t i = 0; i < _resuming.size(); ++i)
+        {
+            _resuming[i].resume();
+        }
+        _resuming.clear();
+        rethrowFailure();
+    }
+
+    void RTaskScheduler::post(std::coroutine_handle<> handle)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _ready.push_back(handle);
+    }
+
+    void RTaskScheduler::fail(std::exception_ptr exception)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_failure)
+        {
+            _failure = exception;
+        }
+    }
+
+    void RTaskScheduler::rethrowFailure()
+    {
+        std::exception_ptr failure;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            failure.swap(_failure);
+        }
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    unsigned int RTaskScheduler::getPendingCount()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return (unsigned int)_ready.size();
+    }
+
+    void RTaskScheduler::CounterAwaitable::await_suspend(std::coroutine_handle<> handle)
+    {
+        // A job that depends on the counter hands the coroutine back to the main thread.
+        RTaskScheduler* target = scheduler;
+        scheduler->getJobSystem()->run([target, handle]() { target->post(handle); }, nullptr, counter);
+    }
+
+    RTask<std::vector<char>> RTaskScheduler::readFile(std::string path)
+    {
+        // Kept in a named local: GCC 12 destroys a temporary awaitable with a
+        // non-trivial capture twice when it is awaited directly.
+        auto read = run([path]()
+        {
+            std::vector<char> data;
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            if (file)
+            {
+                std::streamsize size = file.tellg();
+                file.seekg(0, std::ios::beg);
+                data.resize((size_t)size);
+                if (!file.read(data.data(), size))
+                {
+                    data.clear();
+                }
+            }
+            return data;
+        });
+        co_return co_await read;
+    }
+}
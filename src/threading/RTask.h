@@ -0,0 +1,231 @@
+#pragma once
+#include "../common.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+
+namespace rocket
+{
+    class RTaskScheduler;
+
+    template <typename T>
+    class RTask;
+
+    namespace detail
+    {
+        // Resumes the awaiting coroutine, if any, when a task finishes.
+        struct RTaskFinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept;
+
+            void await_resume() const noexcept {}
+        };
+
+        struct RTaskPromiseBase
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr exception;
+            // The scheduler a detached task was spawned on, which it reports its exception to.
+            RTaskScheduler* scheduler = nullptr;
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            RTaskFinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception();
+        };
+
+        template <typename T>
+        struct RTaskPromise : RTaskPromiseBase
+        {
+            std::optional<T> value;
+
+            RTask<T> get_return_object();
+
+            template <typename U>
+            void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+            T take();
+        };
+
+        template <>
+        struct RTaskPromise<void> : RTaskPromiseBase
+        {
+            RTask<void> get_return_object();
+
+            void return_void() {}
+
+            void take();
+        };
+    }
+
+    /**
+     * Defines an asynchronous operation written as a C++20 coroutine.
+     *
+     * A task does not start until it is awaited (co_await task) or handed to
+     * RTaskScheduler::spawn(). Awaiting a task suspends the caller until the task
+     * finishes and returns its result, or rethrows the exception it ended with.
+     * When the task finishes the awaiting coroutine is resumed directly, on
+     * whichever thread the task finished on.
+     *
+     * A task owns its coroutine frame and is move-only.
+     */
+    template <typename T = void>
+    class RTask
+    {
+    public:
+        typedef detail::RTaskPromise<T> promise_type;
+
+        RTask() : _handle(nullptr) {}
+        explicit RTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+        RTask(RTask&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+        RTask(const RTask&) = delete;
+        ~RTask();
+
+        RTask& operator=(RTask&& other) noexcept;
+        RTask& operator=(const RTask&) = delete;
+
+        /**
+         * Returns true if the task has run to completion.
+         */
+        bool isDone() const { return !_handle || _handle.done(); }
+
+        bool await_ready() const noexcept { return isDone(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept;
+        T await_resume();
+
+    private:
+        friend class RTaskScheduler;
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    /**
+     * Defines the main-thread side of coroutine execution.
+     *
+     * The scheduler owns detached tasks and resumes coroutines on the main thread
+     * once per frame from REngine. Its awaitables move work to the job system and
+     * come back to the main thread when it is done, so a coroutine can write
+     * co_await scheduler.readFile(path) without ever blocking a frame.
+     */
+    class API RTaskScheduler
+    {
+    public:
+        /**
+         * Constructs a scheduler that runs background work on the given job system.
+         */
+        explicit RTaskScheduler(RJobSystem* jobSystem);
+
+        ~RTaskScheduler();
+
+        RTaskScheduler(const RTaskScheduler&) = delete;
+        RTaskScheduler& operator=(const RTaskScheduler&) = delete;
+
+        /**
+         * Starts a task on the calling thread and lets it run to completion on its own.
+         *
+         * The task is started immediately and runs until its first suspension.
+         * An exception escaping a detached task ends it and destroys its frame like
+         * returning would, then is rethrown from the spawn() or update() call that
+         * resumed it, once that call has resumed everything else it was due to.
+         * Only the first such exception of a call is rethrown.
+         */
+        void spawn(RTask<void> task);
+
+        /**
+         * Resumes every coroutine posted since the last update and every coroutine
+         * that awaited nextFrame() before it. Called once per frame on the main thread.
+         */
+        void update();
+
+        /**
+         * Schedules a coroutine to be resumed by the next update(). Thread-safe.
+         */
+        void post(std::coroutine_handle<> handle);
+
+        /**
+         * Returns the number of coroutines waiting to be resumed by update().
+         */
+        unsigned int getPendingCount();
+
+        /**
+         * Returns the job system background work runs on.
+         */
+        RJobSystem* getJobSystem() const { return _jobSystem; }
+
+        struct NextFrameAwaitable
+        {
+            RTaskScheduler* scheduler;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler->post(handle); }
+            void await_resume() const noexcept {}
+        };
+
+        struct CounterAwaitable
+        {
+            RTaskScheduler* scheduler;
+            RJobCounter* counter;
+
+            bool await_ready() const noexcept { return counter->isDone(); }
+            void await_suspend(std::coroutine_handle<> handle);
+            void await_resume() const noexcept {}
+        };
+
+        template <typename Function>
+        struct JobAwaitable
+        {
+            typedef decltype(std::declval<Function&>()()) Result;
+            typedef typename std::conditional<std::is_void<Result>::value, bool, Result>::type Storage;
+
+            RTaskScheduler* scheduler;
+            Function function;
+            std::optional<Storage> result;
+            std::exception_ptr exception;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle);
+            Result await_resume();
+        };
+
+        /**
+         * Returns an awaitable that resumes the coroutine on the main thread in the next frame.
+         */
+        NextFrameAwaitable nextFrame() { return NextFrameAwaitable{ this }; }
+
+        /**
+         * Returns an awaitable that resumes the coroutine on the main thread once the counter reaches zero.
+         */
+        CounterAwaitable wait(RJobCounter& counter) { return CounterAwaitable{ this, &counter }; }
+
+        /**
+         * Returns an awaitable that runs function on the job system and resumes the
+         * coroutine on the main thread with its result.
+         */
+        template <typename Function>
+        JobAwaitable<typename std::decay<Function>::type> run(Function&& function);
+
+        /**
+         * Reads a whole file on the job system.
+         *
+         * @param path The path of the file.
+         * @return The contents of the file, or an empty vector if it could not be read.
+         */
+        RTask<std::vector<char>> readFile(std::string path);
+
+    private:
+        friend struct detail::RTaskFinalAwaiter;
+
+        void fail(std::exception_ptr exception);
+        void rethrowFailure();
+
+        RJobSystem* _jobSystem;
+        std::mutex _mutex;
+        std::vector<std::coroutine_handle<>> _ready;
+        std::vector<std::coroutine_handle<>> _resuming;
+        std::exception_ptr _failure;
+    };
+}
+
+#include "RTask.inl"
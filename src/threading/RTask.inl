@@ -0,0 +1,140 @@
+#include "RTask.h"
+
+namespace rocket
+{
+    namespace detail
+    {
+        template <typename Promise>
+        std::coroutine_handle<> RTaskFinalAwaiter::await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            RTaskPromiseBase& promise = handle.promise();
+            if (promise.scheduler)
+            {
+                // Nobody owns a detached task, so it cleans up after itself.
+                if (promise.exception)
+                {
+                    promise.scheduler->fail(promise.exception);
+                }
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            return promise.continuation ? promise.continuation : std::noop_coroutine();
+        }
+
+        inline void RTaskPromiseBase::unhandled_exception()
+        {
+            exception = std::current_exception();
+        }
+
+        template <typename T>
+        RTask<T> RTaskPromise<T>::get_return_object()
+        {
+            return RTask<T>(std::coroutine_handle<RTaskPromise<T>>::from_promise(*this));
+        }
+
+        template <typename T>
+        T RTaskPromise<T>::take()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+            return std::move(*value);
+        }
+
+        inline RTask<void> RTaskPromise<void>::get_return_object()
+        {
+            return RTask<void>(std::coroutine_handle<RTaskPromise<void>>::from_promise(*this));
+        }
+
+        inline void RTaskPromise<void>::take()
+        {
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+    }
+
+    template <typename T>
+    RTask<T>::~RTask()
+    {
+        if (_handle)
+        {
+            _handle.destroy();
+        }
+    }
+
+    template <typename T>
+    RTask<T>& RTask<T>::operator=(RTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (_handle)
+            {
+                _handle.destroy();
+            }
+            _handle = other._handle;
+            other._handle = nullptr;
+        }
+        return *this;
+    }
+
+    template <typename T>
+    std::coroutine_handle<> RTask<T>::await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        // Start the task; it resumes the awaiting coroutine when it finishes.
+        _handle.promise().continuation = awaiting;
+        return _handle;
+    }
+
+    template <typename T>
+    T RTask<T>::await_resume()
+    {
+        return _handle.promise().take();
+    }
+
+    template <typename Function>
+    void RTaskScheduler::JobAwaitable<Function>::await_suspend(std::coroutine_handle<> handle)
+    {
+        scheduler->getJobSystem()->run([this, handle]()
+        {
+            try
+            {
+                if constexpr (std::is_void<Result>::value)
+                {
+                    function();
+                    result.emplace(true);
+                }
+                else
+                {
+                    result.emplace(function());
+                }
+            }
+            catch (...)
+            {
+                exception = std::current_exception();
+            }
+            scheduler->post(handle);
+        });
+    }
+
+    template <typename Function>
+    typename RTaskScheduler::JobAwaitable<Function>::Result RTaskScheduler::JobAwaitable<Function>::await_resume()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        if constexpr (!std::is_void<Result>::value)
+        {
+            return std::move(*result);
+        }
+    }
+
+    template <typename Function>
+    RTaskScheduler::JobAwaitable<typename std::decay<Function>::type> RTaskScheduler::run(Function&& function)
+    {
+        return JobAwaitable<typename std::decay<Function>::type>{ this, std::forward<Function>(function), {}, nullptr };
+    }
+}
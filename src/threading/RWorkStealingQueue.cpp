@@ -0,0 +1,116 @@
+#include "common.h"
+#include "RWorkStealingQueue.h"
+
+namespace rocket
+{
+    RWorkStealingQueue::RWorkStealingQueue(unsigned int capacity) : _top(0), _bottom(0)
+    {
+        int64_t size = 2;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        _buffer.store(createBuffer(size), std::memory_order_relaxed);
+    }
+
+    RWorkStealingQueue::~RWorkStealingQueue()
+    {
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        while (buffer)
+        {
+            Buffer* retired = buffer->retired;
+            free(buffer);
+            buffer = retired;
+        }
+    }
+
+    void RWorkStealingQueue::push(RJob* job)
+    {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        int64_t top = _top.load(std::memory_order_acquire);
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->mask)
+        {
+            buffer = grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, job);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    RJob* RWorkStealingQueue::pop()
+    {
+        int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            // Empty.
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        RJob* job = buffer->get(bottom);
+        if (top == bottom)
+        {
+            // The last job: race the thieves for it.
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                job = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    RJob* RWorkStealingQueue::steal()
+    {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+        {
+            return nullptr;
+        }
+
+        Buffer* buffer = _buffer.load(std::memory_order_acquire);
+        RJob* job = buffer->get(top);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return nullptr;
+        }
+        return job;
+    }
+
+    bool RWorkStealingQueue::isEmpty() const
+    {
+        return _top.load(std::memory_order_relaxed) >= _bottom.load(std::memory_order_relaxed);
+    }
+
+    RWorkStealingQueue::Buffer* RWorkStealingQueue::createBuffer(int64_t capacity)
+    {
+        Buffer* buffer = (Buffer*)malloc(sizeof(Buffer) + (capacity - 1) * sizeof(std::atomic<RJob*>));
+        if (!buffer)
+        {
+            throw std::bad_alloc();
+        }
+        buffer->mask = capacity - 1;
+        buffer->retired = nullptr;
+        return buffer;
+    }
+
+    RWorkStealingQueue::Buffer* RWorkStealingQueue::grow(Buffer* buffer, int64_t top, int64_t bottom)
+    {
+        Buffer* bigger = createBuffer((buffer->mask + 1) * 2);
+        for (int64_t i = top; i < bottom; ++i)
+        {
+            bigger->put(i, buffer->get(i));
+        }
+        bigger->retired = buffer;
+        _buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../common.h"
+#include <atomic>
+
+namespace rocket
+{
+    struct RJob;
+
+    /**
+     * Defines a Chase-Lev work-stealing deque of jobs.
+     *
+     * The owning thread pushes and pops jobs at the bottom without locking, in
+     * LIFO order so the most recently spawned (and most cache-warm) work runs
+     * first. Any other thread can steal from the top, in FIFO order, which
+     * takes the oldest and typically largest pieces of work. The buffer grows
+     * as needed; retired buffers are kept until the queue is destroyed because
+     * a concurrent thief may still be reading them.
+     *
+     * Based on "Correct and Efficient Work-Stealing for Weak Memory Models"
+     * (Le, Pop, Cohen, Zappa Nardelli, 2013).
+     */
+    class API RWorkStealingQueue
+    {
+    public:
+        /**
+         * Constructs a queue with room for the given number of jobs (rounded up to a power of two).
+         */
+        explicit RWorkStealingQueue(unsigned int capacity = 1024);
+
+        ~RWorkStealingQueue();
+
+        RWorkStealingQueue(const RWorkStealingQueue&) = delete;
+        RWorkStealingQueue& operator=(const RWorkStealingQueue&) = delete;
+
+        /**
+         * Pushes a job at the bottom. Only the owning thread may call this.
+         */
+        void push(RJob* job);
+
+        /**
+         * Pops the most recently pushed job. Only the owning thread may call this.
+         *
+         * @return The job, or null if the queue is empty.
+         */
+        RJob* pop();
+
+        /**
+         * Steals the oldest job. May be called from any thread.
+         *
+         * @return The job, or null if the queue is empty or another thread won the race for it.
+         */
+        RJob* steal();
+
+        /**
+         * Returns true if the queue looked empty at the time of the call.
+         */
+        bool isEmpty() const;
+
+    private:
+        struct Buffer
+        {
+            int64_t mask;
+            Buffer* retired;
+            std::atomic<RJob*> jobs[1];
+
+            RJob* get(int64_t i) const { return jobs[i & mask].load(std::memory_order_relaxed); }
+            void put(int64_t i, RJob* job) { jobs[i & mask].store(job, std::memory_order_relaxed); }
+        };
+
+        static Buffer* createBuffer(int64_t capacity);
+        Buffer* grow(Buffer* buffer, int64_t top, int64_t bottom);
+
+        alignas(64) std::atomic<int64_t> _top;
+        alignas(64) std::atomic<int64_t> _bottom;
+        std::atomic<Buffer*> _buffer;
+    };
+}
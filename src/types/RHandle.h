@@ -0,0 +1,182 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines a weak, generational reference to an object stored in an RSlotMap.
+     *
+     * A handle is a 32-bit slot index and a 32-bit generation. Copying one is a
+     * plain 8-byte copy with no reference counting, and a handle whose object has
+     * been removed is detected because the slot's generation no longer matches.
+     */
+    template <typename T>
+    class RHandle
+    {
+    public:
+        /**
+         * Constructs a null handle.
+         */
+        RHandle() : index(0), generation(0) {}
+
+        /**
+         * Constructs a handle from the specified values.
+         */
+        RHandle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+        /**
+         * Returns true if this is a null handle. A non-null handle may still be stale.
+         */
+        bool isNull() const { return generation == 0; }
+
+        bool operator==(const RHandle& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const RHandle& other) const { return !(*this == other); }
+
+        /**
+         * The slot index.
+         */
+        uint32_t index;
+
+        /**
+         * The generation of the slot when the handle was created. Zero for a null handle.
+         */
+        uint32_t generation;
+    };
+
+    /**
+     * Defines a container that stores values densely and addresses them through RHandles.
+     *
+     * Values live in one contiguous array, so iterating over all of them is as fast
+     * as iterating a std::vector. Removing a value moves the last value into its
+     * place, so pointers and iteration order are not stable, but handles are.
+     * A lookup is a bounds check, a generation compare and two array reads.
+     *
+     * Not thread-safe.
+     */
+    template <typename T>
+    class RSlotMap
+    {
+    public:
+        typedef typename std::vector<T>::iterator iterator;
+        typedef typename std::vector<T>::const_iterator const_iterator;
+
+        RSlotMap();
+
+        /**
+         * Inserts a value and returns its handle.
+         */
+        RHandle<T> insert(const T& value);
+
+        /**
+         * Inserts a value and returns its handle.
+         */
+        RHandle<T> insert(T&& value);
+
+        /**
+         * Constructs a value in place and returns its handle. If the constructor
+         * throws, the map is left unchanged.
+         */
+        template <typename... Args>
+        RHandle<T> emplace(Args&&... args);
+
+        /**
+         * Removes the value referenced by the handle.
+         *
+         * @return true if the value was removed; false if the handle was null or stale.
+         */
+        bool remove(RHandle<T> handle);
+
+        /**
+         * Returns the value referenced by the handle, or null if the handle is null or stale.
+         *
+         * The pointer is invalidated by the next insert or remove.
+         */
+        inline T* get(RHandle<T> handle);
+
+        /**
+         * Returns the value referenced by the handle, or null if the handle is null or stale.
+         */
+        inline const T* get(RHandle<T> handle) const;
+
+        /**
+         * Returns true if the handle references a value in this map.
+         */
+        inline bool contains(RHandle<T> handle) const;
+
+        /**
+         * Returns the handle of the value at the given position in the dense array.
+         */
+        RHandle<T> getHandle(size_t denseIndex) const;
+
+        /**
+         * Removes every value. All existing handles become stale.
+         */
+        void clear();
+
+        /**
+         * Returns the generation a slot moves to when its value is removed. It wraps
+         * from 0xFFFFFFFF to 1, skipping the null generation; a handle that survives
+         * 2^32 - 1 removals from its slot would then match again.
+         */
+        static inline uint32_t nextGeneration(uint32_t generation);
+
+        /**
+         * Reserves storage for the given number of values.
+         */
+        void reserve(size_t count);
+
+        /**
+         * Returns the number of values.
+         */
+        size_t size() const { return _values.size(); }
+
+        /**
+         * Returns true if the map holds no values.
+         */
+        bool empty() const { return _values.empty(); }
+
+        /**
+         * Returns the dense array of values.
+         */
+        T* data() { return _values.data(); }
+        const T* data() const { return _values.data(); }
+
+        iterator begin() { return _values.begin(); }
+        iterator end() { return _values.end(); }
+        const_iterator begin() const { return _values.begin(); }
+        const_iterator end() const { return _values.end(); }
+
+    private:
+        struct Slot
+        {
+            // The position of the value in _values, or the next free slot if unused.
+            uint32_t index;
+            uint32_t generation;
+        };
+
+        // Marks the end of the free slot list.
+        static const uint32_t NONE = 0xFFFFFFFF;
+
+        // Publishes a slot for the value just appended to _values.
+        RHandle<T> allocateSlot();
+
+        std::vector<T> _values;
+        std::vector<uint32_t> _valueSlots;
+        std::vector<Slot> _slots;
+        uint32_t _freeHead;
+    };
+}
+
+namespace std
+{
+    template <typename T>
+    struct hash<rocket::RHandle<T>>
+    {
+        size_t operator()(const rocket::RHandle<T>& handle) const
+        {
+            return std::hash<uint64_t>()(((uint64_t)handle.generation << 32) | handle.index);
+        }
+    };
+}
+
+#include "RHandle.inl"
@@ -0,0 +1,147 @@
+#include "RHandle.h"
+
+namespace rocket
+{
+    template <typename T>
+    RSlotMap<T>::RSlotMap() : _freeHead(NONE)
+    {
+    }
+
+    template <typename T>
+    RHandle<T> RSlotMap<T>::insert(const T& value)
+    {
+        return emplace(value);
+    }
+
+    template <typename T>
+    RHandle<T> RSlotMap<T>::insert(T&& value)
+    {
+        return emplace(std::move(value));
+    }
+
+    template <typename T>
+    template <typename... Args>
+    RHandle<T> RSlotMap<T>::emplace(Args&&... args)
+    {
+        // The value is constructed before a slot is published, so a throwing constructor leaves the map as it was.
+        _values.emplace_back(std::forward<Args>(args)...);
+        try
+        {
+            return allocateSlot();
+        }
+        catch (...)
+        {
+            _values.pop_back();
+            throw;
+        }
+    }
+
+    template <typename T>
+    bool RSlotMap<T>::remove(RHandle<T> handle)
+    {
+        if (!contains(handle))
+        {
+            return false;
+        }
+
+        // Move the last value into the hole and repoint its slot.
+        Slot& slot = _slots[handle.index];
+        uint32_t index = slot.index;
+        uint32_t last = (uint32_t)_values.size() - 1;
+        if (index != last)
+        {
+            _values[index] = std::move(_values[last]);
+            _valueSlots[index] = _valueSlots[last];
+            _slots[_valueSlots[index]].index = index;
+        }
+        _values.pop_back();
+        _valueSlots.pop_back();
+
+        // Bumping the generation invalidates every outstanding handle to this slot.
+        slot.generation = nextGeneration(slot.generation);
+        slot.index = _freeHead;
+        _freeHead = handle.index;
+        return true;
+    }
+
+    template <typename T>
+    inline T* RSlotMap<T>::get(RHandle<T> handle)
+    {
+        return contains(handle) ? &_values[_slots[handle.index].index] : nullptr;
+    }
+
+    template <typename T>
+    inline const T* RSlotMap<T>::get(RHandle<T> handle) const
+    {
+        return contains(handle) ? &_values[_slots[handle.index].index] : nullptr;
+    }
+
+    template <typename T>
+    inline bool RSlotMap<T>::contains(RHandle<T> handle) const
+    {
+        return handle.index < _slots.size() && _slots[handle.index].generation == handle.generation;
+    }
+
+    template <typename T>
+    RHandle<T> RSlotMap<T>::getHandle(size_t denseIndex) const
+    {
+        uint32_t slot = _valueSlots[denseIndex];
+        return RHandle<T>(slot, _slots[slot].generation);
+    }
+
+    template <typename T>
+    void RSlotMap<T>::clear()
+    {
+        for (uint32_t slot : _valueSlots)
+        {
+            _slots[slot].generation = nextGeneration(_slots[slot].generation);
+            _slots[slot].index = _freeHead;
+            _freeHead = slot;
+        }
+        _values.clear();
+        _valueSlots.clear();
+    }
+
+    template <typename T>
+    void RSlotMap<T>::reserve(size_t count)
+    {
+        _values.reserve(count);
+        _valueSlots.reserve(count);
+        _slots.reserve(count);
+    }
+
+    template <typename T>
+    RHandle<T> RSlotMap<T>::allocateSlot()
+    {
+        // Both pushes may throw, so nothing is changed until they have succeeded.
+        uint32_t index = _freeHead != NONE ? _freeHead : (uint32_t)_slots.size();
+        _valueSlots.push_back(index);
+        if (index == _freeHead)
+        {
+            _freeHead = _slots[index].index;
+        }
+        else
+        {
+            try
+            {
+                _slots.push_back(Slot{ 0, 1 });
+            }
+            catch (...)
+            {
+                _valueSlots.pop_back();
+                throw;
+            }
+        }
+
+        Slot& slot = _slots[index];
+        slot.index = (uint32_t)_values.size() - 1;
+        return RHandle<T>(index, slot.generation);
+    }
+
+    template <typename T>
+    inline uint32_t RSlotMap<T>::nextGeneration(uint32_t generation)
+    {
+        // Zero marks null handles, so the generation wraps around to one.
+        return generation == 0xFFFFFFFF ? 1 : generation + 1;
+    }
+}
@@ -0,0 +1,36 @@
+#include "common.h"
+#include "RIdAllocator.h"
+
+namespace rocket
+{
+    RIdAllocator::RIdAllocator() :
+        _next(0)
+    {
+    }
+
+    uint32_t RIdAllocator::allocate()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_free.empty())
+        {
+            return _next++;
+        }
+        std::pop_heap(_free.begin(), _free.end(), std::greater<uint32_t>());
+        uint32_t id = _free.back();
+        _free.pop_back();
+        return id;
+    }
+
+    void RIdAllocator::release(uint32_t id)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(id);
+        std::push_heap(_free.begin(), _free.end(), std::greater<uint32_t>());
+    }
+
+    uint32_t RIdAllocator::getCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _next - (uint32_t)_free.size();
+    }
+}
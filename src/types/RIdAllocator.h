@@ -0,0 +1,46 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines a source of small dense ids.
+     *
+     * Released ids are handed out again before new ones, lowest first, so the
+     * ids in use stay below the number of objects alive at once rather than
+     * growing with every object ever created. Sort keys and batching tables
+     * sized by that number can then rely on the ids fitting.
+     *
+     * Thread-safe. Allocating and releasing take a lock, so ids suit objects
+     * created at load time rather than every frame.
+     */
+    class API RIdAllocator
+    {
+    public:
+        RIdAllocator();
+
+        RIdAllocator(const RIdAllocator&) = delete;
+        RIdAllocator& operator=(const RIdAllocator&) = delete;
+
+        /**
+         * Returns the lowest free id.
+         */
+        uint32_t allocate();
+
+        /**
+         * Makes an id returned by allocate() free again.
+         */
+        void release(uint32_t id);
+
+        /**
+         * Returns the number of ids in use.
+         */
+        uint32_t getCount() const;
+
+    private:
+        // A min-heap of released ids below _next.
+        std::vector<uint32_t> _free;
+        uint32_t _next;
+        mutable std::mutex _mutex;
+    };
+}
@@ -0,0 +1,345 @@
+#include "common.h"
+#include "RMemory.h"
+
+namespace rocket
+{
+    namespace
+    {
+        // Thread indices are handed out on first use and returned when the thread exits,
+        // so long-running programs that create short-lived threads do not run out of slots.
+        std::mutex threadIndexMutex;
+        std::vector<unsigned int> freeThreadIndices;
+        unsigned int nextThreadIndex = 0;
+
+        struct ThreadIndex
+        {
+            unsigned int index;
+
+            ThreadIndex()
+            {
+                std::lock_guard<std::mutex> lock(threadIndexMutex);
+                if (!freeThreadIndices.empty())
+                {
+                    index = freeThreadIndices.back();
+                    freeThreadIndices.pop_back();
+                }
+                else
+                {
+                    index = nextThreadIndex++;
+                }
+            }
+
+            ~ThreadIndex()
+            {
+                std::lock_guard<std::mutex> lock(threadIndexMutex);
+                freeThreadIndices.push_back(index);
+            }
+        };
+    }
+
+    RLinearArena::RLinearArena(size_t capacity)
+        : _cursor(nullptr), _end(nullptr), _blocks(nullptr), _used(0), _capacity(0), _peak(0)
+    {
+        if (capacity > 0)
+        {
+            addBlock(capacity);
+        }
+    }
+
+    RLinearArena::~RLinearArena()
+    {
+        while (_blocks)
+        {
+            Block* next = _blocks->next;
+            free(_blocks);
+            _blocks = next;
+        }
+    }
+
+    void* RLinearArena::allocateSlow(size_t size, size_t alignment)
+    {
+        // The current block is full: chain a new one at least twice as big as the last,
+        // with room for the request and its alignment padding.
+        size_t blockSize = _blocks ? _blocks->size * 2 : 4096;
+        if (blockSize < size + alignment)
+        {
+            blockSize = size + alignment;
+        }
+
+        // The padding lost at the end of the old block counts as used so that the
+        // peak covers everything and reset() sizes the merged block correctly.
+        _used += _end - _cursor;
+        addBlock(blockSize);
+        return allocate(size, alignment);
+    }
+
+    void RLinearArena::addBlock(size_t size)
+    {
+        Block* block = (Block*)malloc(sizeof(Block) + size);
+        if (!block)
+        {
+            throw std::bad_alloc();
+        }
+        block->next = _blocks;
+        block->size = size;
+        _blocks = block;
+        _capacity += size;
+        _cursor = (char*)(block + 1);
+        _end = _cursor + size;
+    }
+
+    void RLinearArena::reset()
+    {
+        if (_used > _peak)
+        {
+            _peak = _used;
+        }
+        _used = 0;
+
+        if (_blocks && _blocks->next)
+        {
+            // Replace the chain with a single block that fits the peak usage.
+            size_t size = _capacity > _peak ? _capacity : _peak;
+            while (_blocks)
+            {
+                Block* next = _blocks->next;
+                free(_blocks);
+                _blocks = next;
+            }
+            _capacity = 0;
+            addBlock(size);
+        }
+        else if (_blocks)
+        {
+            _cursor = (char*)(_blocks + 1);
+            _end = _cursor + _blocks->size;
+        }
+    }
+
+    size_t RLinearArena::getUsed() const
+    {
+        return _used;
+    }
+
+    size_t RLinearArena::getCapacity() const
+    {
+        return _capacity;
+    }
+
+    size_t RLinearArena::getPeak() const
+    {
+        return _used > _peak ? _used : _peak;
+    }
+
+    RSlabAllocator::RSlabAllocator(size_t blockSize, size_t blockAlignment, unsigned int blocksPerSlab, bool threadCache)
+        : _blockAlignment(blockAlignment < alignof(FreeBlock) ? alignof(FreeBlock) : blockAlignment),
+          _blocksPerSlab(blocksPerSlab > 0 ? blocksPerSlab : 1), _free(nullptr)
+    {
+        // Every block must be able to hold the free list link and keep the next block aligned.
+        _blockSize = blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize;
+        _blockSize = (_blockSize + _blockAlignment - 1) & ~(_blockAlignment - 1);
+
+        if (threadCache)
+        {
+            _caches.reset(new ThreadCache[RFrameArena::MAX_THREADS]);
+            for (unsigned int i = 0; i < RFrameArena::MAX_THREADS; ++i)
+            {
+                _caches[i].head = nullptr;
+                _caches[i].count = 0;
+            }
+        }
+    }
+
+    RSlabAllocator::~RSlabAllocator()
+    {
+        for (void* slab : _slabs)
+        {
+            ::operator delete(slab, std::align_val_t(_blockAlignment));
+        }
+    }
+
+    void* RSlabAllocator::allocate()
+    {
+        unsigned int thread = _caches ? RFrameArena::getThreadIndex() : RFrameArena::MAX_THREADS;
+        if (thread < RFrameArena::MAX_THREADS)
+        {
+            ThreadCache& cache = _caches[thread];
+            if (!cache.head)
+            {
+                cache.head = refill(CACHE_BATCH);
+                cache.count = CACHE_BATCH;
+            }
+            FreeBlock* block = cache.head;
+            cache.head = block->next;
+            cache.count--;
+            return block;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free)
+        {
+            addSlab();
+        }
+        FreeBlock* block = _free;
+        _free = block->next;
+        return block;
+    }
+
+    void RSlabAllocator::deallocate(void* block)
+    {
+        if (!block)
+        {
+            return;
+        }
+
+        FreeBlock* freeBlock = (FreeBlock*)block;
+        unsigned int thread = _caches ? RFrameArena::getThreadIndex() : RFrameArena::MAX_THREADS;
+        if (thread < RFrameArena::MAX_THREADS)
+        {
+            ThreadCache& cache = _caches[thread];
+            freeBlock->next = cache.head;
+            cache.head = freeBlock;
+            if (++cache.count < 2 * CACHE_BATCH)
+            {
+                return;
+            }
+
+            // The cache is full: give a batch back so other threads can reuse it.
+            FreeBlock* first = cache.head;
+            FreeBlock* last = first;
+            for (unsigned int i = 1; i < CACHE_BATCH; ++i)
+            {
+                last = last->next;
+            }
+            cache.head = last->next;
+            cache.count -= CACHE_BATCH;
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            last->next = _free;
+            _free = first;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        freeBlock->next = _free;
+        _free = freeBlock;
+    }
+
+    size_t RSlabAllocator::getBlockSize() const
+    {
+        return _blockSize;
+    }
+
+    size_t RSlabAllocator::getCapacity() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _slabs.size() * _blocksPerSlab;
+    }
+
+    RSlabAllocator::FreeBlock* RSlabAllocator::refill(unsigned int count)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        FreeBlock* head = nullptr;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            if (!_free)
+            {
+                addSlab();
+            }
+            FreeBlock* block = _free;
+            _free = block->next;
+            block->next = head;
+            head = block;
+        }
+        return head;
+    }
+
+    void RSlabAllocator::addSlab()
+    {
+        char* slab = (char*)::operator new(_blockSize * _blocksPerSlab, std::align_val_t(_blockAlignment));
+        _slabs.push_back(slab);
+
+        // Link the blocks in address order so a fresh slab is handed out sequentially.
+        for (unsigned int i = _blocksPerSlab; i > 0; --i)
+        {
+            FreeBlock* block = (FreeBlock*)(slab + (i - 1) * _blockSize);
+            block->next = _free;
+            _free = block;
+        }
+    }
+
+    RFrameArena::RFrameArena(unsigned int frameCount, size_t capacity)
+        : _frameCount(frameCount < 1 ? 1 : (frameCount > MAX_FRAMES ? MAX_FRAMES : frameCount)), _frame(0), _capacity(capacity)
+    {
+        for (unsigned int i = 0; i < MAX_FRAMES; ++i)
+        {
+            for (unsigned int j = 0; j < MAX_THREADS; ++j)
+            {
+                _arenas[i][j].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    RFrameArena::~RFrameArena()
+    {
+        for (unsigned int i = 0; i < MAX_FRAMES; ++i)
+        {
+            for (unsigned int j = 0; j < MAX_THREADS; ++j)
+            {
+                delete _arenas[i][j].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void RFrameArena::beginFrame()
+    {
+        _frame = (_frame + 1) % _frameCount;
+        for (unsigned int i = 0; i < MAX_THREADS; ++i)
+        {
+            RLinearArena* arena = _arenas[_frame][i].load(std::memory_order_relaxed);
+            if (arena)
+            {
+                arena->reset();
+            }
+        }
+    }
+
+    unsigned int RFrameArena::getFrameCount() const
+    {
+        return _frameCount;
+    }
+
+    size_t RFrameArena::getUsed() const
+    {
+        size_t used = 0;
+        for (unsigned int i = 0; i < MAX_THREADS; ++i)
+        {
+            RLinearArena* arena = _arenas[_frame][i].load(std::memory_order_acquire);
+            if (arena)
+            {
+                used += arena->getUsed();
+            }
+        }
+        return used;
+    }
+
+    unsigned int RFrameArena::getThreadIndex()
+    {
+        static thread_local ThreadIndex threadIndex;
+        return threadIndex.index;
+    }
+
+    RLinearArena* RFrameArena::createArena(unsigned int thread)
+    {
+        if (thread >= MAX_THREADS)
+        {
+            throw std::runtime_error("RFrameArena: too many threads allocating at once.");
+        }
+
+        // Only the owning thread ever writes its slot, so no lock is needed. A thread that
+        // inherits a recycled index also inherits the arena of the thread that exited.
+        RLinearArena* arena = new RLinearArena(_capacity);
+        _arenas[_frame][thread].store(arena, std::memory_order_release);
+        return arena;
+    }
+}
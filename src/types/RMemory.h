@@ -1,11 +1,521 @@
 #pragma once
+#include "../common.h"
 #include <memory>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <new>
+#include <utility>
 
 namespace rocket
 {
     template <typename T>
     using Ref = std::shared_ptr<T>;
 
-    template<typename T>
-    Ref<T> new_ref(T args) { return std::make_shared(args); }
-}
\ No newline at end of file
+    template<typename T, typename... Args>
+    Ref<T> new_ref(Args&&... args) { return std::make_shared<T>(std::forward<Args>(args)...); }
+
+    /**
+     * Defines the reference count embedded in objects managed by IntrusiveRef.
+     *
+     * The count lives inside the object itself, so an IntrusiveRef is a single
+     * pointer and creating one needs no separate control block. With Atomic set
+     * to false the count is a plain integer, which is cheaper to update but must
+     * only be used by objects that are never shared across threads (for example
+     * resources owned by a single-threaded resource manager).
+     *
+     * Copying an object does not copy its reference count.
+     */
+    template <bool Atomic>
+    class RRefCountedBase
+    {
+    public:
+        /**
+         * Increments the reference count.
+         */
+        void addRef() const
+        {
+            if constexpr (Atomic)
+                _count.fetch_add(1, std::memory_order_relaxed);
+            else
+                ++_count;
+        }
+
+        /**
+         * Decrements the reference count.
+         *
+         * @return true if the count reached zero and the caller must delete the object.
+         */
+        bool release() const
+        {
+            if constexpr (Atomic)
+                return _count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            else
+                return --_count == 0;
+        }
+
+        /**
+         * Returns the current reference count.
+         */
+        unsigned int getRefCount() const { return _count; }
+
+    protected:
+        RRefCountedBase() : _count(0) {}
+        RRefCountedBase(const RRefCountedBase&) : _count(0) {}
+        RRefCountedBase& operator=(const RRefCountedBase&) { return *this; }
+        ~RRefCountedBase() {}
+
+    private:
+        mutable typename std::conditional<Atomic, std::atomic<unsigned int>, unsigned int>::type _count;
+    };
+
+    /**
+     * A base class for objects shared between threads through IntrusiveRef.
+     */
+    typedef RRefCountedBase<true> RRefCounted;
+
+    /**
+     * A base class for objects that are only referenced from a single thread through IntrusiveRef.
+     */
+    typedef RRefCountedBase<false> RLocalRefCounted;
+
+    /**
+     * Defines a single-pointer smart pointer to an object deriving from RRefCounted
+     * or RLocalRefCounted.
+     *
+     * The object is deleted as a T when the last reference goes away, so if T is a
+     * base class of the real object it needs a virtual destructor.
+     */
+    template <typename T>
+    class IntrusiveRef
+    {
+    public:
+        IntrusiveRef() : _ptr(nullptr) {}
+
+        IntrusiveRef(std::nullptr_t) : _ptr(nullptr) {}
+
+        /**
+         * Takes a reference to the given object.
+         */
+        explicit IntrusiveRef(T* ptr) : _ptr(ptr)
+        {
+            if (_ptr)
+                _ptr->addRef();
+        }
+
+        IntrusiveRef(const IntrusiveRef& other) : _ptr(other._ptr)
+        {
+            if (_ptr)
+                _ptr->addRef();
+        }
+
+        IntrusiveRef(IntrusiveRef&& other) noexcept : _ptr(other._ptr)
+        {
+            other._ptr = nullptr;
+        }
+
+        template <typename U>
+        IntrusiveRef(const IntrusiveRef<U>& other) : _ptr(other.get())
+        {
+            if (_ptr)
+                _ptr->addRef();
+        }
+
+        ~IntrusiveRef()
+        {
+            if (_ptr && _ptr->release())
+                delete _ptr;
+        }
+
+        IntrusiveRef& operator=(const IntrusiveRef& other)
+        {
+            IntrusiveRef(other).swap(*this);
+            return *this;
+        }
+
+        IntrusiveRef& operator=(IntrusiveRef&& other) noexcept
+        {
+            IntrusiveRef(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        /**
+         * Releases the current object and takes a reference to the given one.
+         */
+        void reset(T* ptr = nullptr)
+        {
+            IntrusiveRef(ptr).swap(*this);
+        }
+
+        void swap(IntrusiveRef& other) noexcept
+        {
+            std::swap(_ptr, other._ptr);
+        }
+
+        T* get() const { return _ptr; }
+        T* operator->() const { return _ptr; }
+        T& operator*() const { return *_ptr; }
+        explicit operator bool() const { return _ptr != nullptr; }
+
+        template <typename U>
+        bool operator==(const IntrusiveRef<U>& other) const { return _ptr == other.get(); }
+        template <typename U>
+        bool operator!=(const IntrusiveRef<U>& other) const { return _ptr != other.get(); }
+        bool operator==(std::nullptr_t) const { return _ptr == nullptr; }
+        bool operator!=(std::nullptr_t) const { return _ptr != nullptr; }
+
+    private:
+        T* _ptr;
+    };
+
+    template<typename T, typename... Args>
+    IntrusiveRef<T> new_intrusive_ref(Args&&... args) { return IntrusiveRef<T>(new T(std::forward<Args>(args)...)); }
+
+    /**
+     * Defines a linear (bump) allocator.
+     *
+     * Allocation is a pointer increment inside a block of memory, and nothing is
+     * freed individually; reset() releases everything at once. When a block is
+     * full a new one is chained, and on the next reset() the blocks are merged
+     * into a single block big enough for the peak usage, so an arena that is reset
+     * every frame stops touching the heap after the first few frames.
+     *
+     * Destructors of objects created in the arena are never run. Only use it
+     * for trivially destructible data or call destructors yourself.
+     *
+     * An arena is not thread-safe; use one arena per thread (see RFrameArena).
+     */
+    class API RLinearArena
+    {
+    public:
+        /**
+         * Constructs an arena with an initial block of the given size.
+         *
+         * @param capacity The size of the first block, in bytes.
+         */
+        explicit RLinearArena(size_t capacity = 64 * 1024);
+
+        ~RLinearArena();
+
+        RLinearArena(const RLinearArena&) = delete;
+        RLinearArena& operator=(const RLinearArena&) = delete;
+
+        /**
+         * Allocates uninitialized memory from the arena.
+         *
+         * @param size The number of bytes.
+         * @param alignment The alignment, which must be a power of two.
+         * @return The allocated memory; never null.
+         */
+        inline void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        /**
+         * Allocates uninitialized memory for count objects of type T.
+         */
+        template <typename T>
+        inline T* allocate(size_t count = 1);
+
+        /**
+         * Constructs an object of type T in the arena.
+         */
+        template <typename T, typename... Args>
+        inline T* create(Args&&... args);
+
+        /**
+         * Releases every allocation made since the last reset.
+         */
+        void reset();
+
+        /**
+         * Returns the number of bytes allocated since the last reset, including alignment padding.
+         */
+        size_t getUsed() const;
+
+        /**
+         * Returns the total size of the blocks owned by the arena.
+         */
+        size_t getCapacity() const;
+
+        /**
+         * Returns the highest value getUsed() has reached.
+         */
+        size_t getPeak() const;
+
+    private:
+        struct Block
+        {
+            Block* next;
+            size_t size;
+        };
+
+        void* allocateSlow(size_t size, size_t alignment);
+        void addBlock(size_t size);
+
+        char* _cursor;
+        char* _end;
+        Block* _blocks;
+        size_t _used;
+        size_t _capacity;
+        size_t _peak;
+    };
+
+    /**
+     * Defines an STL allocator that allocates from an RLinearArena.
+     *
+     * deallocate() does nothing; memory comes back when the arena is reset, so
+     * containers using this allocator must not outlive the arena's current frame.
+     */
+    template <typename T>
+    class RArenaAllocator
+    {
+    public:
+        using value_type = T;
+
+        RArenaAllocator(RLinearArena* arena) noexcept : _arena(arena) {}
+
+        template <typename U>
+        RArenaAllocator(const RArenaAllocator<U>& other) noexcept : _arena(other.getArena()) {}
+
+        T* allocate(size_t n) { return _arena->allocate<T>(n); }
+
+        void deallocate(T*, size_t) noexcept {}
+
+        RLinearArena* getArena() const noexcept { return _arena; }
+
+        template <typename U>
+        bool operator==(const RArenaAllocator<U>& other) const noexcept { return _arena == other.getArena(); }
+
+        template <typename U>
+        bool operator!=(const RArenaAllocator<U>& other) const noexcept { return _arena != other.getArena(); }
+
+    private:
+        RLinearArena* _arena;
+    };
+
+    /**
+     * A std::vector whose storage lives in an arena.
+     */
+    template <typename T>
+    using RArenaVector = std::vector<T, RArenaAllocator<T>>;
+
+    /**
+     * Defines a slab allocator for blocks of a single fixed size.
+     *
+     * Blocks are carved out of large slabs and recycled through an intrusive free
+     * list, so creating and destroying many small objects never fragments the heap
+     * and recently freed blocks (still in cache) are reused first. Memory is only
+     * returned to the system when the allocator is destroyed.
+     *
+     * The allocator is thread-safe. With thread caches enabled each thread keeps a
+     * small private free list and only takes the lock to exchange blocks with the
+     * shared list in batches; without them every call takes the lock.
+     */
+    class API RSlabAllocator
+    {
+    public:
+        /**
+         * The number of blocks moved between a thread cache and the shared free list at once.
+         */
+        static const unsigned int CACHE_BATCH = 32;
+
+        /**
+         * Constructs a slab allocator.
+         *
+         * @param blockSize The size of each block, in bytes.
+         * @param blockAlignment The alignment of each block, which must be a power of two.
+         * @param blocksPerSlab The number of blocks allocated from the system at once.
+         * @param threadCache true to give each thread a private cache of free blocks.
+         */
+        RSlabAllocator(size_t blockSize, size_t blockAlignment, unsigned int blocksPerSlab = 256, bool threadCache = false);
+
+        ~RSlabAllocator();
+
+        RSlabAllocator(const RSlabAllocator&) = delete;
+        RSlabAllocator& operator=(const RSlabAllocator&) = delete;
+
+        /**
+         * Allocates one uninitialized block.
+         *
+         * @return The block; never null.
+         */
+        void* allocate();
+
+        /**
+         * Returns a block to the allocator. Blocks may be freed from any thread.
+         *
+         * @param block The block to free, or null.
+         */
+        void deallocate(void* block);
+
+        /**
+         * Returns the size of each block, in bytes.
+         */
+        size_t getBlockSize() const;
+
+        /**
+         * Returns the number of blocks allocated from the system so far.
+         */
+        size_t getCapacity() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        struct alignas(64) ThreadCache
+        {
+            FreeBlock* head;
+            unsigned int count;
+        };
+
+        FreeBlock* refill(unsigned int count);
+        void addSlab();
+
+        size_t _blockSize;
+        size_t _blockAlignment;
+        unsigned int _blocksPerSlab;
+        FreeBlock* _free;
+        std::vector<void*> _slabs;
+        std::unique_ptr<ThreadCache[]> _caches;
+        mutable std::mutex _mutex;
+    };
+
+    /**
+     * Defines a typed object pool backed by an RSlabAllocator.
+     *
+     * Objects are constructed in place with create() and must be released with
+     * destroy(), or handed out as Refs with makeRef(). The pool must outlive every
+     * object created from it.
+     */
+    template <typename T>
+    class RObjectPool
+    {
+    public:
+        /**
+         * Constructs an object pool.
+         *
+         * @param objectsPerSlab The number of objects allocated from the system at once.
+         * @param threadCache true to give each thread a private cache of free objects.
+         */
+        explicit RObjectPool(unsigned int objectsPerSlab = 256, bool threadCache = false)
+            : _allocator(sizeof(T), alignof(T), objectsPerSlab, threadCache) {}
+
+        /**
+         * Constructs a new object in the pool.
+         */
+        template <typename... Args>
+        inline T* create(Args&&... args);
+
+        /**
+         * Destroys an object created by this pool and returns its memory to the pool.
+         *
+         * @param object The object to destroy, or null.
+         */
+        inline void destroy(T* object);
+
+        /**
+         * Constructs a new object in the pool and returns a Ref that destroys it
+         * back into the pool when the last reference goes away.
+         *
+         * The object itself lives in the pool; the shared_ptr control block is
+         * still allocated separately (use IntrusiveRef to avoid it).
+         */
+        template <typename... Args>
+        inline Ref<T> makeRef(Args&&... args);
+
+        /**
+         * Returns the number of objects the pool can hold without allocating.
+         */
+        size_t getCapacity() const { return _allocator.getCapacity(); }
+
+    private:
+        RSlabAllocator _allocator;
+    };
+
+    /**
+     * Defines a multi-buffered, per-thread arena for per-frame scratch data.
+     *
+     * Each thread that allocates gets its own RLinearArena, so allocation needs
+     * no locking. Arenas are kept for frameCount frames: beginFrame() only resets
+     * the arenas of the frame being reused, so data allocated during the previous
+     * frameCount - 1 frames stays valid (for example while the GPU or a render
+     * thread consumes it).
+     */
+    class API RFrameArena
+    {
+    public:
+        /**
+         * The maximum number of frames that can be in flight.
+         */
+        static const unsigned int MAX_FRAMES = 3;
+
+        /**
+         * The maximum number of threads that can allocate from the arena at the same time.
+         */
+        static const unsigned int MAX_THREADS = 128;
+
+        /**
+         * Constructs a frame arena.
+         *
+         * @param frameCount The number of frames allocations stay valid for (1 to MAX_FRAMES).
+         * @param capacity The initial size of each per-thread arena, in bytes.
+         */
+        explicit RFrameArena(unsigned int frameCount = 2, size_t capacity = 256 * 1024);
+
+        ~RFrameArena();
+
+        RFrameArena(const RFrameArena&) = delete;
+        RFrameArena& operator=(const RFrameArena&) = delete;
+
+        /**
+         * Advances to the next frame and resets the arenas of the frame that is reused.
+         *
+         * Must be called when no other thread is allocating from this arena.
+         */
+        void beginFrame();
+
+        /**
+         * Returns the calling thread's arena for the current frame.
+         */
+        inline RLinearArena& get();
+
+        /**
+         * Allocates uninitialized memory from the calling thread's arena.
+         */
+        inline void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        /**
+         * Allocates uninitialized memory for count objects of type T from the calling thread's arena.
+         */
+        template <typename T>
+        inline T* allocate(size_t count = 1);
+
+        /**
+         * Returns the number of frames allocations stay valid for.
+         */
+        unsigned int getFrameCount() const;
+
+        /**
+         * Returns the number of bytes allocated by all threads during the current frame.
+         */
+        size_t getUsed() const;
+
+        /**
+         * Returns the index of the calling thread, used to pick its per-thread arena.
+         *
+         * Indices are small, dense and reused after a thread exits.
+         */
+        static unsigned int getThreadIndex();
+
+    private:
+        RLinearArena* createArena(unsigned int thread);
+
+        std::atomic<RLinearArena*> _arenas[MAX_FRAMES][MAX_THREADS];
+        unsigned int _frameCount;
+        unsigned int _frame;
+        size_t _capacity;
+    };
+}
+
+#include "RMemory.inl"
@@ -0,0 +1,80 @@
+#include "RMemory.h"
+
+namespace rocket
+{
+    inline void* RLinearArena::allocate(size_t size, size_t alignment)
+    {
+        uintptr_t cursor = (uintptr_t)_cursor;
+        uintptr_t aligned = (cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        if (aligned + size > (uintptr_t)_end)
+        {
+            return allocateSlow(size, alignment);
+        }
+        _cursor = (char*)(aligned + size);
+        _used += (aligned + size) - cursor;
+        return (void*)aligned;
+    }
+
+    template <typename T>
+    inline T* RLinearArena::allocate(size_t count)
+    {
+        return (T*)allocate(sizeof(T) * count, alignof(T));
+    }
+
+    template <typename T, typename... Args>
+    inline T* RLinearArena::create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    template <typename... Args>
+    inline T* RObjectPool<T>::create(Args&&... args)
+    {
+        void* block = _allocator.allocate();
+        try
+        {
+            return new (block) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            _allocator.deallocate(block);
+            throw;
+        }
+    }
+
+    template <typename T>
+    inline void RObjectPool<T>::destroy(T* object)
+    {
+        if (object)
+        {
+            object->~T();
+            _allocator.deallocate(object);
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    inline Ref<T> RObjectPool<T>::makeRef(Args&&... args)
+    {
+        return Ref<T>(create(std::forward<Args>(args)...), [this](T* object) { destroy(object); });
+    }
+
+    inline RLinearArena& RFrameArena::get()
+    {
+        unsigned int thread = getThreadIndex();
+        RLinearArena* arena = _arenas[_frame][thread].load(std::memory_order_acquire);
+        return arena ? *arena : *createArena(thread);
+    }
+
+    inline void* RFrameArena::allocate(size_t size, size_t alignment)
+    {
+        return get().allocate(size, alignment);
+    }
+
+    template <typename T>
+    inline T* RFrameArena::allocate(size_t count)
+    {
+        return get().allocate<T>(count);
+    }
+}
@@ -0,0 +1,402 @@
+#include "common.h"
+#include "RMemoryTracker.h"
+#ifdef ROCKET_MEMORY_CALLSTACKS
+#include <execinfo.h>
+#endif
+
+namespace rocket
+{
+    namespace
+    {
+        thread_local RMemoryTracker::Tag currentTag = RMemoryTracker::TAG_GENERAL;
+
+        const char* tagNames[RMemoryTracker::TAG_COUNT] =
+        {
+            "general", "application", "math", "graphics", "materials", "audio", "input", "networking", "ui"
+        };
+
+#ifdef ROCKET_MEMORY_TRACKING
+        // Counters are only written by the thread owning the slot, so plain relaxed
+        // loads and stores are enough and no locked instructions are needed. Threads
+        // beyond MAX_THREADS share the last slot and use atomic adds instead.
+        const unsigned int MAX_THREADS = 256;
+        const unsigned int SHARED_SLOT = MAX_THREADS - 1;
+
+        struct TagCounters
+        {
+            std::atomic<uint64_t> allocations;
+            std::atomic<uint64_t> frees;
+            std::atomic<uint64_t> allocatedBytes;
+            std::atomic<uint64_t> freedBytes;
+        };
+
+        struct alignas(64) ThreadCounters
+        {
+            std::atomic<bool> used;
+            TagCounters tags[RMemoryTracker::TAG_COUNT];
+        };
+
+        // Zero-initialized before any constructor runs, so allocations made during
+        // static initialization are counted too. A slot keeps its totals when its
+        // thread exits and the next thread to claim it keeps adding to them.
+        ThreadCounters threadCounters[MAX_THREADS];
+
+        struct ThreadSlot
+        {
+            unsigned int index;
+
+            ThreadSlot() : index(SHARED_SLOT)
+            {
+                for (unsigned int i = 0; i < SHARED_SLOT; ++i)
+                {
+                    bool expected = false;
+                    if (!threadCounters[i].used.load(std::memory_order_relaxed) &&
+                        threadCounters[i].used.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                    {
+                        index = i;
+                        break;
+                    }
+                }
+            }
+
+            ~ThreadSlot()
+            {
+                if (index != SHARED_SLOT)
+                {
+                    threadCounters[index].used.store(false, std::memory_order_release);
+                    index = SHARED_SLOT;
+                }
+            }
+        };
+
+        inline void add(std::atomic<uint64_t>& counter, uint64_t value, bool shared)
+        {
+            if (shared)
+                counter.fetch_add(value, std::memory_order_relaxed);
+            else
+                counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        inline TagCounters& getCounters(unsigned int tag, bool* shared)
+        {
+            static thread_local ThreadSlot slot;
+            *shared = slot.index == SHARED_SLOT;
+            return threadCounters[slot.index].tags[tag];
+        }
+
+        // Sampled by endFrame() only.
+        std::mutex frameMutex;
+        uint64_t peakFrameBytes[RMemoryTracker::TAG_COUNT + 1];
+        uint64_t lastTotalAllocations[RMemoryTracker::TAG_COUNT + 1];
+        uint64_t frameAllocations[RMemoryTracker::TAG_COUNT + 1];
+
+        void sum(unsigned int tag, RMemoryStats* dst)
+        {
+            uint64_t allocations = 0, frees = 0, allocatedBytes = 0, freedBytes = 0;
+            for (unsigned int i = 0; i < MAX_THREADS; ++i)
+            {
+                for (unsigned int j = 0; j < RMemoryTracker::TAG_COUNT; ++j)
+                {
+                    if (tag != RMemoryTracker::TAG_COUNT && tag != j)
+                    {
+                        continue;
+                    }
+                    const TagCounters& counters = threadCounters[i].tags[j];
+                    allocations += counters.allocations.load(std::memory_order_relaxed);
+                    frees += counters.frees.load(std::memory_order_relaxed);
+                    allocatedBytes += counters.allocatedBytes.load(std::memory_order_relaxed);
+                    freedBytes += counters.freedBytes.load(std::memory_order_relaxed);
+                }
+            }
+            // Counters of different threads are read at slightly different times,
+            // so clamp rather than report a transient underflow.
+            dst->currentBytes = allocatedBytes > freedBytes ? allocatedBytes - freedBytes : 0;
+            dst->currentAllocations = allocations > frees ? allocations - frees : 0;
+            dst->totalAllocations = allocations;
+        }
+
+        // The header stored in front of every allocation, so that delete knows the size
+        // and tag even when called from another thread or scope.
+        struct alignas(16) Header
+        {
+#ifdef ROCKET_MEMORY_CALLSTACKS
+            static const int MAX_FRAMES = 8;
+            Header* prev;
+            Header* next;
+            void* frames[MAX_FRAMES];
+            int frameCount;
+#endif
+            size_t size;
+            uint32_t tag;
+            uint32_t offset;
+        };
+
+#ifdef ROCKET_MEMORY_CALLSTACKS
+        // The list of live allocations. A spinlock, since it must work before any
+        // constructor has run and must not allocate.
+        std::atomic_flag liveLock = ATOMIC_FLAG_INIT;
+        Header liveList = { &liveList, &liveList, {}, 0, 0, 0, 0 };
+        thread_local bool inTracker = false;
+
+        void lockLive()
+        {
+            while (liveLock.test_and_set(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        void unlockLive()
+        {
+            liveLock.clear(std::memory_order_release);
+        }
+#endif
+
+        void* trackedAllocate(size_t size, size_t alignment) noexcept
+        {
+            if (alignment < alignof(Header))
+            {
+                alignment = alignof(Header);
+            }
+
+            // The user block is aligned and the header sits right in front of it.
+            size_t offset = (sizeof(Header) + alignment - 1) & ~(alignment - 1);
+            char* raw = (char*)malloc(offset + size + (alignment > alignof(std::max_align_t) ? alignment : 0));
+            if (!raw)
+            {
+                return nullptr;
+            }
+            char* user = (char*)(((uintptr_t)raw + offset + alignment - 1) & ~(uintptr_t)(alignment - 1));
+            Header* header = (Header*)user - 1;
+            header->size = size;
+            header->tag = currentTag;
+            header->offset = (uint32_t)(user - raw);
+
+#ifdef ROCKET_MEMORY_CALLSTACKS
+            header->frameCount = 0;
+            header->prev = header->next = header;
+            if (!inTracker)
+            {
+                // backtrace() may allocate the first time it runs; don't record those.
+                inTracker = true;
+                header->frameCount = backtrace(header->frames, Header::MAX_FRAMES);
+                lockLive();
+                header->next = liveList.next;
+                header->prev = &liveList;
+                liveList.next->prev = header;
+                liveList.next = header;
+                unlockLive();
+                inTracker = false;
+            }
+#endif
+
+            bool shared;
+            TagCounters& counters = getCounters(header->tag, &shared);
+            add(counters.allocations, 1, shared);
+            add(counters.allocatedBytes, size, shared);
+            return user;
+        }
+
+        void trackedFree(void* ptr) noexcept
+        {
+            if (!ptr)
+            {
+                return;
+            }
+            Header* header = (Header*)ptr - 1;
+
+#ifdef ROCKET_MEMORY_CALLSTACKS
+            if (header->next != header)
+            {
+                lockLive();
+                header->prev->next = header->next;
+                header->next->prev = header->prev;
+                unlockLive();
+            }
+#endif
+
+            bool shared;
+            TagCounters& counters = getCounters(header->tag, &shared);
+            add(counters.frees, 1, shared);
+            add(counters.freedBytes, header->size, shared);
+            free((char*)ptr - header->offset);
+        }
+
+        void* trackedNew(size_t size, size_t alignment)
+        {
+            void* ptr = trackedAllocate(size ? size : 1, alignment);
+            if (!ptr)
+            {
+                throw std::bad_alloc();
+            }
+            return ptr;
+        }
+#endif
+    }
+
+    bool RMemoryTracker::isEnabled()
+    {
+#ifdef ROCKET_MEMORY_TRACKING
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool RMemoryTracker::isCallstackEnabled()
+    {
+#ifdef ROCKET_MEMORY_CALLSTACKS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    RMemoryTracker::Tag RMemoryTracker::getTag()
+    {
+        return currentTag;
+    }
+
+    RMemoryTracker::Tag RMemoryTracker::setTag(Tag tag)
+    {
+        Tag previous = currentTag;
+        currentTag = tag;
+        return previous;
+    }
+
+    const char* RMemoryTracker::getTagName(Tag tag)
+    {
+        return tag < TAG_COUNT ? tagNames[tag] : "total";
+    }
+
+    void RMemoryTracker::getStats(Tag tag, RMemoryStats* dst)
+    {
+        memset(dst, 0, sizeof(RMemoryStats));
+#ifdef ROCKET_MEMORY_TRACKING
+        sum(tag, dst);
+        std::lock_guard<std::mutex> lock(frameMutex);
+        dst->peakFrameBytes = std::max(peakFrameBytes[tag], dst->currentBytes);
+        dst->frameAllocations = frameAllocations[tag];
+#else
+        (void)tag;
+#endif
+    }
+
+    void RMemoryTracker::endFrame()
+    {
+#ifdef ROCKET_MEMORY_TRACKING
+        std::lock_guard<std::mutex> lock(frameMutex);
+        for (unsigned int i = 0; i <= TAG_COUNT; ++i)
+        {
+            RMemoryStats stats;
+            sum(i, &stats);
+            peakFrameBytes[i] = std::max(peakFrameBytes[i], stats.currentBytes);
+            frameAllocations[i] = stats.totalAllocations - lastTotalAllocations[i];
+            lastTotalAllocations[i] = stats.totalAllocations;
+        }
+#endif
+    }
+
+    uint64_t RMemoryTracker::getFrameAllocations()
+    {
+#ifdef ROCKET_MEMORY_TRACKING
+        std::lock_guard<std::mutex> lock(frameMutex);
+        return frameAllocations[TAG_COUNT];
+#else
+        return 0;
+#endif
+    }
+
+    void RMemoryTracker::report(std::ostream& out)
+    {
+        char line[160];
+        snprintf(line, sizeof(line), "%-12s %14s %14s %12s %14s %10s\n", "tag", "current", "frame peak", "live", "total", "frame");
+        out << line;
+        for (unsigned int i = 0; i <= TAG_COUNT; ++i)
+        {
+            RMemoryStats stats;
+            getStats((Tag)i, &stats);
+            snprintf(line, sizeof(line), "%-12s %14llu %14llu %12llu %14llu %10llu\n", getTagName((Tag)i),
+                     (unsigned long long)stats.currentBytes, (unsigned long long)stats.peakFrameBytes,
+                     (unsigned long long)stats.currentAllocations, (unsigned long long)stats.totalAllocations,
+                     (unsigned long long)stats.frameAllocations);
+            out << line;
+        }
+    }
+
+    unsigned int RMemoryTracker::reportLeaks(std::ostream& out, Tag tag)
+    {
+#ifdef ROCKET_MEMORY_CALLSTACKS
+        struct Leak
+        {
+            size_t size;
+            uint32_t tag;
+            int frameCount;
+            void* frames[Header::MAX_FRAMES];
+        };
+
+        // Copy the list first; the vector's own allocations are not recorded while
+        // inTracker is set, so the lock is never taken recursively.
+        std::vector<Leak> leaks;
+        inTracker = true;
+        lockLive();
+        for (Header* header = liveList.next; header != &liveList; header = header->next)
+        {
+            if (tag == TAG_COUNT || header->tag == (uint32_t)tag)
+            {
+                Leak leak;
+                leak.size = header->size;
+                leak.tag = header->tag;
+                leak.frameCount = header->frameCount;
+                memcpy(leak.frames, header->frames, sizeof(leak.frames));
+                leaks.push_back(leak);
+            }
+        }
+        unlockLive();
+        inTracker = false;
+
+        for (const Leak& leak : leaks)
+        {
+            out << leak.size << " bytes (" << getTagName((Tag)leak.tag) << ")\n";
+            char** symbols = backtrace_symbols(leak.frames, leak.frameCount);
+            // Skip the tracker's own frames.
+            for (int i = 2; i < leak.frameCount; ++i)
+            {
+                out << "    " << (symbols ? symbols[i] : "?") << "\n";
+            }
+            free(symbols);
+        }
+        return (unsigned int)leaks.size();
+#else
+        (void)out;
+        (void)tag;
+        return 0;
+#endif
+    }
+}
+
+#ifdef ROCKET_MEMORY_TRACKING
+
+void* operator new(size_t size) { return rocket::trackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size) { return rocket::trackedNew(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment) { return rocket::trackedNew(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return rocket::trackedNew(size, (size_t)alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return rocket::trackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return rocket::trackedAllocate(size ? size : 1, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return rocket::trackedAllocate(size ? size : 1, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return rocket::trackedAllocate(size ? size : 1, (size_t)alignment); }
+
+void operator delete(void* ptr) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { rocket::trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { rocket::trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { rocket::trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { rocket::trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { rocket::trackedFree(ptr); }
+
+#endif
@@ -0,0 +1,152 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines the allocation statistics of one memory tag.
+     */
+    struct RMemoryStats
+    {
+        /**
+         * The number of bytes currently allocated.
+         */
+        uint64_t currentBytes;
+
+        /**
+         * The highest value of currentBytes sampled at a frame boundary (endFrame()),
+         * or now. Spikes that come and go within a frame are not seen; sampling keeps
+         * the allocation path free of shared counters.
+         */
+        uint64_t peakFrameBytes;
+
+        /**
+         * The number of live allocations.
+         */
+        uint64_t currentAllocations;
+
+        /**
+         * The number of allocations made since the program started.
+         */
+        uint64_t totalAllocations;
+
+        /**
+         * The number of allocations made during the last completed frame.
+         */
+        uint64_t frameAllocations;
+    };
+
+    /**
+     * Defines the tagged allocation tracker.
+     *
+     * When the library is built with ROCKET_MEMORY_TRACKING, the global operator
+     * new and delete are replaced so that every allocation is charged to the tag
+     * of the calling thread (see RMemoryScope). Counters are per thread and
+     * updated without locks, so tracking is cheap enough to leave on in release
+     * builds. Built with ROCKET_MEMORY_CALLSTACKS as well, every live allocation
+     * also records its callstack so leaks can be reported.
+     *
+     * Without ROCKET_MEMORY_TRACKING all statistics read as zero. The option
+     * is off by default, since replacing new and delete affects every program
+     * that links the library.
+     */
+    class API RMemoryTracker
+    {
+    public:
+        /**
+         * The subsystems allocations are charged to.
+         */
+        enum Tag
+        {
+            TAG_GENERAL,
+            TAG_APPLICATION,
+            TAG_MATH,
+            TAG_GRAPHICS,
+            TAG_MATERIALS,
+            TAG_AUDIO,
+            TAG_INPUT,
+            TAG_NETWORKING,
+            TAG_UI,
+            TAG_COUNT
+        };
+
+        /**
+         * Returns true if the library was built with allocation tracking.
+         */
+        static bool isEnabled();
+
+        /**
+         * Returns true if the library was built with callstack capture.
+         */
+        static bool isCallstackEnabled();
+
+        /**
+         * Returns the tag new allocations on the calling thread are charged to.
+         */
+        static Tag getTag();
+
+        /**
+         * Sets the tag new allocations on the calling thread are charged to.
+         *
+         * @return The previous tag.
+         */
+        static Tag setTag(Tag tag);
+
+        /**
+         * Returns the name of a tag.
+         */
+        static const char* getTagName(Tag tag);
+
+        /**
+         * Gets the statistics of a tag.
+         *
+         * @param tag The tag, or TAG_COUNT for the totals over all tags.
+         * @param dst The statistics to fill.
+         */
+        static void getStats(Tag tag, RMemoryStats* dst);
+
+        /**
+         * Ends the current frame: samples the peaks and the per-frame allocation counts.
+         *
+         * Called by REngine::present(). Should be called from one thread only.
+         */
+        static void endFrame();
+
+        /**
+         * Returns the number of allocations made during the last completed frame over all tags.
+         */
+        static uint64_t getFrameAllocations();
+
+        /**
+         * Writes a table of the statistics of every tag.
+         */
+        static void report(std::ostream& out);
+
+        /**
+         * Writes every live allocation with its callstack.
+         *
+         * Only available with ROCKET_MEMORY_CALLSTACKS; otherwise nothing is written.
+         *
+         * @param out The stream to write to.
+         * @param tag Only report allocations with this tag, or TAG_COUNT for all of them.
+         * @return The number of live allocations reported.
+         */
+        static unsigned int reportLeaks(std::ostream& out, Tag tag = TAG_COUNT);
+    };
+
+    /**
+     * Charges the allocations of the calling thread to a tag for the lifetime of the scope.
+     */
+    class RMemoryScope
+    {
+    public:
+        explicit RMemoryScope(RMemoryTracker::Tag tag) : _previous(RMemoryTracker::setTag(tag)) {}
+        ~RMemoryScope() { RMemoryTracker::setTag(_previous); }
+
+        RMemoryScope(const RMemoryScope&) = delete;
+        RMemoryScope& operator=(const RMemoryScope&) = delete;
+
+    private:
+        RMemoryTracker::Tag _previous;
+    };
+}
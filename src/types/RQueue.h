@@ -0,0 +1,202 @@
+#pragma once
+#include "../common.h"
+#include <atomic>
+
+namespace rocket
+{
+    /**
+     * Defines a bounded, lock-free queue for exactly one producer and one consumer thread.
+     *
+     * The queue is a ring buffer whose capacity is rounded up to a power of two.
+     * The producer and the consumer each own one index on its own cache line and
+     * keep a cached copy of the other's, so in the common case a push or pop
+     * touches no cache line the other thread is writing.
+     *
+     * Calling the push methods from more than one thread, or the pop methods from
+     * more than one thread, is undefined.
+     */
+    template <typename T>
+    class RSpscQueue
+    {
+    public:
+        /**
+         * Constructs a queue.
+         *
+         * @param capacity The minimum number of elements the queue can hold.
+         */
+        explicit RSpscQueue(size_t capacity);
+
+        /**
+         * Destroys the elements still in the queue.
+         */
+        ~RSpscQueue();
+
+        RSpscQueue(const RSpscQueue&) = delete;
+        RSpscQueue& operator=(const RSpscQueue&) = delete;
+
+        /**
+         * Adds an element to the back of the queue. Producer only.
+         *
+         * @return false if the queue is full.
+         */
+        bool tryPush(const T& value) { return tryEmplace(value); }
+        bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+        /**
+         * Constructs an element in place at the back of the queue. Producer only.
+         *
+         * @return false if the queue is full.
+         */
+        template <typename... Args>
+        bool tryEmplace(Args&&... args);
+
+        /**
+         * Removes the element at the front of the queue. Consumer only.
+         *
+         * @param value Receives the element.
+         * @return false if the queue is empty.
+         */
+        bool tryPop(T& value);
+
+        /**
+         * Adds as many of count elements as fit, publishing them all at once. Producer only.
+         *
+         * @return The number of elements added, from the start of values.
+         */
+        size_t tryPushBatch(const T* values, size_t count);
+
+        /**
+         * Removes up to maxCount elements. Consumer only.
+         *
+         * @return The number of elements written to values.
+         */
+        size_t tryPopBatch(T* values, size_t maxCount);
+
+        /**
+         * Returns the number of elements in the queue. Only exact when neither side is active.
+         */
+        size_t getSize() const;
+
+        /**
+         * Returns the number of elements the queue can hold.
+         */
+        size_t getCapacity() const { return _mask + 1; }
+
+    private:
+        struct Slot
+        {
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        T* element(size_t position) { return reinterpret_cast<T*>(_slots[position & _mask].storage); }
+
+        std::unique_ptr<Slot[]> _slots;
+        size_t _mask;
+
+        // Written by the producer.
+        alignas(64) std::atomic<size_t> _tail;
+        size_t _cachedHead;
+
+        // Written by the consumer.
+        alignas(64) std::atomic<size_t> _head;
+        size_t _cachedTail;
+    };
+
+    /**
+     * Defines a bounded, lock-free queue for any number of producer and consumer threads.
+     *
+     * This is Dmitry Vyukov's bounded MPMC queue: every cell carries a sequence
+     * number that tells a thread whether the cell is ready for its position, so
+     * a push or pop is one compare-and-swap on a shared index followed by work on
+     * the cell alone. The two indices live on separate cache lines.
+     *
+     * A thread preempted between claiming a cell and finishing with it holds up
+     * consumers (or producers) of that one cell, but never corrupts the queue.
+     */
+    template <typename T>
+    class RMpmcQueue
+    {
+    public:
+        /**
+         * Constructs a queue.
+         *
+         * @param capacity The minimum number of elements the queue can hold.
+         */
+        explicit RMpmcQueue(size_t capacity);
+
+        /**
+         * Destroys the elements still in the queue.
+         */
+        ~RMpmcQueue();
+
+        RMpmcQueue(const RMpmcQueue&) = delete;
+        RMpmcQueue& operator=(const RMpmcQueue&) = delete;
+
+        /**
+         * Adds an element to the back of the queue.
+         *
+         * @return false if the queue is full.
+         */
+        bool tryPush(const T& value) { return tryEmplace(value); }
+        bool tryPush(T&& value) { return tryEmplace(std::move(value)); }
+
+        /**
+         * Constructs an element in place at the back of the queue.
+         *
+         * @return false if the queue is full.
+         */
+        template <typename... Args>
+        bool tryEmplace(Args&&... args);
+
+        /**
+         * Removes the element at the front of the queue.
+         *
+         * @param value Receives the element.
+         * @return false if the queue is empty.
+         */
+        bool tryPop(T& value);
+
+        /**
+         * Adds as many of count elements as fit, claiming their cells with a single
+         * compare-and-swap. May wait briefly for consumers still reading those cells.
+         *
+         * @return The number of elements added, from the start of values.
+         */
+        size_t tryPushBatch(const T* values, size_t count);
+
+        /**
+         * Removes up to maxCount elements, claiming their cells with a single
+         * compare-and-swap. May wait briefly for producers still writing those cells.
+         *
+         * @return The number of elements written to values.
+         */
+        size_t tryPopBatch(T* values, size_t maxCount);
+
+        /**
+         * Returns the number of elements in the queue. Only exact when no thread is active.
+         */
+        size_t getSize() const;
+
+        /**
+         * Returns the number of elements the queue can hold.
+         */
+        size_t getCapacity() const { return _mask + 1; }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        T* element(Cell* cell) { return reinterpret_cast<T*>(cell->storage); }
+
+        std::unique_ptr<Cell[]> _cells;
+        size_t _mask;
+
+        alignas(64) std::atomic<size_t> _tail;
+        alignas(64) std::atomic<size_t> _head;
+    };
+}
+
+#include "RQueue.inl"
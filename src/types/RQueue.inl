@@ -0,0 +1,314 @@
+#include "RQueue.h"
+
+namespace rocket
+{
+    namespace detail
+    {
+        inline size_t queueCapacity(size_t capacity)
+        {
+            size_t result = 2;
+            while (result < capacity)
+            {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        inline void queueBackoff(unsigned int& spins)
+        {
+            if (++spins > 64)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    template <typename T>
+    RSpscQueue<T>::RSpscQueue(size_t capacity) :
+        _slots(new Slot[detail::queueCapacity(capacity)]),
+        _mask(detail::queueCapacity(capacity) - 1),
+        _tail(0),
+        _cachedHead(0),
+        _head(0),
+        _cachedTail(0)
+    {
+    }
+
+    template <typename T>
+    RSpscQueue<T>::~RSpscQueue()
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        for (size_t position = _head.load(std::memory_order_relaxed); position != tail; ++position)
+        {
+            element(position)->~T();
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool RSpscQueue<T>::tryEmplace(Args&&... args)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _cachedHead > _mask)
+        {
+            // Only look at the consumer's index when the cached one says the queue is full.
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead > _mask)
+            {
+                return false;
+            }
+        }
+        new (element(tail)) T(std::forward<Args>(args)...);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool RSpscQueue<T>::tryPop(T& value)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _cachedTail)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            if (head == _cachedTail)
+            {
+                return false;
+            }
+        }
+        T* source = element(head);
+        value = std::move(*source);
+        source->~T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    size_t RSpscQueue<T>::tryPushBatch(const T* values, size_t count)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t space = getCapacity() - (tail - _cachedHead);
+        if (space < count)
+        {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            space = getCapacity() - (tail - _cachedHead);
+        }
+        size_t pushed = std::min(space, count);
+        for (size_t i = 0; i < pushed; ++i)
+        {
+            new (element(tail + i)) T(values[i]);
+        }
+        if (pushed > 0)
+        {
+            _tail.store(tail + pushed, std::memory_order_release);
+        }
+        return pushed;
+    }
+
+    template <typename T>
+    size_t RSpscQueue<T>::tryPopBatch(T* values, size_t maxCount)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t available = _cachedTail - head;
+        if (available < maxCount)
+        {
+            _cachedTail = _tail.load(std::memory_order_acquire);
+            available = _cachedTail - head;
+        }
+        size_t popped = std::min(available, maxCount);
+        for (size_t i = 0; i < popped; ++i)
+        {
+            T* source = element(head + i);
+            values[i] = std::move(*source);
+            source->~T();
+        }
+        if (popped > 0)
+        {
+            _head.store(head + popped, std::memory_order_release);
+        }
+        return popped;
+    }
+
+    template <typename T>
+    size_t RSpscQueue<T>::getSize() const
+    {
+        size_t head = _head.load(std::memory_order_acquire);
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+    template <typename T>
+    RMpmcQueue<T>::RMpmcQueue(size_t capacity) :
+        _cells(new Cell[detail::queueCapacity(capacity)]),
+        _mask(detail::queueCapacity(capacity) - 1),
+        _tail(0),
+        _head(0)
+    {
+        // A cell is free for the push at position p when its sequence is p, and
+        // holds the element for the pop at position p when its sequence is p + 1.
+        for (size_t i = 0; i <= _mask; ++i)
+        {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T>
+    RMpmcQueue<T>::~RMpmcQueue()
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        for (size_t position = _head.load(std::memory_order_relaxed); position != tail; ++position)
+        {
+            element(&_cells[position & _mask])->~T();
+        }
+    }
+
+    template <typename T>
+    template <typename... Args>
+    bool RMpmcQueue<T>::tryEmplace(Args&&... args)
+    {
+        Cell* cell;
+        size_t position = _tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+            if (difference == 0)
+            {
+                if (_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The cell still holds the element from one lap ago.
+                return false;
+            }
+            else
+            {
+                position = _tail.load(std::memory_order_relaxed);
+            }
+        }
+        new (element(cell)) T(std::forward<Args>(args)...);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    bool RMpmcQueue<T>::tryPop(T& value)
+    {
+        Cell* cell;
+        size_t position = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            cell = &_cells[position & _mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+            if (difference == 0)
+            {
+                if (_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _head.load(std::memory_order_relaxed);
+            }
+        }
+        T* source = element(cell);
+        value = std::move(*source);
+        source->~T();
+        cell->sequence.store(position + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    size_t RMpmcQueue<T>::tryPushBatch(const T* values, size_t count)
+    {
+        size_t position = _tail.load(std::memory_order_relaxed);
+        size_t pushed;
+        for (;;)
+        {
+            // Positions below _head have been claimed by consumers, so their cells
+            // are at worst still being read and will be free in a moment.
+            size_t head = _head.load(std::memory_order_acquire);
+            intptr_t used = (intptr_t)(position - head);
+            if (used < 0)
+            {
+                position = _tail.load(std::memory_order_relaxed);
+                continue;
+            }
+            pushed = std::min(count, getCapacity() - (size_t)used);
+            if (pushed == 0)
+            {
+                return 0;
+            }
+            if (_tail.compare_exchange_weak(position, position + pushed, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < pushed; ++i)
+        {
+            Cell* cell = &_cells[(position + i) & _mask];
+            unsigned int spins = 0;
+            while (cell->sequence.load(std::memory_order_acquire) != position + i)
+            {
+                detail::queueBackoff(spins);
+            }
+            new (element(cell)) T(values[i]);
+            cell->sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return pushed;
+    }
+
+    template <typename T>
+    size_t RMpmcQueue<T>::tryPopBatch(T* values, size_t maxCount)
+    {
+        size_t position = _head.load(std::memory_order_relaxed);
+        size_t popped;
+        for (;;)
+        {
+            // Positions below _tail have been claimed by producers, so their cells
+            // are at worst still being written.
+            size_t tail = _tail.load(std::memory_order_acquire);
+            popped = std::min(maxCount, tail - position);
+            if (popped == 0)
+            {
+                return 0;
+            }
+            if (_head.compare_exchange_weak(position, position + popped, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < popped; ++i)
+        {
+            Cell* cell = &_cells[(position + i) & _mask];
+            unsigned int spins = 0;
+            while (cell->sequence.load(std::memory_order_acquire) != position + i + 1)
+            {
+                detail::queueBackoff(spins);
+            }
+            T* source = element(cell);
+            values[i] = std::move(*source);
+            source->~T();
+            cell->sequence.store(position + i + _mask + 1, std::memory_order_release);
+        }
+        return popped;
+    }
+
+    template <typename T>
+    size_t RMpmcQueue<T>::getSize() const
+    {
+        size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+}
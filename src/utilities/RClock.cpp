@@ -0,0 +1,29 @@
+#include "common.h"
+#include "RClock.h"
+
+namespace rocket
+{
+    // How early sleeping stops before the deadline; covers the usual wake-up
+    // latency of a desktop scheduler, with the remainder spent spinning.
+    static const int64_t SPIN_THRESHOLD = 2000000;
+
+    int64_t RClock::now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void RClock::sleepUntil(int64_t deadline)
+    {
+        int64_t remaining = deadline - now();
+        while (remaining > SPIN_THRESHOLD)
+        {
+            // Sleep in slices so that an oversleep is caught before it eats the spin window.
+            std::this_thread::sleep_for(std::chrono::nanoseconds((remaining - SPIN_THRESHOLD) / 2 + 1));
+            remaining = deadline - now();
+        }
+        while (now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
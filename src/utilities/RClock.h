@@ -0,0 +1,42 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines the engine's high-resolution monotonic clock.
+     *
+     * Times are in nanoseconds from an arbitrary fixed point and never go
+     * backwards, so they are only meaningful relative to each other.
+     */
+    class API RClock
+    {
+    public:
+        /**
+         * Returns the current time, in nanoseconds.
+         */
+        static int64_t now();
+
+        /**
+         * Converts a duration in nanoseconds to seconds.
+         */
+        static double toSeconds(int64_t nanoseconds) { return (double)nanoseconds * 1e-9; }
+
+        /**
+         * Converts a duration in seconds to nanoseconds.
+         */
+        static int64_t toNanoseconds(double seconds) { return (int64_t)(seconds * 1e9); }
+
+        /**
+         * Blocks the calling thread until the clock reaches deadline.
+         *
+         * The thread sleeps while the deadline is far enough away to absorb the
+         * scheduler's wake-up latency, then spins for the rest, so the wait ends
+         * within a few microseconds of the deadline without burning a core for
+         * the whole of it.
+         *
+         * @param deadline The time to wait for, in nanoseconds as returned by now().
+         */
+        static void sleepUntil(int64_t deadline);
+    };
+}
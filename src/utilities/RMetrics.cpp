@@ -0,0 +1,299 @@
+#include "common.h"
+#include "RMetrics.h"
+
+namespace rocket
+{
+    struct alignas(64) RMetrics::ThreadCounters
+    {
+        // Running totals, stored only by the owning thread.
+        std::atomic<int64_t> totals[MAX_METRICS];
+        // The totals already counted into a frame; touched only by endFrame().
+        int64_t reported[MAX_METRICS];
+        std::thread::id thread;
+        ThreadCounters* next;
+    };
+
+    namespace
+    {
+        std::atomic<uint64_t> nextSerial(1);
+
+        // The counters of the registry the calling thread used last.
+        struct ThreadCache
+        {
+            uint64_t serial;
+            void* counters;
+        };
+
+        thread_local ThreadCache threadCache = { 0, nullptr };
+
+        const char* const BUILTIN_NAMES[RMetrics::BUILTIN_COUNT] =
+        {
+            "draw_calls",
+            "triangles",
+            "culled_objects",
+            "allocations",
+            "job_queue_depth",
+            "audio_underruns"
+        };
+
+        const RMetrics::Kind BUILTIN_KINDS[RMetrics::BUILTIN_COUNT] =
+        {
+            RMetrics::COUNTER,
+            RMetrics::COUNTER,
+            RMetrics::COUNTER,
+            RMetrics::GAUGE,
+            RMetrics::GAUGE,
+            RMetrics::COUNTER
+        };
+
+        int64_t percentile(std::vector<int64_t>& values, double fraction)
+        {
+            size_t index = (size_t)(fraction * (double)(values.size() - 1) + 0.5);
+            std::nth_element(values.begin(), values.begin() + index, values.end());
+            return values[index];
+        }
+    }
+
+    RMetrics::RMetrics() :
+        _serial(nextSerial.fetch_add(1)),
+        _metrics(new Metric[MAX_METRICS]),
+        _metricCount(0),
+        _threads(nullptr),
+        _frameCount(0),
+        _dumpInterval(0)
+    {
+        for (Id id = 0; id < BUILTIN_COUNT; ++id)
+        {
+            registerMetric(BUILTIN_NAMES[id], BUILTIN_KINDS[id]);
+        }
+    }
+
+    RMetrics::~RMetrics()
+    {
+        ThreadCounters* counters = _threads.load();
+        while (counters)
+        {
+            ThreadCounters* next = counters->next;
+            delete counters;
+            counters = next;
+        }
+    }
+
+    RMetrics::Id RMetrics::registerMetric(const std::string& name, Kind kind)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        unsigned int count = _metricCount.load(std::memory_order_relaxed);
+        for (Id id = 0; id < count; ++id)
+        {
+            if (_metrics[id].name == name)
+            {
+                return id;
+            }
+        }
+        if (count == MAX_METRICS)
+        {
+            return INVALID;
+        }
+
+        Metric& metric = _metrics[count];
+        metric.name = name;
+        metric.kind = kind;
+        metric.gauge.store(0, std::memory_order_relaxed);
+        std::fill(metric.history, metric.history + HISTORY, 0);
+        _metricCount.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    RMetrics::Id RMetrics::find(const std::string& name) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        unsigned int count = _metricCount.load(std::memory_order_relaxed);
+        for (Id id = 0; id < count; ++id)
+        {
+            if (_metrics[id].name == name)
+            {
+                return id;
+            }
+        }
+        return INVALID;
+    }
+
+    // Not inlined, so that a job resumed on another thread after a fiber switch
+    // looks its counters up again rather than reusing the previous thread's.
+#ifdef _MSC_VER
+    __declspec(noinline)
+#else
+    __attribute__((noinline))
+#endif
+    RMetrics::ThreadCounters* RMetrics::getThreadCounters()
+    {
+        ThreadCache* cache = &threadCache;
+#ifndef _MSC_VER
+        asm volatile("" : "+r"(cache));
+#endif
+        if (cache->serial == _serial)
+        {
+            return (ThreadCounters*)cache->counters;
+        }
+        return registerThread();
+    }
+
+    RMetrics::ThreadCounters* RMetrics::registerThread()
+    {
+        std::thread::id thread = std::this_thread::get_id();
+        ThreadCounters* counters = _threads.load(std::memory_order_acquire);
+        while (counters && counters->thread != thread)
+        {
+            counters = counters->next;
+        }
+
+        if (!counters)
+        {
+            counters = new ThreadCounters();
+            for (unsigned int i = 0; i < MAX_METRICS; ++i)
+            {
+                counters->totals[i].store(0, std::memory_order_relaxed);
+                counters->reported[i] = 0;
+            }
+            counters->thread = thread;
+            counters->next = _threads.load(std::memory_order_relaxed);
+            while (!_threads.compare_exchange_weak(counters->next, counters, std::memory_order_release, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        threadCache.serial = _serial;
+        threadCache.counters = counters;
+        return counters;
+    }
+
+    void RMetrics::add(Id id, int64_t value)
+    {
+        if (id >= _metricCount.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        std::atomic<int64_t>& total = getThreadCounters()->totals[id];
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void RMetrics::set(Id id, int64_t value)
+    {
+        if (id >= _metricCount.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+        _metrics[id].gauge.store(value, std::memory_order_relaxed);
+    }
+
+    void RMetrics::endFrame()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            unsigned int count = _metricCount.load(std::memory_order_relaxed);
+            unsigned int slot = (unsigned int)(_frameCount % HISTORY);
+            for (Id id = 0; id < count; ++id)
+            {
+                int64_t value = _metrics[id].gauge.load(std::memory_order_relaxed);
+                if (_metrics[id].kind == COUNTER)
+                {
+                    value = 0;
+                    for (ThreadCounters* counters = _threads.load(std::memory_order_acquire); counters; counters = counters->next)
+                    {
+                        int64_t total = counters->totals[id].load(std::memory_order_relaxed);
+                        value += total - counters->reported[id];
+                        counters->reported[id] = total;
+                    }
+                }
+                _metrics[id].history[slot] = value;
+            }
+            ++_frameCount;
+        }
+
+        if (_dumpInterval > 0 && _frameCount % _dumpInterval == 0)
+        {
+            std::ofstream file(_dumpPath, std::ios::app);
+            write(file);
+        }
+    }
+
+    int64_t RMetrics::getValue(Id id) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _frameCount > 0 ? _metrics[id].history[(_frameCount - 1) % HISTORY] : 0;
+    }
+
+    RMetricSummary RMetrics::getSummary(Id id) const
+    {
+        RMetricSummary summary = {};
+        std::vector<int64_t> values;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            unsigned int frames = (unsigned int)std::min<uint64_t>(_frameCount, HISTORY);
+            if (frames == 0)
+            {
+                return summary;
+            }
+            values.assign(_metrics[id].history, _metrics[id].history + frames);
+            summary.value = _metrics[id].history[(_frameCount - 1) % HISTORY];
+            summary.frames = frames;
+        }
+
+        int64_t sum = 0;
+        summary.min = values[0];
+        summary.max = values[0];
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            sum += values[i];
+            summary.min = std::min(summary.min, values[i]);
+            summary.max = std::max(summary.max, values[i]);
+        }
+        summary.mean = (double)sum / (double)values.size();
+        summary.p50 = percentile(values, 0.50);
+        summary.p95 = percentile(values, 0.95);
+        summary.p99 = percentile(values, 0.99);
+        return summary;
+    }
+
+    unsigned int RMetrics::getMetricCount() const
+    {
+        return _metricCount.load(std::memory_order_acquire);
+    }
+
+    std::string RMetrics::getName(Id id) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _metrics[id].name;
+    }
+
+    uint64_t RMetrics::getFrameCount() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _frameCount;
+    }
+
+    void RMetrics::write(std::ostream& stream) const
+    {
+        stream << "{\"frame\":" << getFrameCount() << ",\"metrics\":{";
+        unsigned int count = getMetricCount();
+        for (Id id = 0; id < count; ++id)
+        {
+            RMetricSummary summary = getSummary(id);
+            stream << (id > 0 ? "," : "") << "\"" << getName(id) << "\":{"
+                   << "\"value\":" << summary.value
+                   << ",\"min\":" << summary.min
+                   << ",\"max\":" << summary.max
+                   << ",\"mean\":" << summary.mean
+                   << ",\"p50\":" << summary.p50
+                   << ",\"p95\":" << summary.p95
+                   << ",\"p99\":" << summary.p99 << "}";
+        }
+        stream << "}}\n";
+    }
+
+    void RMetrics::setDumpFile(const std::string& path, unsigned int interval)
+    {
+        _dumpPath = path;
+        _dumpInterval = interval;
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include "../common.h"
+#include <atomic>
+
+namespace rocket
+{
+    /**
+     * Defines a summary of one metric over the frames in its rolling window.
+     */
+    struct RMetricSummary
+    {
+        int64_t value;
+        int64_t min;
+        int64_t max;
+        double mean;
+        int64_t p50;
+        int64_t p95;
+        int64_t p99;
+        unsigned int frames;
+    };
+
+    /**
+     * Defines a registry of always-on engine metrics.
+     *
+     * A metric is either a counter, which threads add to during a frame and which
+     * reads as the frame's total, or a gauge, which holds the last value set.
+     * Adding to a counter writes only to a block owned by the calling thread, with
+     * no atomic read-modify-write, so it is cheap enough to leave in shipping
+     * builds. Once per frame, endFrame() turns the per-thread running totals into
+     * one value per metric and appends it to a rolling window from which the
+     * min, max, mean and p50/p95/p99 are computed on request.
+     *
+     * REngine owns one registry, ends its frame in present() and fills in the
+     * allocation and job queue metrics itself.
+     */
+    class API RMetrics
+    {
+    public:
+        typedef unsigned int Id;
+
+        /**
+         * The metrics every registry starts with.
+         */
+        enum Builtin : Id
+        {
+            // Counters added to by the render backend for every command buffer it executes.
+            DRAW_CALLS,
+            TRIANGLES,
+            // A counter for the application's visibility pass: the engine does not cull
+            // by itself, so this stays 0 unless the application adds to it.
+            CULLED_OBJECTS,
+            // A gauge set by REngine::present() to RMemoryTracker::getFrameAllocations(),
+            // which is always 0 unless the library is built with ROCKET_MEMORY_TRACKING.
+            ALLOCATIONS,
+            // A gauge set by REngine::present() to the job system's queued job count.
+            JOB_QUEUE_DEPTH,
+            // Reserved for the audio device, which does not stream yet; stays 0 until it does.
+            AUDIO_UNDERRUNS,
+            BUILTIN_COUNT
+        };
+
+        enum Kind
+        {
+            COUNTER,
+            GAUGE
+        };
+
+        /**
+         * The maximum number of metrics in a registry.
+         */
+        static const unsigned int MAX_METRICS = 64;
+
+        /**
+         * The number of frames in the rolling window.
+         */
+        static const unsigned int HISTORY = 600;
+
+        /**
+         * Returned by find() for unknown names.
+         */
+        static const Id INVALID = 0xFFFFFFFFu;
+
+        RMetrics();
+        ~RMetrics();
+
+        RMetrics(const RMetrics&) = delete;
+        RMetrics& operator=(const RMetrics&) = delete;
+
+        /**
+         * Registers a metric, or returns the existing one with the same name.
+         *
+         * @return The metric's id, or INVALID if the registry is full.
+         */
+        Id registerMetric(const std::string& name, Kind kind = COUNTER);
+
+        /**
+         * Returns the id of the metric with the specified name, or INVALID.
+         */
+        Id find(const std::string& name) const;
+
+        /**
+         * Adds to a counter for the current frame. Thread-safe and lock-free.
+         * Ids that are not registered, such as INVALID, are ignored.
+         */
+        void add(Id id, int64_t value = 1);
+
+        /**
+         * Sets a gauge. Thread-safe and lock-free. Ids that are not registered,
+         * such as INVALID, are ignored.
+         */
+        void set(Id id, int64_t value);
+
+        /**
+         * Closes the frame: totals the counters, samples the gauges, extends the
+         * rolling windows and writes the periodic dump if one is due.
+         * Called by REngine::present().
+         */
+        void endFrame();
+
+        /**
+         * Returns the value of a metric in the last closed frame.
+         */
+        int64_t getValue(Id id) const;
+
+        /**
+         * Returns a summary of a metric over the rolling window.
+         */
+        RMetricSummary getSummary(Id id) const;
+
+        /**
+         * Returns the number of registered metrics; ids run from 0 to this count.
+         */
+        unsigned int getMetricCount() const;
+
+        /**
+         * Returns the name of a metric.
+         */
+        std::string getName(Id id) const;
+
+        /**
+         * Returns the number of frames closed.
+         */
+        uint64_t getFrameCount() const;
+
+        /**
+         * Writes a summary of every metric as one line of JSON.
+         */
+        void write(std::ostream& stream) const;
+
+        /**
+         * Appends write() to a file every interval frames, or stops when the interval is 0.
+         * Each line is a complete JSON object, so soak tests can parse the file as it grows.
+         */
+        void setDumpFile(const std::string& path, unsigned int interval);
+
+    private:
+        struct ThreadCounters;
+
+        struct Metric
+        {
+            std::string name;
+            Kind kind;
+            std::atomic<int64_t> gauge;
+            int64_t history[HISTORY];
+        };
+
+        ThreadCounters* getThreadCounters();
+        ThreadCounters* registerThread();
+
+        uint64_t _serial;
+        std::unique_ptr<Metric[]> _metrics;
+        std::atomic<unsigned int> _metricCount;
+        std::atomic<ThreadCounters*> _threads;
+        uint64_t _frameCount;
+        std::string _dumpPath;
+        unsigned int _dumpInterval;
+        mutable std::mutex _mutex;
+    };
+}
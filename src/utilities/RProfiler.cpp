@@ -0,0 +1,265 @@
+#include "common.h"
+#include "RProfiler.h"
+
+namespace rocket
+{
+    std::atomic<bool> RProfiler::_enabled(false);
+
+    namespace
+    {
+        // Frame markers are stored as events with this name and the frame number as their end.
+        const char FRAME_NAME[] = "Frame";
+
+        struct Event
+        {
+            const char* name;
+            uint64_t start;
+            uint64_t end;
+        };
+
+        // A ring slot. An export may copy a slot while its thread overwrites it, so the
+        // fields are atomics: stored with release and loaded with acquire, which costs
+        // nothing over plain moves on x86 and lets the export detect a torn copy.
+        struct Slot
+        {
+            std::atomic<const char*> name;
+            std::atomic<uint64_t> start;
+            std::atomic<uint64_t> end;
+        };
+
+        struct ThreadBuffer
+        {
+            std::unique_ptr<Slot[]> events;
+            // The number of events whose write has begun and the number ever written;
+            // only the owning thread stores to them.
+            std::atomic<size_t> started;
+            std::atomic<size_t> written;
+            unsigned int id;
+            std::string name;
+            // Set under the registry lock once the owning thread has exited, and once
+            // an export has taken its events since; the buffer is then free to reuse.
+            bool exited;
+            bool exported;
+        };
+
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            unsigned int nextId;
+            std::atomic<uint64_t> frame;
+            uint64_t startTicks;
+            int64_t startTime;
+
+            Registry() : nextId(1), frame(0), startTicks(RProfiler::now()), startTime(RClock::now()) {}
+        };
+
+        Registry& getRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        thread_local ThreadBuffer* currentBuffer = nullptr;
+        thread_local std::string currentName;
+
+        // Hands the calling thread's buffer back to the registry when the thread exits.
+        struct ThreadExit
+        {
+            ThreadBuffer* buffer = nullptr;
+
+            ~ThreadExit()
+            {
+                if (buffer)
+                {
+                    std::lock_guard<std::mutex> lock(getRegistry().mutex);
+                    buffer->exited = true;
+                }
+            }
+        };
+
+        thread_local ThreadExit threadExit;
+
+        // Only threads that record get a buffer, so naming a thread or running one
+        // with the profiler off costs no memory. A thread takes over the ring of an
+        // exited thread whose events have been exported before allocating a new one.
+        ThreadBuffer* createThreadBuffer()
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            ThreadBuffer* buffer = nullptr;
+            for (size_t i = 0; i < registry.buffers.size() && !buffer; ++i)
+            {
+                if (registry.buffers[i]->exited && registry.buffers[i]->exported)
+                {
+                    buffer = registry.buffers[i].get();
+                }
+            }
+            if (!buffer)
+            {
+                registry.buffers.emplace_back(new ThreadBuffer());
+                buffer = registry.buffers.back().get();
+                buffer->events.reset(new Slot[RProfiler::EVENTS_PER_THREAD]);
+            }
+            buffer->started.store(0, std::memory_order_relaxed);
+            buffer->written.store(0, std::memory_order_relaxed);
+            buffer->id = registry.nextId++;
+            buffer->name = currentName.empty() ? "Thread " + std::to_string(buffer->id) : currentName;
+            buffer->exited = false;
+            buffer->exported = false;
+
+            threadExit.buffer = buffer;
+            currentBuffer = buffer;
+            return buffer;
+        }
+
+        void push(const char* name, uint64_t start, uint64_t end)
+        {
+            ThreadBuffer* buffer = currentBuffer ? currentBuffer : createThreadBuffer();
+            size_t index = buffer->written.load(std::memory_order_relaxed);
+            Slot& slot = buffer->events[index & (RProfiler::EVENTS_PER_THREAD - 1)];
+            buffer->started.store(index + 1, std::memory_order_relaxed);
+            slot.name.store(name, std::memory_order_release);
+            slot.start.store(start, std::memory_order_release);
+            slot.end.store(end, std::memory_order_release);
+            buffer->written.store(index + 1, std::memory_order_release);
+        }
+
+        void writeEscaped(std::ostream& stream, const char* text)
+        {
+            for (; *text; ++text)
+            {
+                char c = *text;
+                if (c == '"' || c == '\\')
+                {
+                    stream << '\\' << c;
+                }
+                else if ((unsigned char)c < 0x20)
+                {
+                    stream << ' ';
+                }
+                else
+                {
+                    stream << c;
+                }
+            }
+        }
+    }
+
+    void RProfiler::setEnabled(bool enabled)
+    {
+        // Construct the registry now so its start time precedes every recorded zone.
+        getRegistry();
+        _enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void RProfiler::record(const char* name, uint64_t start, uint64_t end)
+    {
+        push(name, start, end);
+    }
+
+    void RProfiler::markFrame()
+    {
+        if (isEnabled())
+        {
+            push(FRAME_NAME, now(), getRegistry().frame.fetch_add(1, std::memory_order_relaxed));
+        }
+    }
+
+    void RProfiler::setThreadName(const std::string& name)
+    {
+        currentName = name;
+        if (currentBuffer)
+        {
+            std::lock_guard<std::mutex> lock(getRegistry().mutex);
+            currentBuffer->name = name;
+        }
+    }
+
+    void RProfiler::clear()
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        // The buffers of exited threads hold nothing once cleared, so they are freed.
+        registry.buffers.erase(std::remove_if(registry.buffers.begin(), registry.buffers.end(),
+                                              [](const std::unique_ptr<ThreadBuffer>& buffer) { return buffer->exited; }),
+                               registry.buffers.end());
+        for (size_t i = 0; i < registry.buffers.size(); ++i)
+        {
+            registry.buffers[i]->started.store(0, std::memory_order_relaxed);
+            registry.buffers[i]->written.store(0, std::memory_order_relaxed);
+        }
+        registry.frame.store(0, std::memory_order_relaxed);
+    }
+
+    void RProfiler::writeChromeTrace(std::ostream& stream)
+    {
+        Registry& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        // Calibrate the tick rate against the monotonic clock over the whole capture.
+        uint64_t ticks = now() - registry.startTicks;
+        int64_t elapsed = RClock::now() - registry.startTime;
+        double microsecondsPerTick = ticks > 0 && elapsed > 0 ? (double)elapsed / (double)ticks / 1000.0 : 0.001;
+
+        stream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        std::vector<Event> events;
+        for (size_t i = 0; i < registry.buffers.size(); ++i)
+        {
+            ThreadBuffer& buffer = *registry.buffers[i];
+            buffer.exported = buffer.exited;
+            stream << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.id << ",\"args\":{\"name\":\"";
+            writeEscaped(stream, buffer.name.c_str());
+            stream << "\"}}";
+            first = false;
+
+            // Copy what the ring holds, then drop whatever the thread began to overwrite
+            // meanwhile. A copied field from a newer write synchronizes with that write,
+            // so the load of started below is guaranteed to see it begin.
+            size_t end = buffer.written.load(std::memory_order_acquire);
+            size_t begin = end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+            events.clear();
+            for (size_t index = begin; index < end; ++index)
+            {
+                const Slot& slot = buffer.events[index & (EVENTS_PER_THREAD - 1)];
+                events.push_back({ slot.name.load(std::memory_order_acquire), slot.start.load(std::memory_order_acquire),
+                                   slot.end.load(std::memory_order_acquire) });
+            }
+            size_t started = buffer.started.load(std::memory_order_acquire);
+            size_t overwritten = started > EVENTS_PER_THREAD ? started - EVENTS_PER_THREAD : 0;
+            size_t skip = overwritten > begin ? std::min(overwritten - begin, events.size()) : 0;
+
+            for (size_t e = skip; e < events.size(); ++e)
+            {
+                const Event& event = events[e];
+                double start = (double)(int64_t)(event.start - registry.startTicks) * microsecondsPerTick;
+                if (event.name == FRAME_NAME)
+                {
+                    stream << ",\n{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":" << buffer.id
+                           << ",\"ts\":" << start << ",\"args\":{\"frame\":" << event.end << "}}";
+                }
+                else
+                {
+                    stream << ",\n{\"name\":\"";
+                    writeEscaped(stream, event.name);
+                    stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.id << ",\"ts\":" << start
+                           << ",\"dur\":" << (double)(event.end - event.start) * microsecondsPerTick << "}";
+                }
+            }
+        }
+        stream << "\n]}\n";
+    }
+
+    bool RProfiler::exportChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path);
+        if (!file)
+        {
+            return false;
+        }
+        file.precision(15);
+        writeChromeTrace(file);
+        return (bool)file;
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "../common.h"
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#endif
+
+#ifdef ROCKET_PROFILING
+#define ROCKET_PROFILE_CONCAT_(a, b) a##b
+#define ROCKET_PROFILE_CONCAT(a, b) ROCKET_PROFILE_CONCAT_(a, b)
+/**
+ * Times the rest of the enclosing scope as a zone. The name must be a string literal.
+ */
+#define ROCKET_PROFILE_ZONE(name) ::rocket::RProfileZone ROCKET_PROFILE_CONCAT(_rocketProfileZone, __LINE__)(name)
+/**
+ * Times the rest of the enclosing function as a zone named after it.
+ */
+#define ROCKET_PROFILE_FUNCTION() ROCKET_PROFILE_ZONE(__func__)
+/**
+ * Marks the start of a frame.
+ */
+#define ROCKET_PROFILE_FRAME() ::rocket::RProfiler::markFrame()
+#else
+#define ROCKET_PROFILE_ZONE(name) ((void)0)
+#define ROCKET_PROFILE_FUNCTION() ((void)0)
+#define ROCKET_PROFILE_FRAME() ((void)0)
+#endif
+
+namespace rocket
+{
+    /**
+     * Defines the engine's CPU profiler.
+     *
+     * Zones are recorded with ROCKET_PROFILE_ZONE into a ring buffer owned by the
+     * recording thread, so recording takes no lock and shares no cache line with
+     * other threads. Timestamps are raw CPU time stamp counter reads where one is
+     * available, converted to time only when a capture is exported. Once a
+     * thread's buffer is full its oldest zones are overwritten. When a thread
+     * exits its buffer stays for the next export, after which a new thread takes
+     * it over.
+     *
+     * Recording is off until setEnabled(true); while off a zone costs one relaxed
+     * load. Building without ROCKET_PROFILING removes the macros altogether.
+     */
+    class API RProfiler
+    {
+    public:
+        /**
+         * The number of zones each thread keeps.
+         */
+        static const size_t EVENTS_PER_THREAD = 64 * 1024;
+
+        /**
+         * Starts or stops recording.
+         */
+        static void setEnabled(bool enabled);
+
+        /**
+         * Returns true while recording.
+         */
+        static bool isEnabled() { return _enabled.load(std::memory_order_relaxed); }
+
+        /**
+         * Returns the current timestamp, in ticks.
+         */
+        static uint64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+            return __rdtsc();
+#else
+            return (uint64_t)RClock::now();
+#endif
+        }
+
+        /**
+         * Records a zone on the calling thread.
+         *
+         * @param name The name of the zone; must outlive the profiler, e.g. a string literal.
+         * @param start The timestamp the zone started at.
+         * @param end The timestamp the zone ended at.
+         */
+        static void record(const char* name, uint64_t start, uint64_t end);
+
+        /**
+         * Records the start of a frame. Called by REngine::run() every frame.
+         */
+        static void markFrame();
+
+        /**
+         * Names the calling thread in exported captures.
+         *
+         * Only stores the name: a thread's ring of EVENTS_PER_THREAD zones is
+         * allocated when it first records, so naming threads costs no memory while
+         * the profiler is off.
+         */
+        static void setThreadName(const std::string& name);
+
+        /**
+         * Discards every recorded zone, and frees the rings of threads that have
+         * exited. Must not be called while recording.
+         */
+        static void clear();
+
+        /**
+         * Writes the recorded zones in the Chrome trace event format, which
+         * chrome://tracing and Perfetto open directly.
+         *
+         * May be called while other threads record; zones they record or
+         * overwrite while the capture is written may be left out.
+         */
+        static void writeChromeTrace(std::ostream& stream);
+
+        /**
+         * Writes the recorded zones to a Chrome trace file.
+         *
+         * @return false if the file could not be written.
+         */
+        static bool exportChromeTrace(const std::string& path);
+
+    private:
+        static std::atomic<bool> _enabled;
+    };
+
+    /**
+     * Defines a zone timed from construction to destruction; see ROCKET_PROFILE_ZONE.
+     */
+    class RProfileZone
+    {
+    public:
+        explicit RProfileZone(const char* name) : _name(name), _start(RProfiler::isEnabled() ? RProfiler::now() : 0) {}
+
+        ~RProfileZone()
+        {
+            if (_start != 0)
+            {
+                RProfiler::record(_name, _start, RProfiler::now());
+            }
+        }
+
+        RProfileZone(const RProfileZone&) = delete;
+        RProfileZone& operator=(const RProfileZone&) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _start;
+    };
+}
@@ -0,0 +1,187 @@
+#include "common.h"
+#include "RRadixSort.h"
+
+namespace rocket
+{
+    namespace
+    {
+        const unsigned int RADIX = 256;
+        const unsigned int PASSES = 8;
+
+        inline unsigned int getDigit(uint64_t key, unsigned int pass)
+        {
+            return (unsigned int)(key >> (pass * 8)) & (RADIX - 1);
+        }
+
+        void insertionSort(RSortItem* items, size_t count)
+        {
+            for (size_t i = 1; i < count; ++i)
+            {
+                RSortItem item = items[i];
+                size_t j = i;
+                while (j > 0 && items[j - 1].key > item.key)
+                {
+                    items[j] = items[j - 1];
+                    --j;
+                }
+                items[j] = item;
+            }
+        }
+
+        // Counts every byte of every key in one read of the items.
+        void countDigits(const RSortItem* items, size_t begin, size_t end, uint32_t* counts)
+        {
+            std::fill(counts, counts + PASSES * RADIX, 0);
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint64_t key = items[i].key;
+                for (unsigned int pass = 0; pass < PASSES; ++pass)
+                {
+                    ++counts[pass * RADIX + getDigit(key, pass)];
+                }
+            }
+        }
+
+        void countPass(const RSortItem* items, size_t begin, size_t end, unsigned int pass, uint32_t* counts)
+        {
+            std::fill(counts, counts + RADIX, 0);
+            for (size_t i = begin; i < end; ++i)
+            {
+                ++counts[getDigit(items[i].key, pass)];
+            }
+        }
+
+        void scatter(const RSortItem* source, RSortItem* destination, size_t begin, size_t end, unsigned int pass, const uint32_t* offsets)
+        {
+            uint32_t next[RADIX];
+            std::copy(offsets, offsets + RADIX, next);
+            for (size_t i = begin; i < end; ++i)
+            {
+                destination[next[getDigit(source[i].key, pass)]++] = source[i];
+            }
+        }
+
+        void sortSerial(RSortItem* items, RSortItem* scratch, size_t count)
+        {
+            uint32_t counts[PASSES * RADIX];
+            countDigits(items, 0, count, counts);
+
+            RSortItem* source = items;
+            RSortItem* destination = scratch;
+            for (unsigned int pass = 0; pass < PASSES; ++pass)
+            {
+                const uint32_t* passCounts = counts + pass * RADIX;
+                if (passCounts[getDigit(source[0].key, pass)] == count)
+                {
+                    continue;
+                }
+
+                uint32_t offsets[RADIX];
+                uint32_t offset = 0;
+                for (unsigned int digit = 0; digit < RADIX; ++digit)
+                {
+                    offsets[digit] = offset;
+                    offset += passCounts[digit];
+                }
+                scatter(source, destination, 0, count, pass, offsets);
+                std::swap(source, destination);
+            }
+
+            if (source != items)
+            {
+                std::copy(source, source + count, items);
+            }
+        }
+
+        void sortParallel(RSortItem* items, RSortItem* scratch, size_t count, RJobSystem* jobs)
+        {
+            const unsigned int blocks = jobs->getThreadCount();
+            const size_t blockSize = (count + blocks - 1) / blocks;
+            auto blockBegin = [&](unsigned int block) { return std::min(count, block * blockSize); };
+
+            // counts[block][pass][digit]. Only the first pass sorted may use the
+            // per-block counts as they are; later passes recount their byte because
+            // the earlier scatters moved items between blocks. The totals over all
+            // blocks do not change, so they decide up front which passes to skip.
+            std::vector<uint32_t> counts((size_t)blocks * PASSES * RADIX);
+            std::vector<uint32_t> offsets((size_t)blocks * RADIX);
+            jobs->parallelFor(blocks, [&](unsigned int begin, unsigned int end)
+            {
+                for (unsigned int block = begin; block < end; ++block)
+                {
+                    countDigits(items, blockBegin(block), blockBegin(block + 1), &counts[(size_t)block * PASSES * RADIX]);
+                }
+            }, 1);
+
+            RSortItem* source = items;
+            RSortItem* destination = scratch;
+            bool recount = false;
+            for (unsigned int pass = 0; pass < PASSES; ++pass)
+            {
+                unsigned int first = getDigit(source[0].key, pass);
+                size_t total = 0;
+                for (unsigned int block = 0; block < blocks; ++block)
+                {
+                    total += counts[((size_t)block * PASSES + pass) * RADIX + first];
+                }
+                if (total == count)
+                {
+                    continue;
+                }
+
+                if (recount)
+                {
+                    jobs->parallelFor(blocks, [&](unsigned int begin, unsigned int end)
+                    {
+                        for (unsigned int block = begin; block < end; ++block)
+                        {
+                            countPass(source, blockBegin(block), blockBegin(block + 1), pass, &counts[((size_t)block * PASSES + pass) * RADIX]);
+                        }
+                    }, 1);
+                }
+                recount = true;
+
+                // Bucket by bucket, each block gets the range after the blocks before it.
+                uint32_t offset = 0;
+                for (unsigned int digit = 0; digit < RADIX; ++digit)
+                {
+                    for (unsigned int block = 0; block < blocks; ++block)
+                    {
+                        offsets[(size_t)block * RADIX + digit] = offset;
+                        offset += counts[((size_t)block * PASSES + pass) * RADIX + digit];
+                    }
+                }
+
+                jobs->parallelFor(blocks, [&](unsigned int begin, unsigned int end)
+                {
+                    for (unsigned int block = begin; block < end; ++block)
+                    {
+                        scatter(source, destination, blockBegin(block), blockBegin(block + 1), pass, &offsets[(size_t)block * RADIX]);
+                    }
+                }, 1);
+                std::swap(source, destination);
+            }
+
+            if (source != items)
+            {
+                std::copy(source, source + count, items);
+            }
+        }
+    }
+
+    void RRadixSort::sort(RSortItem* items, RSortItem* scratch, size_t count, RJobSystem* jobs)
+    {
+        if (count < SMALL_THRESHOLD)
+        {
+            insertionSort(items, count);
+        }
+        else if (jobs && count >= PARALLEL_THRESHOLD && jobs->getThreadCount() > 1)
+        {
+            sortParallel(items, scratch, count, jobs);
+        }
+        else
+        {
+            sortSerial(items, scratch, count);
+        }
+    }
+}
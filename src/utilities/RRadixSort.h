@@ -0,0 +1,51 @@
+#pragma once
+#include "../common.h"
+
+namespace rocket
+{
+    /**
+     * Defines a 64-bit sort key and the index of the item it belongs to.
+     */
+    struct RSortItem
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    /**
+     * Defines a least-significant-digit radix sort over 64-bit keys.
+     *
+     * Keys are sorted a byte at a time in eight stable counting passes, so the
+     * cost is linear in the number of items and, unlike a comparison sort,
+     * independent of how the keys are distributed. A pass is skipped when every
+     * key has the same byte in it, which is common for sort keys whose high
+     * fields (layer, translucency) take few values.
+     *
+     * Large lists are split into blocks that count and scatter in parallel on
+     * the job system; the scatter stays stable because each block writes to its
+     * own range of every bucket, in block order.
+     */
+    class API RRadixSort
+    {
+    public:
+        /**
+         * The number of items from which sort() uses the job system.
+         */
+        static const size_t PARALLEL_THRESHOLD = 32 * 1024;
+
+        /**
+         * The number of items below which sort() falls back to an insertion sort.
+         */
+        static const size_t SMALL_THRESHOLD = 64;
+
+        /**
+         * Sorts items by key, keeping items with equal keys in their original order.
+         *
+         * @param items The items to sort; holds the result.
+         * @param scratch Memory for count items, used between passes.
+         * @param count The number of items.
+         * @param jobs The job system to sort large lists on, or null to sort on the calling thread.
+         */
+        static void sort(RSortItem* items, RSortItem* scratch, size_t count, RJobSystem* jobs = nullptr);
+    };
+}